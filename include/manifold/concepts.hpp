@@ -29,6 +29,7 @@
 #include "_defines.hpp"
 #include <concepts>
 #include <ostream>
+#include <string_view>
 
 namespace manifold::concepts {
 
@@ -69,6 +70,11 @@ concept Printable = requires(S &os, T t) {
   { os << t };
 };
 
+/// T can be viewed as a `std::string_view` (e.g. strings, literals, views)
+template <typename T>
+concept StringViewConvertible =
+    std::convertible_to<const T &, std::string_view>;
+
 /// T must be comparable with `==`, `!=`
 template <typename T>
 concept EqualityComparable = std::equality_comparable<T>;
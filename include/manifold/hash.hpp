@@ -0,0 +1,134 @@
+/**
+ *  MIT License
+ *
+ * Copyright (c) 2025 Jules Nieves
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ *all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **/
+
+
+#ifndef Manifold_Hash_hpp
+#define Manifold_Hash_hpp
+
+#include "_defines.hpp"
+#include <array>
+#include <span>
+#include <string_view>
+
+namespace manifold::hash {
+
+/// Hash/checksum algorithms
+enum class Algorithm { Crc32c, XXH64, XXH3 };
+
+/// CRC-32C (Castagnoli), `crc` continues a previous checksum
+auto crc32c(std::span<const u8> data, u32 crc = 0) -> u32;
+
+/// CRC-32C (Castagnoli) of a string
+auto crc32c(std::string_view data, u32 crc = 0) -> u32;
+
+/// Checksum of `A + B` from the checksums of `A` and `B` (and B's length)
+auto crc32c_combine(u32 crc_a, u32 crc_b, usize length_b) -> u32;
+
+/// XXH64 of a byte span
+auto xxh64(std::span<const u8> data, u64 seed = 0) -> u64;
+
+/// XXH64 of a string
+auto xxh64(std::string_view data, u64 seed = 0) -> u64;
+
+/// XXH3 (64-bit) of a byte span
+auto xxh3(std::span<const u8> data, u64 seed = 0) -> u64;
+
+/// XXH3 (64-bit) of a string
+auto xxh3(std::string_view data, u64 seed = 0) -> u64;
+
+/// Fast (wyhash-style) 64-bit hash, meant for short keys and hash tables
+auto wyhash(std::span<const u8> data, u64 seed = 0) -> u64;
+
+/// Fast (wyhash-style) 64-bit hash of a string
+auto wyhash(std::string_view data, u64 seed = 0) -> u64;
+
+/// SipHash-1-3 with a 128-bit key, for hash tables fed untrusted keys:
+/// without the key, inputs that collide cannot be found
+auto siphash13(std::span<const u8> data, u64 key0, u64 key1) -> u64;
+
+/// SipHash-1-3 of a string
+auto siphash13(std::string_view data, u64 key0, u64 key1) -> u64;
+
+/// Hashes a byte span with any algorithm (CRC-32C is zero-extended)
+auto hash(Algorithm algo, std::span<const u8> data, u64 seed = 0) -> u64;
+
+/// Streaming CRC-32C
+class Crc32c {
+public:
+  auto update(std::span<const u8> data) -> void { crc = crc32c(data, crc); }
+  auto update(std::string_view data) -> void { crc = crc32c(data, crc); }
+  auto digest() const -> u32 { return crc; }
+  auto reset() -> void { crc = 0; }
+
+private:
+  u32 crc = 0;
+};
+
+/// Streaming XXH64
+class Xxh64 {
+public:
+  explicit Xxh64(u64 seed = 0) { reset(seed); }
+
+  auto update(std::span<const u8> data) -> void;
+  auto update(std::string_view data) -> void;
+  auto digest() const -> u64;
+  auto reset(u64 seed = 0) -> void;
+
+private:
+  std::array<u64, 4> lanes;
+  std::array<u8, 32> buffer;
+  usize buffered;
+  u64 total;
+  u64 seed_value;
+};
+
+/// Streaming XXH3 (64-bit)
+class Xxh3 {
+public:
+  explicit Xxh3(u64 seed = 0) { reset(seed); }
+
+  auto update(std::span<const u8> data) -> void;
+  auto update(std::string_view data) -> void;
+  auto digest() const -> u64;
+  auto reset(u64 seed = 0) -> void;
+
+  static constexpr usize kSecretSize = 192;
+  static constexpr usize kBufferSize = 256;
+
+private:
+  auto consume(const u8 *input, usize count) -> void;
+
+  alignas(64) std::array<u64, 8> acc;
+  alignas(64) std::array<u8, kSecretSize> secret;
+  alignas(64) std::array<u8, kBufferSize> buffer;
+  usize buffered;
+  usize stripes;
+  u64 total;
+  u64 seed_value;
+};
+
+} // namespace manifold::hash
+
+#endif
@@ -30,10 +30,16 @@
 #include <manifold/_defines.hpp>
 #include <manifold/dbg.hpp>
 #include <manifold/concepts.hpp>
+#include <manifold/hash.hpp>
 
 /// OS
+#include <manifold/os/csv.hpp>
+#include <manifold/os/encoding.hpp>
 #include <manifold/os/env.hpp>
+#include <manifold/os/format.hpp>
 #include <manifold/os/fs.hpp>
+#include <manifold/os/parallel_text.hpp>
+#include <manifold/os/pattern.hpp>
 #include <manifold/os/str.hpp>
 
 /// ADT
@@ -0,0 +1,133 @@
+/**
+ *  MIT License
+ *
+ * Copyright (c) 2025 Jules Nieves
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ *all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **/
+
+#ifndef Manifold_Csv_hpp
+#define Manifold_Csv_hpp
+
+#include "../_defines.hpp"
+#include "fs.hpp"
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace manifold::str::csv {
+
+/// Dialect of a `Reader`
+struct Options {
+  char delimiter = ',';
+
+  /// Quote character, '\0' to read every byte literally (plain TSV)
+  char quote = '"';
+
+  /// Bytes read per call of a chunk reader (the buffer grows past it only
+  /// for records that do not fit)
+  usize chunk_size = 1UL << 20;
+};
+
+/// Tab-separated values without quoting
+inline constexpr Options tsv = {.delimiter = '\t', .quote = '\0'};
+
+/// Streaming RFC 4180 reader, one record at a time
+///
+/// Delimiters, newlines and quotes are found 64 bytes at a time as SIMD
+/// bitmasks; quoted regions come from a prefix XOR of the quote mask, so a
+/// field boundary costs one bit scan instead of a branch per byte. Fields are
+/// views into the input, quotes are stripped, and only fields with doubled
+/// quotes are unescaped into a scratch buffer. Records end at "\n" or
+/// "\r\n". Malformed quoting is read leniently rather than reported.
+///
+/// ```
+/// csv::Reader reader(file.view());
+/// while (reader.next())
+///   total += str::parse<long>(reader[2]).value();
+/// ```
+class Reader {
+public:
+  /// Fills the buffer it is given, returning the number of bytes written (0
+  /// at the end of the input)
+  using chunk_reader = std::function<usize(std::span<char>)>;
+
+  /// Reads records from a buffer, which has to outlive the reader
+  explicit Reader(std::string_view data, const Options &options = {});
+
+  /// Reads records from a mapped file, which has to outlive the reader
+  explicit Reader(const fs::MappedFile &file, const Options &options = {});
+
+  /// Reads records from chunks pulled out of `source` on demand
+  explicit Reader(chunk_reader source, const Options &options = {});
+
+  /// Moves to the next record, returns false at the end of the input
+  auto next() -> bool;
+
+  /// Fields of the current record (valid until the next call to `next()`)
+  auto fields() const -> std::span<const std::string_view> { return views; }
+
+  auto operator[](usize index) const -> std::string_view {
+    return views[index];
+  }
+
+  /// Number of fields in the current record
+  auto size() const -> usize { return views.size(); }
+
+  /// Number of records read so far
+  auto records() const -> usize { return count; }
+
+private:
+  struct Field {
+    usize offset;
+    usize size;
+    bool unescaped;
+  };
+
+  auto next_separator() -> usize;
+  auto add_field(usize begin, usize end, bool last) -> void;
+  auto refill(usize keep) -> void;
+
+  Options options;
+  chunk_reader source;
+  std::string buffer;
+  std::string_view text;
+  bool exhausted;
+  usize pos = 0;
+
+  /// Separators (unquoted delimiters and newlines) of the 64-byte block at
+  /// `block` that were not consumed yet, and whether the block after it
+  /// starts inside quotes
+  usize block = 0;
+  usize next_block = 0;
+  u64 separators = 0;
+  bool quoted = false;
+
+  std::vector<Field> spans;
+  std::vector<std::string_view> views;
+  std::string scratch;
+  usize count = 0;
+};
+
+} // namespace manifold::str::csv
+
+#endif
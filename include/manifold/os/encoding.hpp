@@ -0,0 +1,114 @@
+/**
+ *  MIT License
+ *
+ * Copyright (c) 2025 Jules Nieves
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ *all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **/
+
+#ifndef Manifold_Encoding_hpp
+#define Manifold_Encoding_hpp
+
+#include "../_defines.hpp"
+#include "../adt/result.hpp"
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace manifold::str {
+
+/// Why a `base64` or `hex` decode failed, and at which byte of the text
+/// (0 for a buffer that is too small)
+struct DecodeError {
+  enum class Kind { InvalidChar, BadLength, BufferTooSmall };
+
+  Kind kind;
+  usize offset;
+};
+
+/// Base64 (RFC 4648), vectorized with SSSE3 or AVX2 where available
+namespace base64 {
+
+/// `Standard` uses '+' and '/' and pads to a multiple of four characters
+/// with '=', `Url` uses '-' and '_' and does not pad
+enum class Alphabet { Standard, Url };
+
+/// Number of characters `encode` writes for `size` bytes
+constexpr auto encoded_size(usize size, Alphabet alphabet = Alphabet::Standard)
+    -> usize {
+  if (alphabet == Alphabet::Standard)
+    return (size + 2) / 3 * 4;
+
+  return size / 3 * 4 + (size % 3 == 0 ? 0 : size % 3 + 1);
+}
+
+/// Number of bytes `text` decodes to, if it is valid
+auto decoded_size(std::string_view text) -> usize;
+
+/// Writes `data` encoded into `out`, returning the number of characters
+/// written, or 0 (leaving `out` untouched) if they do not fit
+auto encode(std::span<const u8> data, std::span<char> out,
+            Alphabet alphabet = Alphabet::Standard) -> usize;
+
+auto encode(std::span<const u8> data, Alphabet alphabet = Alphabet::Standard)
+    -> std::string;
+
+auto encode(std::string_view data, Alphabet alphabet = Alphabet::Standard)
+    -> std::string;
+
+/// Decodes `text` into `out`, returning the number of bytes written
+///
+/// Padding is optional in either alphabet; whitespace and characters of the
+/// other alphabet are invalid.
+auto decode(std::string_view text, std::span<u8> out,
+            Alphabet alphabet = Alphabet::Standard)
+    -> manifold::result<usize, DecodeError>;
+
+auto decode(std::string_view text, Alphabet alphabet = Alphabet::Standard)
+    -> manifold::result<std::vector<u8>, DecodeError>;
+
+} // namespace base64
+
+/// Hexadecimal, two characters per byte, vectorized like `base64`
+namespace hex {
+
+/// Writes `data` as hex into `out` (two characters per byte), returning the
+/// number of characters written, or 0 if they do not fit
+auto encode(std::span<const u8> data, std::span<char> out,
+            bool uppercase = false) -> usize;
+
+auto encode(std::span<const u8> data, bool uppercase = false) -> std::string;
+
+auto encode(std::string_view data, bool uppercase = false) -> std::string;
+
+/// Decodes hex of either case into `out`, returning the number of bytes
+/// written
+auto decode(std::string_view text, std::span<u8> out)
+    -> manifold::result<usize, DecodeError>;
+
+auto decode(std::string_view text)
+    -> manifold::result<std::vector<u8>, DecodeError>;
+
+} // namespace hex
+
+} // namespace manifold::str
+
+#endif
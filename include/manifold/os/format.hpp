@@ -0,0 +1,384 @@
+/**
+ *  MIT License
+ *
+ * Copyright (c) 2025 Jules Nieves
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ *all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **/
+
+#ifndef Manifold_Format_hpp
+#define Manifold_Format_hpp
+
+#include "../_defines.hpp"
+#include "../concepts.hpp"
+#include "str.hpp"
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace manifold::str {
+
+/// One argument of a `format` call, with its type erased
+struct FormatArg {
+  enum class Kind : u8 {
+    Bool,
+    Char,
+    Int,
+    Uint,
+    Float,
+    Float32,
+    String,
+    Pointer
+  };
+
+  Kind kind;
+  union {
+    bool boolean;
+    char ch;
+    i64 integer;
+    u64 uinteger;
+    double floating;
+    /// Kept as a `float` so it prints with the fewest digits that read
+    /// back as the same `float`
+    float single;
+    /// Not a `std::string_view`, which would make the union non-trivial
+    struct {
+      const char *data;
+      usize size;
+    } string;
+    const void *pointer;
+  };
+
+  /// How an argument of type `T` is passed to the formatter
+  template <typename T> static consteval auto kind_of() -> Kind {
+    using type = std::remove_cvref_t<T>;
+    if constexpr (std::is_same_v<type, bool>)
+      return Kind::Bool;
+    else if constexpr (std::is_same_v<type, char>)
+      return Kind::Char;
+    else if constexpr (std::is_integral_v<type> && std::is_signed_v<type>)
+      return Kind::Int;
+    else if constexpr (std::is_integral_v<type>)
+      return Kind::Uint;
+    else if constexpr (std::is_same_v<type, float>)
+      return Kind::Float32;
+    else if constexpr (std::is_floating_point_v<type>)
+      return Kind::Float;
+    else if constexpr (std::is_null_pointer_v<type>)
+      return Kind::Pointer;
+    else if constexpr (concepts::StringViewConvertible<type>)
+      return Kind::String;
+    else if constexpr (std::is_pointer_v<type>)
+      return Kind::Pointer;
+    else
+      static_assert(!std::is_same_v<type, type>,
+                    "str::format cannot format this type");
+  }
+
+  template <typename T>
+  static constexpr auto from(const T &value) -> FormatArg {
+    FormatArg arg{};
+    arg.kind = kind_of<T>();
+    if constexpr (kind_of<T>() == Kind::Bool)
+      arg.boolean = value;
+    else if constexpr (kind_of<T>() == Kind::Char)
+      arg.ch = value;
+    else if constexpr (kind_of<T>() == Kind::Int)
+      arg.integer = value;
+    else if constexpr (kind_of<T>() == Kind::Uint)
+      arg.uinteger = value;
+    else if constexpr (kind_of<T>() == Kind::Float)
+      arg.floating = value;
+    else if constexpr (kind_of<T>() == Kind::Float32)
+      arg.single = value;
+    else if constexpr (kind_of<T>() == Kind::String)
+      arg.string = {std::string_view(value).data(),
+                    std::string_view(value).size()};
+    else
+      arg.pointer = value;
+
+    return arg;
+  }
+};
+
+/// A replacement field, `{:[[fill]align][+][0][width][.precision][type]}`
+struct FormatSpec {
+  char fill = ' ';
+  /// '<', '>', '^', or '\0' for the default (numbers right, text left)
+  char align = '\0';
+  bool plus = false;
+  bool zero = false;
+  u16 width = 0;
+  /// -1 if not given
+  i16 precision = -1;
+  /// Presentation type, '\0' for the default
+  char type = '\0';
+};
+
+/// A field and the literal text that precedes it in the format string
+struct FormatField {
+  u32 literal_begin = 0;
+  u32 literal_end = 0;
+  /// The literal holds "{{" or "}}", which print as one brace
+  bool escaped = false;
+  FormatSpec spec;
+};
+
+/// A format string parsed at compile time
+struct ParsedFormat {
+  std::string_view text;
+  std::span<const FormatField> fields;
+  FormatField tail;
+};
+
+/// Called while parsing a bad format string, which turns it into a compile
+/// error naming this function and its argument
+auto format_error(const char *why) -> void;
+
+/// A format string checked against the types of its arguments at compile
+/// time: braces must balance, the number of fields must match the number of
+/// arguments, and every spec must make sense for its argument's type
+///
+/// Fields are `{}` or `{:spec}` and take the arguments in order. Types are
+/// `d x X b o` for integers, `f e g` for floats, `s` for strings and bools,
+/// `c` for chars and `p` for pointers. Widths count bytes.
+///
+/// As with `std::format`, a float with no type prints the shortest digits
+/// that read back as the same value (a `float` as a `float`), and `f e g`
+/// without a precision mean a precision of 6. Infinities and NaN ignore the
+/// '0' flag and are padded with the fill instead.
+template <typename... Args> class FormatString {
+public:
+  template <usize N>
+  consteval FormatString(const char (&str)[N]) : text(str, N - 1) {
+    constexpr FormatArg::Kind kinds[] = {FormatArg::kind_of<Args>()...,
+                                         FormatArg::Kind::Bool};
+    usize field = 0;
+    usize literal = 0;
+    bool escaped = false;
+    for (usize i = 0; i < text.size(); i++) {
+      if (text[i] == '}') {
+        if (i + 1 >= text.size() || text[i + 1] != '}')
+          format_error("unmatched '}' in format string");
+
+        escaped = true;
+        i++;
+        continue;
+      }
+
+      if (text[i] != '{')
+        continue;
+
+      if (i + 1 < text.size() && text[i + 1] == '{') {
+        escaped = true;
+        i++;
+        continue;
+      }
+
+      if (field >= sizeof...(Args))
+        format_error("more fields than arguments");
+
+      usize close = text.find('}', i);
+      if (close == std::string_view::npos)
+        format_error("unterminated field");
+
+      auto &current = fields[field];
+      current.literal_begin = static_cast<u32>(literal);
+      current.literal_end = static_cast<u32>(i);
+      current.escaped = escaped;
+      current.spec = parse_spec(text.substr(i + 1, close - i - 1),
+                                kinds[field]);
+
+      field++;
+      literal = close + 1;
+      escaped = false;
+      i = close;
+    }
+
+    if (field != sizeof...(Args))
+      format_error("fewer fields than arguments");
+
+    tail.literal_begin = static_cast<u32>(literal);
+    tail.literal_end = static_cast<u32>(text.size());
+    tail.escaped = escaped;
+  }
+
+  auto parsed() const -> ParsedFormat { return {text, fields, tail}; }
+
+private:
+  static consteval auto parse_spec(std::string_view spec, FormatArg::Kind kind)
+      -> FormatSpec {
+    FormatSpec result;
+    if (spec.empty())
+      return result;
+
+    if (spec[0] != ':')
+      format_error("fields take no argument index");
+
+    spec.remove_prefix(1);
+    auto is_align = [](char ch) { return ch == '<' || ch == '>' || ch == '^'; };
+    if (spec.size() >= 2 && is_align(spec[1])) {
+      result.fill = spec[0];
+      result.align = spec[1];
+      spec.remove_prefix(2);
+    } else if (!spec.empty() && is_align(spec[0])) {
+      result.align = spec[0];
+      spec.remove_prefix(1);
+    }
+
+    if (!spec.empty() && spec[0] == '+') {
+      result.plus = true;
+      spec.remove_prefix(1);
+    }
+
+    if (!spec.empty() && spec[0] == '0') {
+      result.zero = true;
+      spec.remove_prefix(1);
+    }
+
+    auto number = [&](usize limit) {
+      usize value = 0;
+      while (!spec.empty() && spec[0] >= '0' && spec[0] <= '9') {
+        value = value * 10 + static_cast<usize>(spec[0] - '0');
+        if (value > limit)
+          format_error("width or precision too large");
+
+        spec.remove_prefix(1);
+      }
+
+      return value;
+    };
+
+    result.width = static_cast<u16>(number(1024));
+    if (!spec.empty() && spec[0] == '.') {
+      spec.remove_prefix(1);
+      if (spec.empty() || spec[0] < '0' || spec[0] > '9')
+        format_error("missing precision");
+
+      result.precision = static_cast<i16>(number(100));
+    }
+
+    if (!spec.empty()) {
+      result.type = spec[0];
+      spec.remove_prefix(1);
+    }
+
+    if (!spec.empty())
+      format_error("unknown format spec");
+
+    std::string_view types;
+    bool numeric = true;
+    switch (kind) {
+    case FormatArg::Kind::Int:
+    case FormatArg::Kind::Uint:
+      types = "dxXbo";
+      break;
+    case FormatArg::Kind::Float:
+    case FormatArg::Kind::Float32:
+      types = "feg";
+      break;
+    case FormatArg::Kind::String:
+    case FormatArg::Kind::Bool:
+      types = "s";
+      numeric = false;
+      break;
+    case FormatArg::Kind::Char:
+      types = "c";
+      numeric = false;
+      break;
+    case FormatArg::Kind::Pointer:
+      types = "p";
+      numeric = false;
+      break;
+    }
+
+    if (result.type != '\0' &&
+        types.find(result.type) == std::string_view::npos)
+      format_error("format type does not match the argument");
+
+    if (!numeric && (result.plus || result.zero))
+      format_error("'+' and '0' only apply to numbers");
+
+    if (result.precision >= 0 && kind != FormatArg::Kind::Float &&
+        kind != FormatArg::Kind::Float32 && kind != FormatArg::Kind::String)
+      format_error("precision only applies to floats and strings");
+
+    return result;
+  }
+
+  std::string_view text;
+  std::array<FormatField, sizeof...(Args)> fields{};
+  FormatField tail;
+};
+
+/// Formatters behind `format` and friends, with the arguments type-erased
+auto vformat(const ParsedFormat &fmt, std::span<const FormatArg> args)
+    -> std::string;
+auto vformat_to(Builder &out, const ParsedFormat &fmt,
+                std::span<const FormatArg> args) -> void;
+auto vformat_to(std::span<char> out, const ParsedFormat &fmt,
+                std::span<const FormatArg> args) -> usize;
+auto vprint(int fd, const ParsedFormat &fmt, std::span<const FormatArg> args)
+    -> bool;
+
+/// Formats the arguments into a new string
+///
+/// No locale and no streams are involved: output goes into a small buffer
+/// that is only handed on when it fills up.
+template <typename... Args>
+auto format(FormatString<std::type_identity_t<Args>...> fmt,
+            const Args &...args) -> std::string {
+  const FormatArg erased[] = {FormatArg::from(args)..., FormatArg{}};
+  return vformat(fmt.parsed(), std::span(erased, sizeof...(Args)));
+}
+
+/// Appends the formatted arguments to a builder
+template <typename... Args>
+auto format_to(Builder &out, FormatString<std::type_identity_t<Args>...> fmt,
+               const Args &...args) -> Builder & {
+  const FormatArg erased[] = {FormatArg::from(args)..., FormatArg{}};
+  vformat_to(out, fmt.parsed(), std::span(erased, sizeof...(Args)));
+  return out;
+}
+
+/// Writes the formatted arguments into `out`, returning the number of bytes
+/// written (output past `out.size()` is cut off)
+template <typename... Args>
+auto format_to(std::span<char> out,
+               FormatString<std::type_identity_t<Args>...> fmt,
+               const Args &...args) -> usize {
+  const FormatArg erased[] = {FormatArg::from(args)..., FormatArg{}};
+  return vformat_to(out, fmt.parsed(), std::span(erased, sizeof...(Args)));
+}
+
+/// Writes the formatted arguments to a file descriptor, returning false if a
+/// write failed
+template <typename... Args>
+auto print(int fd, FormatString<std::type_identity_t<Args>...> fmt,
+           const Args &...args) -> bool {
+  const FormatArg erased[] = {FormatArg::from(args)..., FormatArg{}};
+  return vprint(fd, fmt.parsed(), std::span(erased, sizeof...(Args)));
+}
+
+} // namespace manifold::str
+
+#endif
@@ -28,17 +28,151 @@
 
 #include "../_defines.hpp"
 #include "../adt/result.hpp"
+#include "../hash.hpp"
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace manifold::fs {
 
-enum class Error { NoFileExists };
+enum class Error { NoFileExists, IoError, Unsupported };
 
 using path_type = std::filesystem::path;
 
+/// A compact table of paths (e.g. walk or search results)
+///
+/// Paths are stored as a parent-pointer tree of components, so shared
+/// prefixes (directories) are only stored once. Component names are interned
+/// and front-coded in blocks, an entry costs a handful of bytes rather than a
+/// full `path_type` allocation.
+class PathTable {
+public:
+  using id_type = u32;
+
+  /// Parent of top-level components
+  static constexpr id_type root = ~id_type{0};
+
+  /// Iterator over the entries (in insertion order)
+  ///
+  /// Paths are rebuilt on dereference and returned by value, so it is a
+  /// C++20 forward iterator but only a legacy input iterator.
+  class iterator {
+  public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = path_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = path_type;
+
+    iterator() = default;
+    iterator(const PathTable *owner, usize position)
+        : table(owner), index(position) {}
+
+    auto operator*() const -> path_type;
+    auto operator++() -> iterator & {
+      ++index;
+      return *this;
+    }
+    auto operator++(int) -> iterator {
+      auto copy = *this;
+      ++index;
+      return copy;
+    }
+    auto operator==(const iterator &other) const -> bool = default;
+
+    /// Id of the entry the iterator points at
+    auto id() const -> id_type;
+
+  private:
+    const PathTable *table = nullptr;
+    usize index = 0;
+  };
+
+  /// Inserts a path (no-op if already present), returns its id
+  auto insert(const path_type &path) -> id_type;
+
+  /// Looks up the id of a previously inserted path
+  auto find(const path_type &path) const
+      -> manifold::result<id_type, fs::Error>;
+
+  /// Returns true if the path was inserted
+  auto contains(const path_type &path) const -> bool;
+
+  /// Rebuilds the full path for an id
+  auto path(id_type id) const -> path_type;
+
+  /// Returns the last component of an id
+  auto name(id_type id) const -> std::string;
+
+  /// Returns the parent id of an id (or `root`)
+  auto parent(id_type id) const -> id_type;
+
+  /// Ids of the entries, in insertion order
+  auto ids() const -> const std::vector<id_type> & { return entries; }
+
+  /// Ids of the entries, sorted component-wise
+  auto sorted() const -> std::vector<id_type>;
+
+  /// Number of entries
+  auto size() const -> usize { return entries.size(); }
+
+  /// Returns true if the table holds no entries
+  auto empty() const -> bool { return entries.empty(); }
+
+  /// Removes every entry
+  auto clear() -> void;
+
+  /// Releases spare capacity (e.g. once a walk has finished)
+  auto shrink_to_fit() -> void;
+
+  /// Approximate number of heap bytes held by the table
+  auto memory_usage() const -> usize;
+
+  auto begin() const -> iterator { return iterator(this, 0); }
+  auto end() const -> iterator { return iterator(this, entries.size()); }
+
+private:
+  struct Node {
+    id_type parent;
+    id_type name;
+  };
+
+  /// Names per front-coding block (the first name of a block is stored whole)
+  static constexpr u32 kBlockSize = 16;
+
+  auto is_entry(id_type node) const -> bool;
+  auto intern(std::string_view name) -> id_type;
+
+  /// Lookups return `root` when nothing matches
+  auto lookup_name(std::string_view name, u64 hash) const -> id_type;
+  auto decode_name(id_type name, std::string &out) const -> void;
+  auto lookup_child(id_type parent, id_type name) const -> id_type;
+  auto grow_names() -> void;
+  auto grow_children() -> void;
+
+  std::vector<Node> nodes;
+  std::vector<id_type> entries;
+  std::vector<u64> entry_bits;
+
+  std::vector<u8> names;
+  std::vector<usize> restarts;
+  std::string last_name;
+  u32 name_count = 0;
+
+  /// Open-addressed name index (`name + 1`) with an 8-bit hash tag per slot
+  std::vector<id_type> name_slots;
+  std::vector<u8> name_tags;
+
+  /// Open-addressed `(parent, name)` -> node index, `node + 1`
+  std::vector<id_type> child_slots;
+};
+
 /// Return the current working directory
 auto cwd() -> path_type;
 
@@ -53,10 +187,130 @@ auto read_file(const path_type &path)
 auto read_file_bytes(const path_type &path)
     -> manifold::result<std::vector<u8>, fs::Error>;
 
+/// Reads many files at once (blocking), results are in the same order as
+/// `paths`
+///
+/// Reads are issued in on-disk order (FIEMAP physical offset where the
+/// filesystem reports it, inode number otherwise) by at most `concurrency`
+/// threads (`env::processor_count()` if 0).
+auto read_files(std::span<const path_type> paths, usize concurrency = 0)
+    -> std::vector<manifold::result<std::vector<u8>, fs::Error>>;
+
 /// Write a byte vector to a file
 auto write_bytes(const path_type &path, const std::vector<u8> &bytes)
     -> manifold::result<void, fs::Error>;
 
+/// A read-only memory mapping of a whole file
+class MappedFile {
+public:
+  /// Maps a file for reading
+  static auto open(const path_type &path)
+      -> manifold::result<MappedFile, fs::Error>;
+
+  MappedFile(MappedFile &&other) noexcept;
+  auto operator=(MappedFile &&other) noexcept -> MappedFile &;
+  MappedFile(const MappedFile &) = delete;
+  auto operator=(const MappedFile &) -> MappedFile & = delete;
+  ~MappedFile();
+
+  /// Contents of the file
+  auto bytes() const -> std::span<const u8> { return {data, length}; }
+
+  /// Contents of the file as text
+  auto view() const -> std::string_view {
+    return {reinterpret_cast<const char *>(data), length};
+  }
+
+  /// Size of the file
+  auto size() const -> usize { return length; }
+
+private:
+  MappedFile(const u8 *map, usize size) : data(map), length(size) {}
+
+  auto unmap() -> void;
+
+  const u8 *data = nullptr;
+  usize length = 0;
+};
+
+/// Writes a file through a shared memory mapping
+///
+/// The file is grown by doubling (`ftruncate`), written pages are flushed
+/// periodically (`msync`) and the file is truncated to the exact number of
+/// bytes written on close. Output never has to be staged in a separate
+/// buffer, bytes go straight into the page cache.
+class MappedWriter {
+public:
+  /// Creates (or truncates) a file for writing
+  static auto create(const path_type &path, usize capacity = 1UL << 20)
+      -> manifold::result<MappedWriter, fs::Error>;
+
+  MappedWriter(MappedWriter &&other) noexcept;
+  auto operator=(MappedWriter &&other) noexcept -> MappedWriter &;
+  MappedWriter(const MappedWriter &) = delete;
+  auto operator=(const MappedWriter &) -> MappedWriter & = delete;
+  ~MappedWriter();
+
+  /// Appends bytes to the file
+  auto write(std::span<const u8> bytes) -> manifold::result<void, fs::Error>;
+
+  /// Appends a string to the file
+  auto write(std::string_view str) -> manifold::result<void, fs::Error>;
+
+  /// Returns a writable region of at least `size` bytes at the end of the
+  /// file, bytes written to it are kept with `commit()`
+  auto reserve(usize size) -> manifold::result<std::span<u8>, fs::Error>;
+
+  /// Keeps `size` bytes of the last `reserve()`d region
+  auto commit(usize size) -> void;
+
+  /// Starts an asynchronous flush of the pages written so far
+  auto flush() -> manifold::result<void, fs::Error>;
+
+  /// Unmaps the file and truncates it to the bytes written
+  auto close() -> manifold::result<void, fs::Error>;
+
+  /// Number of bytes written
+  auto size() const -> usize { return length; }
+
+  /// Size of the file while it is being written
+  auto capacity() const -> usize { return mapped; }
+
+  /// Bytes written between two automatic flushes
+  static constexpr usize kSyncInterval = 64UL << 20;
+
+private:
+  MappedWriter(int fd, u8 *data, usize mapped);
+
+  auto grow(usize needed) -> manifold::result<void, fs::Error>;
+
+  int fd = -1;
+  u8 *data = nullptr;
+  usize mapped = 0;
+  usize length = 0;
+  usize synced = 0;
+};
+
+/// How `hash_file` hashes large files
+enum class HashMode {
+  /// Same digest as hashing the whole contents at once
+  Flat,
+  /// Digest of the little-endian digests of every `kHashChunk` bytes
+  Tree,
+};
+
+/// Chunk size used by `HashMode::Tree`
+inline constexpr usize kHashChunk = 1UL << 20;
+
+/// Hashes a file straight from a read-only mapping
+///
+/// Tree mode hashes chunks on `env::processor_count()` threads, CRC-32C is
+/// parallel in flat mode as well (chunk checksums are combined). Files that
+/// fit in a single chunk hash the same in both modes.
+auto hash_file(const path_type &path, hash::Algorithm algo,
+               HashMode mode = HashMode::Flat)
+    -> manifold::result<u64, fs::Error>;
+
 /// Check if a path exists
 auto path_exists(const path_type &path) -> bool;
 
@@ -85,6 +339,11 @@ auto search(const path_type &dir,
             const std::function<bool(const path_type &)> &matcher)
     -> manifold::result<path_type, fs::Error>;
 
+/// Collects every path in a dir accepted by a matcher function
+auto search_all(const path_type &dir,
+                const std::function<bool(const path_type &)> &matcher)
+    -> manifold::result<PathTable, fs::Error>;
+
 } // namespace manifold::fs
 
 #endif
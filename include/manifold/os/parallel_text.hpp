@@ -0,0 +1,131 @@
+/**
+ *  MIT License
+ *
+ * Copyright (c) 2025 Jules Nieves
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ *all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **/
+
+#ifndef Manifold_ParallelText_hpp
+#define Manifold_ParallelText_hpp
+
+#include "../_defines.hpp"
+#include <functional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace manifold::str {
+
+/// Target size of the chunks the `parallel_*` helpers split a text into
+inline constexpr usize kLineChunkSize = usize{1} << 20;
+
+/// Splits `text` into chunks of about `size` bytes that each end just after
+/// a newline (the last one where `text` ends), so no line is cut in two
+///
+/// The chunks depend only on `text` and `size`, never on the number of
+/// threads, which keeps the `parallel_*` results the same on any machine.
+auto line_chunks(std::string_view text, usize size = kLineChunkSize)
+    -> std::vector<std::string_view>;
+
+/// Calls `fn(index, chunk)` for each of `chunks` on up to `threads` threads
+/// (`env::processor_count()` if 0), chunks are handed out in order
+auto parallel_chunks(std::span<const std::string_view> chunks,
+                     const std::function<void(usize, std::string_view)> &fn,
+                     usize threads = 0) -> void;
+
+/// Calls `fn(line)` for every line of `text` in order, without its '\n'; a
+/// newline at the very end does not start another line
+template <typename F>
+auto for_each_line(std::string_view text, F &&fn) -> void {
+  while (!text.empty()) {
+    usize end = text.find('\n');
+    if (end == std::string_view::npos) {
+      fn(text);
+      return;
+    }
+
+    fn(text.substr(0, end));
+    text.remove_prefix(end + 1);
+  }
+}
+
+/// Calls `fn(line)` for every line of `text` (as `for_each_line`) on up to
+/// `threads` threads
+///
+/// Lines of one chunk are visited in order by one thread, but chunks run
+/// concurrently, so `fn` has to be safe to call from several threads; use
+/// `parallel_reduce_lines` to collect results in order.
+template <typename F>
+auto parallel_lines(std::string_view text, F &&fn, usize threads = 0)
+    -> void {
+  auto chunks = line_chunks(text);
+  parallel_chunks(
+      chunks,
+      [&](usize, std::string_view chunk) { for_each_line(chunk, fn); },
+      threads);
+}
+
+/// Counts the non-overlapping occurrences of `needle` in `text` (as
+/// `Searcher::count`) on up to `threads` threads
+///
+/// A needle with a newline in it can straddle chunks and is counted on one
+/// thread.
+auto parallel_count(std::string_view text, std::string_view needle,
+                    usize threads = 0) -> usize;
+
+/// Map-reduce over the lines of `text` on up to `threads` threads
+///
+/// Each chunk starts from `T{}` and folds its lines in with
+/// `map(accumulator, line)`; the chunk results are then combined in text
+/// order with `reduce(total, chunk_result)`, starting from `init`, so `init`
+/// is folded in once however many chunks there are. `T{}` has to be the
+/// identity of `reduce`. The result does not depend on the thread count or
+/// on scheduling.
+template <typename T, typename Map, typename Reduce>
+auto parallel_reduce_lines(std::string_view text, T init, Map &&map,
+                           Reduce &&reduce, usize threads = 0) -> T {
+  // wrapped, so that a `std::vector<bool>` does not pack the chunks' results
+  // into shared words
+  struct Partial {
+    T value{};
+  };
+
+  auto chunks = line_chunks(text);
+  std::vector<Partial> partial(chunks.size());
+  parallel_chunks(
+      chunks,
+      [&](usize i, std::string_view chunk) {
+        for_each_line(chunk, [&](std::string_view line) {
+          map(partial[i].value, line);
+        });
+      },
+      threads);
+
+  T total = std::move(init);
+  for (auto &result : partial)
+    reduce(total, std::move(result.value));
+
+  return total;
+}
+
+} // namespace manifold::str
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ *  MIT License
+ *
+ * Copyright (c) 2025 Jules Nieves
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ *all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **/
+
+#ifndef Manifold_Pattern_hpp
+#define Manifold_Pattern_hpp
+
+#include "../_defines.hpp"
+#include "../adt/result.hpp"
+#include "str.hpp"
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace manifold::str {
+
+/// Options for `Pattern::compile`
+struct PatternOptions {
+  /// ASCII letters match either case
+  bool ignore_case = false;
+};
+
+/// Why `Pattern::compile` rejected a pattern, and at which byte of it
+struct PatternError {
+  enum class Kind {
+    UnbalancedGroup,
+    UnterminatedClass,
+    BadRange,
+    BadEscape,
+    BadRepeat,
+    NothingToRepeat,
+    NonAsciiClass,
+    TooLarge,
+  };
+
+  Kind kind;
+  usize offset;
+};
+
+/// A regular expression compiled to a lazily built DFA
+///
+/// Supports literals, `.`, classes (`[a-z_]`, `[^/]`, `\d \w \s` and their
+/// negations), groups (`(...)`, `(?:...)`), alternation, `^` and `$` (start
+/// and end of the text) and the repetitions `* + ? {n} {n,} {n,m}`. There are
+/// no backreferences or lookaround, so a match is one pass over the text and
+/// never backtracks. `.` and negated classes match a whole UTF-8 sequence.
+///
+/// DFA states are built the first time a match reaches them and kept until
+/// the cache is full, when it starts over; after warming up a match costs a
+/// table lookup per byte. Each match borrows a cache from a pool the pattern
+/// and its copies share, so threads matching at the same time never share a
+/// cache and each ends up with a warm one. Patterns take strings or paths,
+/// so one can be passed as an `fs::search` matcher.
+class Pattern {
+public:
+  static auto compile(std::string_view source,
+                      const PatternOptions &options = {})
+      -> manifold::result<Pattern, PatternError>;
+
+  /// True if the whole of `text` matches
+  auto matches(std::string_view text) const -> bool;
+
+  /// True if a part of `text` matches (the whole text if anchored)
+  auto search(std::string_view text) const -> bool;
+
+  auto operator()(std::string_view text) const -> bool {
+    return search(text);
+  }
+
+  /// Searches a path, e.g. as a `fs::search` matcher
+  template <typename Path>
+    requires requires(const Path &path) { path.native(); }
+  auto operator()(const Path &path) const -> bool {
+    if constexpr (std::is_convertible_v<decltype(path.native()),
+                                        std::string_view>)
+      return search(path.native());
+    else
+      return search(path.string());
+  }
+
+private:
+  using state_type = u32;
+
+  static constexpr state_type unknown = ~state_type{0};
+
+  /// Number of DFA states kept before the cache starts over
+  static constexpr usize kMaxStates = 4096;
+
+  /// An NFA instruction: consume a byte of `sets[set]`, fork, jump, check an
+  /// anchor or accept
+  struct Node {
+    enum class Op : u8 { Byte, Split, Jump, Begin, End, Match };
+
+    Op op;
+    u32 set = 0;
+    u32 out = 0;
+    u32 alt = 0;
+  };
+
+  /// DFA states, each keyed by its sorted NFA nodes, and their transitions
+  /// (`next[state * class_count + class]`)
+  struct Cache {
+    HashMap<state_type> ids;
+    std::vector<std::string> keys;
+    std::vector<state_type> next;
+    std::vector<u8> flags;
+    state_type starts[2] = {unknown, unknown};
+
+    auto clear() -> void {
+      ids.clear();
+      keys.clear();
+      next.clear();
+      flags.clear();
+      starts[0] = starts[1] = unknown;
+    }
+  };
+
+  /// Caches no match is using at the moment
+  struct CachePool;
+
+  struct Compiler;
+
+  Pattern() = default;
+
+  auto follow(u32 node, bool at_start, bool at_end,
+              std::vector<u32> &members, std::vector<bool> &seen) const
+      -> void;
+  auto start(Cache &cache, bool anchored) const -> state_type;
+  auto step(Cache &cache, state_type state, u8 cls) const -> state_type;
+  auto add_state(Cache &cache, std::vector<u32> &members, bool at_start) const
+      -> state_type;
+  auto run(std::string_view text, bool anchored) const -> bool;
+  auto run(Cache &cache, std::string_view text, bool anchored) const -> bool;
+
+  std::vector<Node> nodes;
+  std::vector<CharSet> sets;
+
+  /// Bytes no node tells apart share a class, represented by its first byte
+  std::array<u8, 256> classes{};
+  std::vector<u8> representatives;
+
+  /// First node of the pattern, and of the loop skipping to any start
+  u32 anchored_start = 0;
+  u32 search_start = 0;
+
+  std::shared_ptr<CachePool> caches;
+};
+
+} // namespace manifold::str
+
+#endif
@@ -27,44 +27,1332 @@
 #define Manifold_String_hpp
 
 #include "../_defines.hpp"
+#include "../adt/result.hpp"
+#include "../concepts.hpp"
+#include "../hash.hpp"
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <compare>
+#include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
 #include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace manifold::str {
 
 /// Checks if a string ends with a certain substring
-auto ends_with(const std::string &str, const std::string &suffix) -> bool;
+auto ends_with(std::string_view str, std::string_view suffix) -> bool;
 
 /// Checks if a string starts with a certain substring
-auto starts_with(const std::string &str, const std::string &prefix) -> bool;
+auto starts_with(std::string_view str, std::string_view prefix) -> bool;
+
+/// Finds the first `needle` in `haystack` at or after `pos`, or `npos`
+///
+/// Candidates are filtered with SIMD compares on two of the needle's rarest
+/// bytes before being verified, so most of the haystack is skipped in bulk.
+auto find(std::string_view haystack, std::string_view needle, usize pos = 0)
+    -> usize;
+
+/// A needle precompiled for searching many haystacks
+///
+/// Picks the needle's rarest bytes for the SIMD filter once, and keeps a
+/// Horspool shift table for the scalar parts of a search.
+class Searcher {
+public:
+  explicit Searcher(std::string_view needle);
+
+  /// Finds the first match at or after `pos`, or `npos`
+  auto find(std::string_view haystack, usize pos = 0) const -> usize;
+
+  /// Counts non-overlapping matches
+  auto count(std::string_view haystack) const -> usize;
+
+  auto needle() const -> std::string_view { return pattern; }
+
+private:
+  auto find_scalar(std::string_view haystack, usize pos) const -> usize;
+
+  std::string pattern;
+  usize rare_first = 0;
+  usize rare_second = 0;
+  std::vector<usize> shifts;
+};
 
 /// Splits a string into a vector of strings
-auto split(const std::string &str, const std::string &delim)
+auto split(std::string_view str, std::string_view delim)
     -> std::vector<std::string>;
 
+/// Lazy range over the pieces of a string split on a delimiter (the pieces
+/// view the original string, which has to outlive the range)
+class SplitView {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view *;
+    using reference = std::string_view;
+
+    iterator() = default;
+
+    auto operator*() const -> std::string_view { return piece; }
+    auto operator->() const -> const std::string_view * { return &piece; }
+    auto operator++() -> iterator &;
+    auto operator++(int) -> iterator {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    auto operator==(const iterator &other) const -> bool {
+      return done == other.done && (done || next == other.next);
+    }
+
+  private:
+    friend class SplitView;
+
+    iterator(std::string_view source, std::string_view delimiter);
+
+    std::string_view str;
+    std::string_view delim;
+    std::string_view piece;
+    usize next = 0; // where the piece after this one starts
+    bool done = true;
+  };
+
+  SplitView(std::string_view source, std::string_view delimiter)
+      : str(source), delim(delimiter) {}
+
+  auto begin() const -> iterator { return iterator(str, delim); }
+  auto end() const -> iterator { return iterator(); }
+
+private:
+  std::string_view str;
+  std::string_view delim;
+};
+
+/// Splits a string into views of its pieces without allocating
+auto split_view(std::string_view str, std::string_view delim) -> SplitView;
+
+/// A set of byte values as a 256-bit map, built at compile time
+///
+/// It is a structural type, so sets can be passed as template arguments
+/// (`Tokenizer<chars::whitespace, ",;|">`); `bits` is public only for that.
+struct CharSet {
+  std::array<u64, 4> bits{};
+
+  constexpr CharSet() = default;
+
+  template <usize N> constexpr CharSet(const char (&chars)[N]) {
+    for (usize i = 0; i + 1 < N; i++)
+      insert(chars[i]);
+  }
+
+  constexpr explicit CharSet(std::string_view chars) {
+    for (char ch : chars)
+      insert(ch);
+  }
+
+  /// Every byte from `first` to `last`, inclusive
+  static constexpr auto range(char first, char last) -> CharSet {
+    CharSet set;
+    for (auto byte = static_cast<u8>(first); byte <= static_cast<u8>(last);
+         byte++) {
+      set.insert(static_cast<char>(byte));
+      if (byte == 255)
+        break;
+    }
+
+    return set;
+  }
+
+  constexpr auto insert(char ch) -> void {
+    auto byte = static_cast<u8>(ch);
+    bits[byte >> 6] |= u64{1} << (byte & 63);
+  }
+
+  constexpr auto contains(char ch) const -> bool {
+    auto byte = static_cast<u8>(ch);
+    return ((bits[byte >> 6] >> (byte & 63)) & 1) != 0;
+  }
+
+  constexpr auto empty() const -> bool {
+    return (bits[0] | bits[1] | bits[2] | bits[3]) == 0;
+  }
+
+  constexpr auto operator|(const CharSet &other) const -> CharSet {
+    CharSet set;
+    for (usize i = 0; i < 4; i++)
+      set.bits[i] = bits[i] | other.bits[i];
+
+    return set;
+  }
+
+  constexpr auto operator&(const CharSet &other) const -> CharSet {
+    CharSet set;
+    for (usize i = 0; i < 4; i++)
+      set.bits[i] = bits[i] & other.bits[i];
+
+    return set;
+  }
+
+  constexpr auto operator~() const -> CharSet {
+    CharSet set;
+    for (usize i = 0; i < 4; i++)
+      set.bits[i] = ~bits[i];
+
+    return set;
+  }
+
+  constexpr auto operator==(const CharSet &other) const -> bool = default;
+};
+
+/// Common character classes
+namespace chars {
+
+inline constexpr CharSet whitespace(" \t\n\v\f\r");
+inline constexpr CharSet digits = CharSet::range('0', '9');
+inline constexpr CharSet lower = CharSet::range('a', 'z');
+inline constexpr CharSet upper = CharSet::range('A', 'Z');
+inline constexpr CharSet alpha = lower | upper;
+inline constexpr CharSet alnum = alpha | digits;
+inline constexpr CharSet punct = CharSet::range('!', '/') |
+                                 CharSet::range(':', '@') |
+                                 CharSet::range('[', '`') |
+                                 CharSet::range('{', '~');
+
+} // namespace chars
+
+/// How a `Tokenizer` treats delimiters and quotes
+struct TokenizerOptions {
+  /// Yield the delimiters as tokens of their own, between the text tokens
+  bool keep_delimiters = false;
+
+  /// Treat a run of delimiters as a single one; the input's leading and
+  /// trailing delimiters then produce no empty tokens either
+  bool merge_runs = false;
+
+  /// Bytes that open a quoted section, which runs to the next occurrence of
+  /// the same byte; delimiters inside it are plain text
+  CharSet quotes = {};
+
+  /// Drop the quotes around a token that is one whole quoted section
+  bool strip_quotes = false;
+};
+
+/// Splits strings on any byte of a set of character classes
+///
+/// The classes are merged into one lookup table at compile time, so finding
+/// the end of a token costs one table load per byte whatever the number of
+/// delimiters. Without `keep_delimiters` tokens are what lies between
+/// delimiters, empty ones included (unless `merge_runs` is set), like
+/// `split_view`. With it, every byte ends up in exactly one non-empty token,
+/// either text or delimiters (one per byte, or one per run with
+/// `merge_runs`). Tokens view the input, which has to outlive the range.
+template <CharSet... Classes> class Tokenizer {
+  static constexpr u8 kDelimiter = 1;
+  static constexpr u8 kQuote = 2;
+
+public:
+  /// Union of every class the tokenizer splits on
+  static constexpr CharSet delimiters = (CharSet() | ... | Classes);
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view *;
+    using reference = std::string_view;
+
+    iterator() = default;
+
+    auto operator*() const -> std::string_view { return piece; }
+    auto operator->() const -> const std::string_view * { return &piece; }
+    auto operator++() -> iterator & {
+      next = owner->advance(str, next, piece);
+      done = piece.data() == nullptr;
+      return *this;
+    }
+    auto operator++(int) -> iterator {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    auto operator==(const iterator &other) const -> bool {
+      return done == other.done && (done || next == other.next);
+    }
+
+  private:
+    friend class Tokenizer;
+
+    iterator(const Tokenizer *tokenizer, std::string_view source)
+        : owner(tokenizer), str(source), done(false) {
+      ++*this;
+    }
+
+    const Tokenizer *owner = nullptr;
+    std::string_view str;
+    std::string_view piece;
+    usize next = 0; // where scanning for the token after this one starts
+    bool done = true;
+  };
+
+  /// Tokens of one string; it holds a copy of the tokenizer, so it stays
+  /// usable when the tokenizer was a temporary
+  class range;
+
+  constexpr Tokenizer() : Tokenizer(TokenizerOptions{}) {}
+
+  constexpr explicit Tokenizer(const TokenizerOptions &options)
+      : keep_delimiters(options.keep_delimiters),
+        merge_runs(options.merge_runs), strip_quotes(options.strip_quotes) {
+    for (usize byte = 0; byte < 256; byte++) {
+      auto ch = static_cast<char>(byte);
+      table[byte] = (delimiters.contains(ch) ? kDelimiter : 0) |
+                    (options.quotes.contains(ch) ? kQuote : 0);
+    }
+  }
+
+  static constexpr auto is_delimiter(char ch) -> bool {
+    return delimiters.contains(ch);
+  }
+
+  /// Lazily splits `str` into tokens
+  auto tokenize(std::string_view str) const -> range {
+    return range(*this, str);
+  }
+
+  /// Splits `str` into a vector of tokens
+  auto split(std::string_view str) const -> std::vector<std::string_view> {
+    std::vector<std::string_view> tokens;
+    for (auto token : tokenize(str))
+      tokens.push_back(token);
+
+    return tokens;
+  }
+
+private:
+  /// Whether a byte is a delimiter (`kDelimiter`), opens a quote (`kQuote`),
+  /// or is plain text (0)
+  constexpr auto flags(char ch) const -> u8 {
+    return table[static_cast<u8>(ch)];
+  }
+
+  /// End of the text starting at `pos`: the next delimiter outside quotes
+  constexpr auto text_end(std::string_view str, usize pos) const -> usize {
+    while (pos < str.size()) {
+      u8 flag = flags(str[pos]);
+      if ((flag & kDelimiter) != 0)
+        return pos;
+
+      if ((flag & kQuote) != 0) {
+        usize close = str.find(str[pos], pos + 1);
+        if (close == std::string_view::npos)
+          return str.size();
+
+        pos = close;
+      }
+
+      pos++;
+    }
+
+    return pos;
+  }
+
+  constexpr auto delimiter_end(std::string_view str, usize pos) const
+      -> usize {
+    if (!merge_runs)
+      return pos + 1;
+
+    while (pos < str.size() && (flags(str[pos]) & kDelimiter) != 0)
+      pos++;
+
+    return pos;
+  }
+
+  constexpr auto text(std::string_view token) const -> std::string_view {
+    if (strip_quotes && token.size() >= 2 &&
+        (flags(token.front()) & kQuote) != 0 && token.back() == token.front() &&
+        token.find(token.front(), 1) == token.size() - 1)
+      return token.substr(1, token.size() - 2);
+
+    return token;
+  }
+
+  /// Finds the token starting the scan at `pos` (npos once the last token
+  /// was given out), returning where the scan for the one after starts; a
+  /// null `piece` means there are no more tokens
+  constexpr auto advance(std::string_view str, usize pos,
+                         std::string_view &piece) const -> usize {
+    piece = {};
+    if (pos == std::string_view::npos)
+      return pos;
+
+    if (keep_delimiters) {
+      if (pos >= str.size())
+        return pos;
+
+      usize end = (flags(str[pos]) & kDelimiter) != 0 ? delimiter_end(str, pos)
+                                                       : text_end(str, pos);
+      piece = str.substr(pos, end - pos);
+      if ((flags(str[pos]) & kDelimiter) == 0)
+        piece = text(piece);
+
+      return end;
+    }
+
+    if (merge_runs) {
+      pos = delimiter_end(str, pos);
+      if (pos >= str.size())
+        return std::string_view::npos;
+    } else if (str.empty()) {
+      return pos;
+    }
+
+    usize end = text_end(str, pos);
+    // keep a non-null view for empty tokens, null marks the end
+    piece = text(std::string_view(str.data() + pos, end - pos));
+    if (end >= str.size())
+      return std::string_view::npos;
+
+    return merge_runs ? end : end + 1;
+  }
+
+  std::array<u8, 256> table{};
+  bool keep_delimiters;
+  bool merge_runs;
+  bool strip_quotes;
+};
+
+template <CharSet... Classes> class Tokenizer<Classes...>::range {
+public:
+  auto begin() const -> iterator { return iterator(&tokenizer, str); }
+  auto end() const -> iterator { return iterator(); }
+
+private:
+  friend class Tokenizer;
+
+  range(const Tokenizer &owner, std::string_view source)
+      : tokenizer(owner), str(source) {}
+
+  Tokenizer tokenizer;
+  std::string_view str;
+};
+
 /// Replaces all occurrences of a substring in a string
-auto replace_all(const std::string &str, const std::string &from,
-                 const std::string &to) -> std::string;
+auto replace_all(std::string_view str, std::string_view from,
+                 std::string_view to) -> std::string;
+
+/// Applies many `(from, to)` replacement rules to a text in a single pass
+///
+/// The rules are compiled once into an Aho-Corasick automaton. Matches are
+/// found leftmost-longest and never overlap, so the result is the same as
+/// scanning the text left to right and replacing the longest rule that starts
+/// at each position. Rules with an empty `from` are ignored, and the first of
+/// several rules with the same `from` wins.
+class Replacer {
+public:
+  struct Rule {
+    std::string_view from;
+    std::string_view to;
+  };
+
+  Replacer() = default;
+  Replacer(std::initializer_list<Rule> rules);
+  explicit Replacer(std::span<const Rule> rules);
+
+  /// Returns a copy of `text` with every rule applied
+  auto replace(std::string_view text) const -> std::string;
+
+  /// Writes `text` with every rule applied into `out`, reusing its buffer
+  auto replace(std::string_view text, std::string &out) const -> void;
+
+  /// Number of rules the automaton was built from
+  auto size() const -> usize { return targets.size(); }
+
+  /// Returns true if there are no rules
+  auto empty() const -> bool { return targets.empty(); }
+
+private:
+  using state_type = u32;
+
+  static constexpr state_type none = ~state_type{0};
+
+  struct State {
+    state_type fail = 0;
+    /// Edges are `edge_bytes[first_edge, first_edge + edge_count)`
+    u32 first_edge = 0;
+    u32 edge_count = 0;
+    u32 depth = 0;
+    /// Longest rule that is a suffix of this state (or `none`)
+    u32 match = none;
+  };
+
+  struct Match {
+    usize start;
+    u32 rule;
+  };
+
+  auto build(std::span<const Rule> rules) -> void;
+  auto step(state_type state, u8 byte) const -> state_type;
+  auto find_all(std::string_view text, std::vector<Match> &out) const -> void;
+
+  std::vector<State> states;
+  std::vector<u8> edge_bytes;
+  std::vector<state_type> edge_targets;
+  std::vector<state_type> root_edges;
+
+  std::vector<u32> lengths;
+  std::vector<std::string> targets;
+};
+
+/// Finds which of many patterns is the longest prefix of a text
+///
+/// The patterns are compiled once into a path-compressed trie laid out flat
+/// in breadth-first order, so a lookup walks one node per branching point
+/// rather than comparing against every pattern. A pattern's ID is its index
+/// in the list the set was built from; of several equal patterns the first
+/// wins. An empty pattern is a prefix of every text.
+class PrefixSet {
+public:
+  struct Match {
+    usize id;
+    usize length;
+  };
+
+  PrefixSet() = default;
+  PrefixSet(std::initializer_list<std::string_view> patterns);
+  explicit PrefixSet(std::span<const std::string_view> patterns);
+  explicit PrefixSet(std::span<const std::string> patterns);
+
+  /// The longest pattern that `text` starts with, if any
+  auto longest(std::string_view text) const -> std::optional<Match>;
+
+  /// Returns true if `text` starts with any of the patterns
+  auto matches(std::string_view text) const -> bool {
+    return longest(text).has_value();
+  }
+
+  /// Number of patterns the set was built from
+  auto size() const -> usize { return count; }
+
+  /// Returns true if there are no patterns
+  auto empty() const -> bool { return count == 0; }
+
+private:
+  friend class SuffixSet;
+
+  static constexpr u32 none = ~u32{0};
+
+  struct Node {
+    /// The node's edge label is `labels[label, label + label_size)`
+    u32 label = 0;
+    u32 label_size = 0;
+    /// Children are `nodes[first_child, first_child + child_count)`, sorted
+    /// by the first byte of their labels (kept in `first_bytes`)
+    u32 first_child = 0;
+    u32 child_count = 0;
+    /// Pattern that ends at this node (or `none`)
+    u32 id = none;
+  };
+
+  auto build(std::span<const std::string_view> patterns) -> void;
+
+  /// Walks the trie over `text`, from its end backwards if `Reverse`
+  template <bool Reverse>
+  auto walk(std::string_view text) const -> std::optional<Match>;
+
+  std::vector<Node> nodes;
+  std::vector<u8> first_bytes;
+  std::string labels;
+  /// The root is visited by every lookup, so it gets a dense table (0 is no
+  /// child, the root is never one)
+  std::vector<u32> root_edges;
+  usize count = 0;
+};
+
+/// Finds which of many patterns is the longest suffix of a text
+///
+/// Built like `PrefixSet` from the reversed patterns, and walks the text
+/// from its end without copying it.
+class SuffixSet {
+public:
+  using Match = PrefixSet::Match;
+
+  SuffixSet() = default;
+  SuffixSet(std::initializer_list<std::string_view> patterns);
+  explicit SuffixSet(std::span<const std::string_view> patterns);
+  explicit SuffixSet(std::span<const std::string> patterns);
+
+  /// The longest pattern that `text` ends with, if any
+  auto longest(std::string_view text) const -> std::optional<Match>;
+
+  /// Returns true if `text` ends with any of the patterns
+  auto matches(std::string_view text) const -> bool {
+    return longest(text).has_value();
+  }
+
+  /// Number of patterns the set was built from
+  auto size() const -> usize { return reversed.size(); }
+
+  /// Returns true if there are no patterns
+  auto empty() const -> bool { return reversed.empty(); }
+
+private:
+  PrefixSet reversed;
+};
 
 /// Joins a vector of strings into a single string
-auto join(const std::vector<std::string> &strs, const std::string &delim = "")
+auto join(const std::vector<std::string> &strs, std::string_view delim = "")
     -> std::string;
 
+/// Incrementally builds a string out of many pieces
+///
+/// Appends go into chunks that are never moved once written, so growing a
+/// multi-MB string costs no reallocation copies; the chunks are only
+/// concatenated once, when the result is taken or viewed. `clear()` keeps the
+/// chunks around so one builder can be reused across many strings.
+class Builder {
+public:
+  Builder() = default;
+  explicit Builder(usize capacity) { reserve(capacity); }
+
+  Builder(Builder &&other) noexcept;
+  auto operator=(Builder &&other) noexcept -> Builder &;
+
+  auto append(std::string_view str) -> Builder &;
+  auto append(char ch) -> Builder &;
+
+  auto operator<<(std::string_view str) -> Builder & { return append(str); }
+  auto operator<<(char ch) -> Builder & { return append(ch); }
+
+  /// Appends every part of `parts` separated by `delim`, sizing the space for
+  /// them up front
+  template <std::ranges::forward_range Range>
+    requires concepts::StringViewConvertible<std::ranges::range_value_t<Range>>
+  auto join(const Range &parts, std::string_view delim = "") -> Builder & {
+    usize total = 0;
+    usize count = 0;
+    for (const auto &part : parts) {
+      total += std::string_view(part).size();
+      count++;
+    }
+
+    if (count == 0)
+      return *this;
+
+    reserve(total + delim.size() * (count - 1));
+    bool first = true;
+    for (const auto &part : parts) {
+      if (!first)
+        append(delim);
+
+      append(std::string_view(part));
+      first = false;
+    }
+
+    return *this;
+  }
+
+  /// Makes sure the next `size` bytes are appended without allocating
+  auto reserve(usize size) -> void;
+
+  /// Contents of the builder, concatenating chunks if needed
+  auto view() -> std::string_view;
+
+  /// Copies the contents into a string
+  auto str() const -> std::string;
+
+  /// Copies the contents into a string and clears the builder
+  auto take() -> std::string;
+
+  /// Empties the builder, keeping its memory for reuse
+  auto clear() -> void;
+
+  /// Number of bytes appended
+  auto size() const -> usize { return length; }
+
+  /// Returns true if nothing was appended
+  auto empty() const -> bool { return length == 0; }
+
+  /// Number of bytes the builder can hold without allocating
+  auto capacity() const -> usize;
+
+private:
+  struct Chunk {
+    std::unique_ptr<char[]> data;
+    usize size = 0;
+    usize capacity = 0;
+  };
+
+  /// Smallest and largest chunk the builder allocates on its own
+  static constexpr usize kMinChunk = 256;
+  static constexpr usize kMaxChunk = usize{1} << 20;
+
+  /// Moves to (or allocates) a chunk with `size` free bytes
+  auto next_chunk(usize size) -> Chunk &;
+
+  std::vector<Chunk> chunks;
+  usize current = 0;
+  usize length = 0;
+};
+
+/// A string for large texts with O(log n) insert and erase
+///
+/// Text is held in leaves of up to `kLeafSize` bytes, kept in a balanced tree
+/// (a treap keyed by position), so an edit only touches the leaves and tree
+/// nodes along one path instead of shifting the whole text.
+class Rope {
+public:
+  /// Largest leaf a single insert creates
+  static constexpr usize kLeafSize = 1024;
+
+  Rope() = default;
+  explicit Rope(std::string_view text) { append(text); }
+
+  /// Inserts `text` before position `pos` (clamped to the size)
+  auto insert(usize pos, std::string_view text) -> void;
+
+  /// Erases up to `count` bytes starting at `pos`
+  auto erase(usize pos, usize count) -> void;
+
+  /// Inserts `text` at the end
+  auto append(std::string_view text) -> void { insert(size(), text); }
+
+  /// Returns the byte at `pos` (which must be in range)
+  auto at(usize pos) const -> char;
+
+  /// Copies up to `count` bytes starting at `pos`
+  auto substr(usize pos, usize count = std::string_view::npos) const
+      -> std::string;
+
+  /// Calls `fn` with every leaf of the text, in order
+  auto for_each_chunk(const std::function<void(std::string_view)> &fn) const
+      -> void;
+
+  /// Copies the whole text into a string
+  auto to_string() const -> std::string;
+
+  /// Removes all text
+  auto clear() -> void;
+
+  /// Number of bytes in the rope
+  auto size() const -> usize { return length(root); }
+
+  /// Returns true if the rope holds no text
+  auto empty() const -> bool { return root == none; }
+
+private:
+  using node_type = u32;
+
+  static constexpr node_type none = ~node_type{0};
+
+  struct Node {
+    std::string text;
+    node_type left = none;
+    node_type right = none;
+    u32 priority = 0;
+    /// Bytes in this subtree
+    usize length = 0;
+  };
+
+  auto length(node_type node) const -> usize {
+    return node == none ? 0 : nodes[node].length;
+  }
+
+  auto make_node(std::string_view text, u32 priority) -> node_type;
+  auto update(node_type node) -> void;
+  auto merge(node_type left, node_type right) -> node_type;
+  auto split(node_type node, usize pos) -> std::pair<node_type, node_type>;
+  auto release(node_type node) -> void;
+  auto visit(node_type node, usize pos, usize count,
+             const std::function<void(std::string_view)> &fn) const -> void;
+  auto next_priority() -> u32;
+
+  std::vector<Node> nodes;
+  std::vector<node_type> free_nodes;
+  node_type root = none;
+  u64 seed = 0;
+};
+
+/// Fast non-cryptographic hash of a string (wyhash), for tables whose keys
+/// are trusted
+inline auto hash(std::string_view str, u64 seed = 0) -> u64 {
+  return manifold::hash::wyhash(str, seed);
+}
+
+/// Transparent string hash: containers keyed by `std::string` can then be
+/// searched with a `std::string_view` or `const char *` without building a
+/// key string
+struct Hash {
+  using is_transparent = void;
+
+  auto operator()(std::string_view str) const noexcept -> usize {
+    return manifold::str::hash(str);
+  }
+};
+
+/// Transparent keyed hash (SipHash-1-3) for tables fed keys from outside
+///
+/// The key is random per process unless one is given, so inputs that all
+/// land in one bucket cannot be computed ahead of time (HashDoS).
+class SeededHash {
+public:
+  using is_transparent = void;
+
+  SeededHash();
+  SeededHash(u64 key0, u64 key1) : key{key0, key1} {}
+
+  auto operator()(std::string_view str) const noexcept -> usize {
+    return manifold::hash::siphash13(str, key[0], key[1]);
+  }
+
+private:
+  std::array<u64, 2> key;
+};
+
+/// Transparent string equality, to pair with `Hash` or `SeededHash`
+struct Equal {
+  using is_transparent = void;
+
+  auto operator()(std::string_view a, std::string_view b) const noexcept
+      -> bool {
+    return a == b;
+  }
+};
+
+/// `std::unordered_map` keyed by strings, searchable by any string type
+template <typename T, typename H = Hash>
+using HashMap = std::unordered_map<std::string, T, H, Equal>;
+
+/// `std::unordered_set` of strings, searchable by any string type
+template <typename H = Hash>
+using HashSet = std::unordered_set<std::string, H, Equal>;
+
+/// Maps strings to dense ids and back, storing each distinct string once
+///
+/// Strings are copied into append-only arenas, so the views handed out stay
+/// valid for the lifetime of the interner. Inserts lock one of `kShards`
+/// shards (picked by hash); `find` and `view` never lock.
+class Interner {
+public:
+  using id_type = u32;
+
+  /// Number of independently locked shards
+  static constexpr usize kShards = 64;
+
+  Interner();
+  ~Interner();
+
+  Interner(const Interner &) = delete;
+  auto operator=(const Interner &) -> Interner & = delete;
+
+  /// Returns the id of `str`, adding it if it wasn't interned yet
+  auto intern(std::string_view str) -> id_type;
+
+  /// Returns the id of `str` if it was interned
+  auto find(std::string_view str) const -> std::optional<id_type>;
+
+  /// Returns true if `str` was interned
+  auto contains(std::string_view str) const -> bool {
+    return find(str).has_value();
+  }
+
+  /// Returns the string for an id handed out by `intern`
+  auto view(id_type id) const -> std::string_view;
+
+  auto operator[](id_type id) const -> std::string_view { return view(id); }
+
+  /// Number of distinct strings interned
+  auto size() const -> usize { return next_id.load(std::memory_order_acquire); }
+
+  /// Returns true if nothing was interned
+  auto empty() const -> bool { return size() == 0; }
+
+private:
+  struct Shard;
+
+  struct Entry {
+    const char *data;
+    usize size;
+  };
+
+  /// Ids are split into segments of doubling size, `kFirstSegment` first
+  static constexpr usize kFirstSegment = 1024;
+  static constexpr usize kSegments = 32;
+
+  auto lookup(const Shard &shard, std::string_view str, u64 hash) const
+      -> std::optional<id_type>;
+  auto entry(id_type id) const -> Entry &;
+
+  std::unique_ptr<Shard[]> shards;
+  std::unique_ptr<std::atomic<Entry *>[]> segments;
+  std::atomic<id_type> next_id = 0;
+};
+
+/// A string of up to `N` bytes stored inline, with no heap allocation
+///
+/// Trivially copyable and usable wherever a `std::string_view` is expected;
+/// meant for short keys and tags that outgrow `std::string`'s SSO buffer.
+template <usize N> class InlineString {
+  static_assert(N > 0 && N <= 255, "the length is stored in one byte");
+
+public:
+  using value_type = char;
+  using size_type = usize;
+  using const_iterator = const char *;
+  using iterator = const_iterator;
+
+  static constexpr usize npos = std::string_view::npos;
+
+  constexpr InlineString() = default;
+
+  /// Copies `str`, which has to fit in `N` bytes
+  ///
+  /// A longer string aborts rather than quietly becoming its first `N`
+  /// bytes, which as a map key would alias every key sharing that prefix.
+  /// Use `from` when the length is not known to fit, or `truncate` to cut a
+  /// string short on purpose.
+  explicit constexpr InlineString(std::string_view str) {
+    if (!fits(str))
+      std::abort();
+
+    assign(str);
+  }
+
+  explicit constexpr InlineString(const char *str)
+      : InlineString(std::string_view(str)) {}
+
+  /// Copies `str` if it fits
+  static constexpr auto from(std::string_view str)
+      -> std::optional<InlineString> {
+    if (!fits(str))
+      return std::nullopt;
+
+    return InlineString(str);
+  }
+
+  /// Copies the first `N` bytes of `str`
+  static constexpr auto truncate(std::string_view str) -> InlineString {
+    return InlineString(str.substr(0, N));
+  }
+
+  /// Returns true if `str` fits in `N` bytes
+  static constexpr auto fits(std::string_view str) -> bool {
+    return str.size() <= N;
+  }
+
+  /// Replaces the contents with `str` if it fits, returns false (and leaves
+  /// the string alone) otherwise
+  constexpr auto assign(std::string_view str) -> bool {
+    if (!fits(str))
+      return false;
+
+    count = static_cast<u8>(str.size());
+    std::copy_n(str.data(), count, chars);
+    return true;
+  }
+
+  /// Appends `str` if it fits, returns false (and leaves the string alone)
+  /// otherwise
+  constexpr auto append(std::string_view str) -> bool {
+    if (str.size() > N - count)
+      return false;
+
+    std::copy_n(str.data(), str.size(), chars + count);
+    count = static_cast<u8>(count + str.size());
+    return true;
+  }
+
+  constexpr auto push_back(char ch) -> bool {
+    return append(std::string_view(&ch, 1));
+  }
+
+  constexpr auto clear() -> void { count = 0; }
+
+  constexpr auto data() const -> const char * { return chars; }
+  constexpr auto size() const -> usize { return count; }
+  constexpr auto length() const -> usize { return count; }
+  constexpr auto empty() const -> bool { return count == 0; }
+  static constexpr auto capacity() -> usize { return N; }
+  static constexpr auto max_size() -> usize { return N; }
+
+  constexpr auto begin() const -> const_iterator { return chars; }
+  constexpr auto end() const -> const_iterator { return chars + count; }
+
+  constexpr auto operator[](usize pos) const -> char { return chars[pos]; }
+  constexpr auto front() const -> char { return chars[0]; }
+  constexpr auto back() const -> char { return chars[count - 1]; }
+
+  constexpr auto view() const -> std::string_view {
+    return std::string_view(chars, count);
+  }
+  constexpr operator std::string_view() const { return view(); }
+
+  constexpr auto substr(usize pos, usize len = npos) const
+      -> std::string_view {
+    return view().substr(pos, len);
+  }
+
+  constexpr auto find(std::string_view str, usize pos = 0) const -> usize {
+    return view().find(str, pos);
+  }
+  constexpr auto find(char ch, usize pos = 0) const -> usize {
+    return view().find(ch, pos);
+  }
+  constexpr auto rfind(std::string_view str, usize pos = npos) const
+      -> usize {
+    return view().rfind(str, pos);
+  }
+
+  constexpr auto starts_with(std::string_view str) const -> bool {
+    return view().starts_with(str);
+  }
+  constexpr auto ends_with(std::string_view str) const -> bool {
+    return view().ends_with(str);
+  }
+
+  constexpr auto compare(std::string_view str) const -> int {
+    return view().compare(str);
+  }
+
+  friend constexpr auto operator==(const InlineString &lhs,
+                                   std::string_view rhs) -> bool {
+    return lhs.view() == rhs;
+  }
+  friend constexpr auto operator<=>(const InlineString &lhs,
+                                    std::string_view rhs)
+      -> std::strong_ordering {
+    return lhs.view() <=> rhs;
+  }
+
+private:
+  char chars[N] = {};
+  u8 count = 0;
+};
+
+/// Converts ASCII letters in a string to lowercase
+auto to_lower(std::string_view str) -> std::string;
+
+/// Converts a string to lowercase, reusing its buffer
+auto to_lower(std::string &&str) -> std::string;
+
 /// Converts a string to lowercase
-auto to_lower(const std::string &str) -> std::string;
+inline auto to_lower(const char *str) -> std::string {
+  return to_lower(std::string_view(str));
+}
+
+/// Converts ASCII letters in a buffer to lowercase
+auto to_lower_in_place(std::span<char> str) -> void;
+
+/// Writes the lowercase form of a string into `out`, returning the number of
+/// bytes written (at most `out.size()`)
+auto to_lower(std::string_view str, std::span<char> out) -> usize;
+
+/// Converts ASCII letters in a string to uppercase
+auto to_upper(std::string_view str) -> std::string;
+
+/// Converts a string to uppercase, reusing its buffer
+auto to_upper(std::string &&str) -> std::string;
 
 /// Converts a string to uppercase
-auto to_upper(const std::string &str) -> std::string;
+inline auto to_upper(const char *str) -> std::string {
+  return to_upper(std::string_view(str));
+}
+
+/// Converts ASCII letters in a buffer to uppercase
+auto to_upper_in_place(std::span<char> str) -> void;
+
+/// Writes the uppercase form of a string into `out`, returning the number of
+/// bytes written (at most `out.size()`)
+auto to_upper(std::string_view str, std::span<char> out) -> usize;
+
+/// Folds the case of a UTF-8 string for caseless comparison (full Unicode case
+/// folding, e.g. "Straße" and "STRASSE" both fold to "strasse"); invalid
+/// bytes are copied through unchanged
+auto fold_case(std::string_view str) -> std::string;
+
+/// Checks if two strings are equal ignoring ASCII case, folding both on the
+/// fly rather than copying them
+auto iequals(std::string_view a, std::string_view b) -> bool;
+
+/// Compares two strings as if ASCII letters were all lowercase
+auto icompare(std::string_view a, std::string_view b) -> std::strong_ordering;
+
+/// Hash of a string with ASCII letters folded to lowercase, so strings that
+/// are `iequals` hash the same
+auto ihash(std::string_view str, u64 seed = 0) -> u64;
+
+/// Finds the first `needle` in `haystack` at or after `pos` ignoring ASCII
+/// case, or `npos`
+auto ifind(std::string_view haystack, std::string_view needle, usize pos = 0)
+    -> usize;
+
+/// Transparent string hash ignoring ASCII case, to pair with `IEqual`
+struct IHash {
+  using is_transparent = void;
+
+  auto operator()(std::string_view str) const noexcept -> usize {
+    return manifold::str::ihash(str);
+  }
+};
+
+/// Transparent string equality ignoring ASCII case
+struct IEqual {
+  using is_transparent = void;
+
+  auto operator()(std::string_view a, std::string_view b) const noexcept
+      -> bool {
+    return manifold::str::iequals(a, b);
+  }
+};
+
+/// `std::unordered_map` keyed by strings that ignores ASCII case, e.g. for
+/// header names
+template <typename T>
+using IHashMap = std::unordered_map<std::string, T, IHash, IEqual>;
+
+/// Trims whitespace from the beginning and end of a string, without copying
+auto trim_view(std::string_view str) -> std::string_view;
 
 /// Trims whitespace from the beginning and end of a string
-auto trim(const std::string &str) -> std::string;
+auto trim(std::string_view str) -> std::string;
+
+/// Trims whitespace from the beginning and end of a string, reusing its buffer
+auto trim(std::string &&str) -> std::string;
+
+/// Trims whitespace from the beginning and end of a string
+inline auto trim(const char *str) -> std::string {
+  return trim(std::string_view(str));
+}
+
+/// Owns NUL-terminated copies of strings, e.g. to hand to C APIs
+///
+/// Copies are bump-allocated out of a few large blocks and live until the
+/// arena is cleared or destroyed. `argv` and `envp` put a whole batch (the
+/// pointer array and every string) into one contiguous allocation, and
+/// `clear()` keeps the largest block, so an arena that is reused across
+/// calls stops allocating once it has seen its biggest batch.
+class CStringArena {
+public:
+  CStringArena() = default;
+  explicit CStringArena(usize capacity) { reserve(capacity); }
+
+  CStringArena(CStringArena &&other) noexcept;
+  auto operator=(CStringArena &&other) noexcept -> CStringArena &;
+
+  /// Copies `str` and returns the NUL-terminated copy
+  auto add(std::string_view str) -> const char *;
+
+  /// Copies `strings` into a NULL-terminated array of C strings, ready for
+  /// `execv` and friends
+  template <std::ranges::forward_range Range>
+    requires concepts::StringViewConvertible<std::ranges::range_value_t<Range>>
+  auto argv(const Range &strings) -> char *const * {
+    usize count = 0;
+    usize bytes = 0;
+    for (const auto &str : strings) {
+      bytes += std::string_view(str).size() + 1;
+      count++;
+    }
+
+    auto **pointers = allocate_batch(count, bytes);
+    char *at = reinterpret_cast<char *>(pointers + count + 1);
+    for (const auto &str : strings)
+      *pointers++ = copy(at, std::string_view(str));
 
-/// Converts a string to a C-style string **by copying it**
-auto as_cstr(const std::string &str) -> const i8 *;
+    *pointers = nullptr;
+    return pointers - count;
+  }
+
+  /// Copies `(key, value)` pairs (e.g. a map) into a NULL-terminated array of
+  /// `KEY=VALUE` C strings, ready for `execve` and friends
+  template <std::ranges::forward_range Range>
+  auto envp(const Range &vars) -> char *const * {
+    usize count = 0;
+    usize bytes = 0;
+    for (const auto &[key, value] : vars) {
+      bytes += std::string_view(key).size() + 1;
+      bytes += std::string_view(value).size() + 1;
+      count++;
+    }
+
+    auto **pointers = allocate_batch(count, bytes);
+    char *at = reinterpret_cast<char *>(pointers + count + 1);
+    for (const auto &[key, value] : vars) {
+      std::string_view name = key;
+      *pointers++ = at;
+      at = std::copy_n(name.data(), name.size(), at);
+      *at++ = '=';
+      copy(at, std::string_view(value));
+    }
+
+    *pointers = nullptr;
+    return pointers - count;
+  }
+
+  /// Makes sure the next `size` bytes are allocated without a new block
+  auto reserve(usize size) -> void;
+
+  /// Invalidates every string handed out, keeping the largest block for reuse
+  auto clear() -> void;
+
+  /// Number of bytes the arena holds across its blocks
+  auto capacity() const -> usize;
+
+private:
+  /// Smallest block the arena allocates on its own
+  static constexpr usize kMinBlock = 4096;
+
+  struct Block {
+    std::unique_ptr<char[]> data;
+    usize size = 0;
+  };
+
+  /// Room for `count + 1` pointers followed by `bytes` of strings
+  auto allocate_batch(usize count, usize bytes) -> char **;
+  auto allocate(usize size) -> char *;
+
+  /// Writes `str` and its terminator at `at`, moving `at` past them
+  static auto copy(char *&at, std::string_view str) -> char * {
+    char *start = at;
+    at = std::copy_n(str.data(), str.size(), at);
+    *at++ = '\0';
+    return start;
+  }
+
+  std::vector<Block> blocks;
+  char *cursor = nullptr;
+  usize remaining = 0;
+};
+
+/// Why `parse` rejected its input
+enum class ParseError { Empty, Invalid, OutOfRange };
+
+/// Parses all of `str` as a number of type `T`
+///
+/// Takes an optional sign (no '-' for unsigned types), no whitespace and no
+/// trailing bytes. Integers are read eight digits at a time; floats accept
+/// what `std::from_chars` does, in decimal or scientific form. Available for
+/// every integer type other than `char` and `bool`, `float` and `double`.
+template <typename T>
+auto parse(std::string_view str) -> manifold::result<T, ParseError>;
+
+/// Enough room for `format_int` or `format_float` with any value
+inline constexpr usize kMaxNumberChars = 24;
+
+/// Writes `value` in decimal into `out`, returning the number of bytes
+/// written, or 0 (leaving `out` untouched) if it does not fit. Available for
+/// the same integer types as `parse`
+template <typename T> auto format_int(T value, std::span<char> out) -> usize;
+
+/// Writes the shortest representation of `value` that parses back to the same
+/// value into `out`, returning the number of bytes written, or 0 if it does
+/// not fit. Available for `float` and `double`
+template <typename T>
+auto format_float(T value, std::span<char> out) -> usize;
+
+/// Edit distance between `a` and `b`: the fewest single byte insertions,
+/// deletions and substitutions turning one into the other
+///
+/// Computed with Myers' bit-parallel algorithm, 64 bytes of the shorter
+/// string per machine word, in O(ceil(m / 64) * n) time
+auto levenshtein(std::string_view a, std::string_view b) -> usize;
+
+/// Like `levenshtein`, but swapping two adjacent bytes is also one edit
+/// (optimal string alignment, so no substring is edited twice)
+auto damerau(std::string_view a, std::string_view b) -> usize;
+
+/// True if `levenshtein(a, b) <= max`, giving up as soon as the remaining
+/// bytes cannot bring the distance back under `max`
+auto within_distance(std::string_view a, std::string_view b, usize max)
+    -> bool;
+
+/// Writes the edit distance from `query` to each of `candidates` into `out`
+/// (at least as large as `candidates`)
+///
+/// The query's match masks are built once for the batch and, for queries of
+/// up to 64 bytes on AVX2, four candidates are advanced per instruction.
+auto levenshtein(std::string_view query,
+                 std::span<const std::string_view> candidates,
+                 std::span<usize> out) -> void;
+
+/// Index of the candidate nearest to `query` and at most `max` edits away
+/// (the first one on ties), or `npos`, for did-you-mean suggestions
+auto closest(std::string_view query,
+             std::span<const std::string_view> candidates, usize max)
+    -> usize;
+
+/// Scores `pattern` as a subsequence of `text`, fzf style, or nullopt if it
+/// is not one
+///
+/// Matches are case-insensitive unless the pattern has an uppercase letter.
+/// Each matched byte scores, more so at the start of a word, after a
+/// separator or case change, or right after the previous match; gaps cost.
+/// The shortest window ending at the first complete match is scored.
+auto fuzzy_score(std::string_view pattern, std::string_view text)
+    -> std::optional<i32>;
+
+/// A candidate matched by `fuzzy_search`
+struct FuzzyMatch {
+  usize index;
+  i32 score;
+};
+
+/// Candidates matching `pattern`, best first and at most `limit` of them;
+/// equal scores rank the shorter candidate, then the earlier one, first
+auto fuzzy_search(std::string_view pattern,
+                  std::span<const std::string_view> candidates,
+                  usize limit = std::string_view::npos)
+    -> std::vector<FuzzyMatch>;
+
+namespace utf8 {
+
+/// Position of the first byte of the sequence that makes a string invalid
+struct Error {
+  usize offset;
+};
+
+/// Returns true if `str` is valid UTF-8 (no overlong forms, surrogates or
+/// code points past U+10FFFF)
+auto validate(std::string_view str) -> bool;
+
+/// Offset of the first invalid sequence in `str`, or `npos` if it is valid
+auto find_invalid(std::string_view str) -> usize;
+
+/// Number of code points in valid UTF-8
+auto count_codepoints(std::string_view str) -> usize;
+
+/// Converts UTF-8 to UTF-16 (with surrogate pairs past U+FFFF)
+auto to_utf16(std::string_view str) -> manifold::result<std::u16string, Error>;
+
+/// Converts UTF-8 to UTF-32
+auto to_utf32(std::string_view str) -> manifold::result<std::u32string, Error>;
+
+} // namespace utf8
 
 } // namespace manifold::str
 
+template <usize N> struct std::hash<manifold::str::InlineString<N>> {
+  auto operator()(const manifold::str::InlineString<N> &str) const noexcept
+      -> std::size_t {
+    return std::hash<std::string_view>{}(str.view());
+  }
+};
+
 #endif
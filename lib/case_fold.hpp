@@ -0,0 +1,332 @@
+#ifndef Manifold_CaseFold_hpp
+#define Manifold_CaseFold_hpp
+
+#include <manifold/_defines.hpp>
+
+// Unicode 14.0 full case folding (CaseFolding.txt, statuses C and F).
+// Generated, don't edit by hand.
+
+namespace manifold::internal {
+
+/// `count` code points from `first`, every `stride`th one, fold to `cp + delta`
+struct FoldRange {
+  u32 first;
+  u16 count;
+  u8 stride;
+  i32 delta;
+};
+
+/// Code points that fold to more than one code point (unused slots are 0)
+struct FoldExpansion {
+  u32 cp;
+  u32 folded[3];
+};
+
+inline constexpr FoldRange kFoldRanges[] = {
+    {0x0041, 26, 1, 32},
+    {0x00b5, 1, 1, 775},
+    {0x00c0, 23, 1, 32},
+    {0x00d8, 7, 1, 32},
+    {0x0100, 24, 2, 1},
+    {0x0132, 3, 2, 1},
+    {0x0139, 8, 2, 1},
+    {0x014a, 23, 2, 1},
+    {0x0178, 1, 1, -121},
+    {0x0179, 3, 2, 1},
+    {0x017f, 1, 1, -268},
+    {0x0181, 1, 1, 210},
+    {0x0182, 2, 2, 1},
+    {0x0186, 1, 1, 206},
+    {0x0187, 1, 1, 1},
+    {0x0189, 2, 1, 205},
+    {0x018b, 1, 1, 1},
+    {0x018e, 1, 1, 79},
+    {0x018f, 1, 1, 202},
+    {0x0190, 1, 1, 203},
+    {0x0191, 1, 1, 1},
+    {0x0193, 1, 1, 205},
+    {0x0194, 1, 1, 207},
+    {0x0196, 1, 1, 211},
+    {0x0197, 1, 1, 209},
+    {0x0198, 1, 1, 1},
+    {0x019c, 1, 1, 211},
+    {0x019d, 1, 1, 213},
+    {0x019f, 1, 1, 214},
+    {0x01a0, 3, 2, 1},
+    {0x01a6, 1, 1, 218},
+    {0x01a7, 1, 1, 1},
+    {0x01a9, 1, 1, 218},
+    {0x01ac, 1, 1, 1},
+    {0x01ae, 1, 1, 218},
+    {0x01af, 1, 1, 1},
+    {0x01b1, 2, 1, 217},
+    {0x01b3, 2, 2, 1},
+    {0x01b7, 1, 1, 219},
+    {0x01b8, 1, 1, 1},
+    {0x01bc, 1, 1, 1},
+    {0x01c4, 1, 1, 2},
+    {0x01c5, 1, 1, 1},
+    {0x01c7, 1, 1, 2},
+    {0x01c8, 1, 1, 1},
+    {0x01ca, 1, 1, 2},
+    {0x01cb, 9, 2, 1},
+    {0x01de, 9, 2, 1},
+    {0x01f1, 1, 1, 2},
+    {0x01f2, 2, 2, 1},
+    {0x01f6, 1, 1, -97},
+    {0x01f7, 1, 1, -56},
+    {0x01f8, 20, 2, 1},
+    {0x0220, 1, 1, -130},
+    {0x0222, 9, 2, 1},
+    {0x023a, 1, 1, 10795},
+    {0x023b, 1, 1, 1},
+    {0x023d, 1, 1, -163},
+    {0x023e, 1, 1, 10792},
+    {0x0241, 1, 1, 1},
+    {0x0243, 1, 1, -195},
+    {0x0244, 1, 1, 69},
+    {0x0245, 1, 1, 71},
+    {0x0246, 5, 2, 1},
+    {0x0345, 1, 1, 116},
+    {0x0370, 2, 2, 1},
+    {0x0376, 1, 1, 1},
+    {0x037f, 1, 1, 116},
+    {0x0386, 1, 1, 38},
+    {0x0388, 3, 1, 37},
+    {0x038c, 1, 1, 64},
+    {0x038e, 2, 1, 63},
+    {0x0391, 17, 1, 32},
+    {0x03a3, 9, 1, 32},
+    {0x03c2, 1, 1, 1},
+    {0x03cf, 1, 1, 8},
+    {0x03d0, 1, 1, -30},
+    {0x03d1, 1, 1, -25},
+    {0x03d5, 1, 1, -15},
+    {0x03d6, 1, 1, -22},
+    {0x03d8, 12, 2, 1},
+    {0x03f0, 1, 1, -54},
+    {0x03f1, 1, 1, -48},
+    {0x03f4, 1, 1, -60},
+    {0x03f5, 1, 1, -64},
+    {0x03f7, 1, 1, 1},
+    {0x03f9, 1, 1, -7},
+    {0x03fa, 1, 1, 1},
+    {0x03fd, 3, 1, -130},
+    {0x0400, 16, 1, 80},
+    {0x0410, 32, 1, 32},
+    {0x0460, 17, 2, 1},
+    {0x048a, 27, 2, 1},
+    {0x04c0, 1, 1, 15},
+    {0x04c1, 7, 2, 1},
+    {0x04d0, 48, 2, 1},
+    {0x0531, 38, 1, 48},
+    {0x10a0, 38, 1, 7264},
+    {0x10c7, 1, 1, 7264},
+    {0x10cd, 1, 1, 7264},
+    {0x13f8, 6, 1, -8},
+    {0x1c80, 1, 1, -6222},
+    {0x1c81, 1, 1, -6221},
+    {0x1c82, 1, 1, -6212},
+    {0x1c83, 2, 1, -6210},
+    {0x1c85, 1, 1, -6211},
+    {0x1c86, 1, 1, -6204},
+    {0x1c87, 1, 1, -6180},
+    {0x1c88, 1, 1, 35267},
+    {0x1c90, 43, 1, -3008},
+    {0x1cbd, 3, 1, -3008},
+    {0x1e00, 75, 2, 1},
+    {0x1e9b, 1, 1, -58},
+    {0x1ea0, 48, 2, 1},
+    {0x1f08, 8, 1, -8},
+    {0x1f18, 6, 1, -8},
+    {0x1f28, 8, 1, -8},
+    {0x1f38, 8, 1, -8},
+    {0x1f48, 6, 1, -8},
+    {0x1f59, 4, 2, -8},
+    {0x1f68, 8, 1, -8},
+    {0x1fb8, 2, 1, -8},
+    {0x1fba, 2, 1, -74},
+    {0x1fbe, 1, 1, -7173},
+    {0x1fc8, 4, 1, -86},
+    {0x1fd8, 2, 1, -8},
+    {0x1fda, 2, 1, -100},
+    {0x1fe8, 2, 1, -8},
+    {0x1fea, 2, 1, -112},
+    {0x1fec, 1, 1, -7},
+    {0x1ff8, 2, 1, -128},
+    {0x1ffa, 2, 1, -126},
+    {0x2126, 1, 1, -7517},
+    {0x212a, 1, 1, -8383},
+    {0x212b, 1, 1, -8262},
+    {0x2132, 1, 1, 28},
+    {0x2160, 16, 1, 16},
+    {0x2183, 1, 1, 1},
+    {0x24b6, 26, 1, 26},
+    {0x2c00, 48, 1, 48},
+    {0x2c60, 1, 1, 1},
+    {0x2c62, 1, 1, -10743},
+    {0x2c63, 1, 1, -3814},
+    {0x2c64, 1, 1, -10727},
+    {0x2c67, 3, 2, 1},
+    {0x2c6d, 1, 1, -10780},
+    {0x2c6e, 1, 1, -10749},
+    {0x2c6f, 1, 1, -10783},
+    {0x2c70, 1, 1, -10782},
+    {0x2c72, 1, 1, 1},
+    {0x2c75, 1, 1, 1},
+    {0x2c7e, 2, 1, -10815},
+    {0x2c80, 50, 2, 1},
+    {0x2ceb, 2, 2, 1},
+    {0x2cf2, 1, 1, 1},
+    {0xa640, 23, 2, 1},
+    {0xa680, 14, 2, 1},
+    {0xa722, 7, 2, 1},
+    {0xa732, 31, 2, 1},
+    {0xa779, 2, 2, 1},
+    {0xa77d, 1, 1, -35332},
+    {0xa77e, 5, 2, 1},
+    {0xa78b, 1, 1, 1},
+    {0xa78d, 1, 1, -42280},
+    {0xa790, 2, 2, 1},
+    {0xa796, 10, 2, 1},
+    {0xa7aa, 1, 1, -42308},
+    {0xa7ab, 1, 1, -42319},
+    {0xa7ac, 1, 1, -42315},
+    {0xa7ad, 1, 1, -42305},
+    {0xa7ae, 1, 1, -42308},
+    {0xa7b0, 1, 1, -42258},
+    {0xa7b1, 1, 1, -42282},
+    {0xa7b2, 1, 1, -42261},
+    {0xa7b3, 1, 1, 928},
+    {0xa7b4, 8, 2, 1},
+    {0xa7c4, 1, 1, -48},
+    {0xa7c5, 1, 1, -42307},
+    {0xa7c6, 1, 1, -35384},
+    {0xa7c7, 2, 2, 1},
+    {0xa7d0, 1, 1, 1},
+    {0xa7d6, 2, 2, 1},
+    {0xa7f5, 1, 1, 1},
+    {0xab70, 80, 1, -38864},
+    {0xff21, 26, 1, 32},
+    {0x10400, 40, 1, 40},
+    {0x104b0, 36, 1, 40},
+    {0x10570, 11, 1, 39},
+    {0x1057c, 15, 1, 39},
+    {0x1058c, 7, 1, 39},
+    {0x10594, 2, 1, 39},
+    {0x10c80, 51, 1, 64},
+    {0x118a0, 32, 1, 32},
+    {0x16e40, 32, 1, 32},
+    {0x1e900, 34, 1, 34},
+};
+
+inline constexpr FoldExpansion kFoldExpansions[] = {
+    {0x00df, {0x0073, 0x0073, 0x0000}},
+    {0x0130, {0x0069, 0x0307, 0x0000}},
+    {0x0149, {0x02bc, 0x006e, 0x0000}},
+    {0x01f0, {0x006a, 0x030c, 0x0000}},
+    {0x0390, {0x03b9, 0x0308, 0x0301}},
+    {0x03b0, {0x03c5, 0x0308, 0x0301}},
+    {0x0587, {0x0565, 0x0582, 0x0000}},
+    {0x1e96, {0x0068, 0x0331, 0x0000}},
+    {0x1e97, {0x0074, 0x0308, 0x0000}},
+    {0x1e98, {0x0077, 0x030a, 0x0000}},
+    {0x1e99, {0x0079, 0x030a, 0x0000}},
+    {0x1e9a, {0x0061, 0x02be, 0x0000}},
+    {0x1e9e, {0x0073, 0x0073, 0x0000}},
+    {0x1f50, {0x03c5, 0x0313, 0x0000}},
+    {0x1f52, {0x03c5, 0x0313, 0x0300}},
+    {0x1f54, {0x03c5, 0x0313, 0x0301}},
+    {0x1f56, {0x03c5, 0x0313, 0x0342}},
+    {0x1f80, {0x1f00, 0x03b9, 0x0000}},
+    {0x1f81, {0x1f01, 0x03b9, 0x0000}},
+    {0x1f82, {0x1f02, 0x03b9, 0x0000}},
+    {0x1f83, {0x1f03, 0x03b9, 0x0000}},
+    {0x1f84, {0x1f04, 0x03b9, 0x0000}},
+    {0x1f85, {0x1f05, 0x03b9, 0x0000}},
+    {0x1f86, {0x1f06, 0x03b9, 0x0000}},
+    {0x1f87, {0x1f07, 0x03b9, 0x0000}},
+    {0x1f88, {0x1f00, 0x03b9, 0x0000}},
+    {0x1f89, {0x1f01, 0x03b9, 0x0000}},
+    {0x1f8a, {0x1f02, 0x03b9, 0x0000}},
+    {0x1f8b, {0x1f03, 0x03b9, 0x0000}},
+    {0x1f8c, {0x1f04, 0x03b9, 0x0000}},
+    {0x1f8d, {0x1f05, 0x03b9, 0x0000}},
+    {0x1f8e, {0x1f06, 0x03b9, 0x0000}},
+    {0x1f8f, {0x1f07, 0x03b9, 0x0000}},
+    {0x1f90, {0x1f20, 0x03b9, 0x0000}},
+    {0x1f91, {0x1f21, 0x03b9, 0x0000}},
+    {0x1f92, {0x1f22, 0x03b9, 0x0000}},
+    {0x1f93, {0x1f23, 0x03b9, 0x0000}},
+    {0x1f94, {0x1f24, 0x03b9, 0x0000}},
+    {0x1f95, {0x1f25, 0x03b9, 0x0000}},
+    {0x1f96, {0x1f26, 0x03b9, 0x0000}},
+    {0x1f97, {0x1f27, 0x03b9, 0x0000}},
+    {0x1f98, {0x1f20, 0x03b9, 0x0000}},
+    {0x1f99, {0x1f21, 0x03b9, 0x0000}},
+    {0x1f9a, {0x1f22, 0x03b9, 0x0000}},
+    {0x1f9b, {0x1f23, 0x03b9, 0x0000}},
+    {0x1f9c, {0x1f24, 0x03b9, 0x0000}},
+    {0x1f9d, {0x1f25, 0x03b9, 0x0000}},
+    {0x1f9e, {0x1f26, 0x03b9, 0x0000}},
+    {0x1f9f, {0x1f27, 0x03b9, 0x0000}},
+    {0x1fa0, {0x1f60, 0x03b9, 0x0000}},
+    {0x1fa1, {0x1f61, 0x03b9, 0x0000}},
+    {0x1fa2, {0x1f62, 0x03b9, 0x0000}},
+    {0x1fa3, {0x1f63, 0x03b9, 0x0000}},
+    {0x1fa4, {0x1f64, 0x03b9, 0x0000}},
+    {0x1fa5, {0x1f65, 0x03b9, 0x0000}},
+    {0x1fa6, {0x1f66, 0x03b9, 0x0000}},
+    {0x1fa7, {0x1f67, 0x03b9, 0x0000}},
+    {0x1fa8, {0x1f60, 0x03b9, 0x0000}},
+    {0x1fa9, {0x1f61, 0x03b9, 0x0000}},
+    {0x1faa, {0x1f62, 0x03b9, 0x0000}},
+    {0x1fab, {0x1f63, 0x03b9, 0x0000}},
+    {0x1fac, {0x1f64, 0x03b9, 0x0000}},
+    {0x1fad, {0x1f65, 0x03b9, 0x0000}},
+    {0x1fae, {0x1f66, 0x03b9, 0x0000}},
+    {0x1faf, {0x1f67, 0x03b9, 0x0000}},
+    {0x1fb2, {0x1f70, 0x03b9, 0x0000}},
+    {0x1fb3, {0x03b1, 0x03b9, 0x0000}},
+    {0x1fb4, {0x03ac, 0x03b9, 0x0000}},
+    {0x1fb6, {0x03b1, 0x0342, 0x0000}},
+    {0x1fb7, {0x03b1, 0x0342, 0x03b9}},
+    {0x1fbc, {0x03b1, 0x03b9, 0x0000}},
+    {0x1fc2, {0x1f74, 0x03b9, 0x0000}},
+    {0x1fc3, {0x03b7, 0x03b9, 0x0000}},
+    {0x1fc4, {0x03ae, 0x03b9, 0x0000}},
+    {0x1fc6, {0x03b7, 0x0342, 0x0000}},
+    {0x1fc7, {0x03b7, 0x0342, 0x03b9}},
+    {0x1fcc, {0x03b7, 0x03b9, 0x0000}},
+    {0x1fd2, {0x03b9, 0x0308, 0x0300}},
+    {0x1fd3, {0x03b9, 0x0308, 0x0301}},
+    {0x1fd6, {0x03b9, 0x0342, 0x0000}},
+    {0x1fd7, {0x03b9, 0x0308, 0x0342}},
+    {0x1fe2, {0x03c5, 0x0308, 0x0300}},
+    {0x1fe3, {0x03c5, 0x0308, 0x0301}},
+    {0x1fe4, {0x03c1, 0x0313, 0x0000}},
+    {0x1fe6, {0x03c5, 0x0342, 0x0000}},
+    {0x1fe7, {0x03c5, 0x0308, 0x0342}},
+    {0x1ff2, {0x1f7c, 0x03b9, 0x0000}},
+    {0x1ff3, {0x03c9, 0x03b9, 0x0000}},
+    {0x1ff4, {0x03ce, 0x03b9, 0x0000}},
+    {0x1ff6, {0x03c9, 0x0342, 0x0000}},
+    {0x1ff7, {0x03c9, 0x0342, 0x03b9}},
+    {0x1ffc, {0x03c9, 0x03b9, 0x0000}},
+    {0xfb00, {0x0066, 0x0066, 0x0000}},
+    {0xfb01, {0x0066, 0x0069, 0x0000}},
+    {0xfb02, {0x0066, 0x006c, 0x0000}},
+    {0xfb03, {0x0066, 0x0066, 0x0069}},
+    {0xfb04, {0x0066, 0x0066, 0x006c}},
+    {0xfb05, {0x0073, 0x0074, 0x0000}},
+    {0xfb06, {0x0073, 0x0074, 0x0000}},
+    {0xfb13, {0x0574, 0x0576, 0x0000}},
+    {0xfb14, {0x0574, 0x0565, 0x0000}},
+    {0xfb15, {0x0574, 0x056b, 0x0000}},
+    {0xfb16, {0x057e, 0x0576, 0x0000}},
+    {0xfb17, {0x0574, 0x056d, 0x0000}},
+};
+
+} // namespace manifold::internal
+
+#endif
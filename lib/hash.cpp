@@ -0,0 +1,974 @@
+#include "simd.hpp"
+#include <bit>
+#include <cstring>
+#include <manifold/hash.hpp>
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace manifold::hash {
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// helpers
+//===----------------------------------------------------------------------===//
+
+auto bswap64(u64 x) -> u64 {
+  return (x >> 56) | ((x >> 40) & 0xFF00UL) | ((x >> 24) & 0xFF0000UL) |
+         ((x >> 8) & 0xFF000000UL) | ((x << 8) & 0xFF00000000UL) |
+         ((x << 24) & 0xFF0000000000UL) | ((x << 40) & 0xFF000000000000UL) |
+         (x << 56);
+}
+
+auto bswap32(u32 x) -> u32 {
+  return (x >> 24) | ((x >> 8) & 0xFF00U) | ((x << 8) & 0xFF0000U) | (x << 24);
+}
+
+auto read64(const u8 *p) -> u64 {
+  u64 v;
+  std::memcpy(&v, p, sizeof(v));
+  return std::endian::native == std::endian::little ? v : bswap64(v);
+}
+
+auto read32(const u8 *p) -> u32 {
+  u32 v;
+  std::memcpy(&v, p, sizeof(v));
+  return std::endian::native == std::endian::little ? v : bswap32(v);
+}
+
+auto write64(u8 *p, u64 v) -> void {
+  if constexpr (std::endian::native != std::endian::little)
+    v = bswap64(v);
+  std::memcpy(p, &v, sizeof(v));
+}
+
+auto rotl(u64 x, int r) -> u64 { return (x << r) | (x >> (64 - r)); }
+
+/// 64x64 -> 128 multiply, returns (low, high)
+auto mul128(u64 a, u64 b, u64 &high) -> u64 {
+#ifdef __SIZEOF_INT128__
+  __extension__ using u128 = unsigned __int128;
+  u128 r = static_cast<u128>(a) * b;
+  high = static_cast<u64>(r >> 64);
+  return static_cast<u64>(r);
+#else
+  u64 lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+  u64 hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+  u64 lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+  u64 hi_hi = (a >> 32) * (b >> 32);
+  u64 cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+  return (cross << 32) | (lo_lo & 0xFFFFFFFF);
+#endif
+}
+
+auto mul128_fold64(u64 a, u64 b) -> u64 {
+  u64 high;
+  u64 low = mul128(a, b, high);
+  return low ^ high;
+}
+
+//===----------------------------------------------------------------------===//
+// CRC-32C
+//===----------------------------------------------------------------------===//
+
+/// Reflected Castagnoli polynomial
+constexpr u32 kCrcPoly = 0x82F63B78U;
+
+/// Slicing-by-8 tables for the portable path
+constexpr auto kCrcTables = [] {
+  std::array<std::array<u32, 256>, 8> tables{};
+  for (u32 i = 0; i < 256; i++) {
+    u32 crc = i;
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc & 1) ? (crc >> 1) ^ kCrcPoly : crc >> 1;
+    tables[0][i] = crc;
+  }
+
+  for (u32 i = 0; i < 256; i++) {
+    for (usize k = 1; k < 8; k++) {
+      u32 prev = tables[k - 1][i];
+      tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+    }
+  }
+
+  return tables;
+}();
+
+/// Every `crc32c_*` kernel works on the raw register (no pre/post inversion)
+auto crc32c_portable(u32 crc, const u8 *p, usize n) -> u32 {
+  const auto &t = kCrcTables;
+  for (; n >= 8; n -= 8, p += 8) {
+    u64 w = read64(p) ^ crc;
+    crc = t[7][w & 0xFF] ^ t[6][(w >> 8) & 0xFF] ^ t[5][(w >> 16) & 0xFF] ^
+          t[4][(w >> 24) & 0xFF] ^ t[3][(w >> 32) & 0xFF] ^
+          t[2][(w >> 40) & 0xFF] ^ t[1][(w >> 48) & 0xFF] ^ t[0][w >> 56];
+  }
+
+  for (; n > 0; n--)
+    crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+
+  return crc;
+}
+
+/// `a * b mod P` (reflected, bit 31 is x^0)
+auto multmodp(u32 a, u32 b) -> u32 {
+  u32 m = 1U << 31;
+  u32 p = 0;
+  for (;;) {
+    if (a & m) {
+      p ^= b;
+      if ((a & (m - 1)) == 0)
+        break;
+    }
+    m >>= 1;
+    b = (b & 1) ? (b >> 1) ^ kCrcPoly : b >> 1;
+  }
+  return p;
+}
+
+/// `x^n mod P`
+auto xpow(u64 n) -> u32 {
+  u32 result = 1U << 31; // x^0
+  u32 square = 1U << 30; // x^1
+  for (; n > 0; n >>= 1) {
+    if (n & 1)
+      result = multmodp(result, square);
+    square = multmodp(square, square);
+  }
+  return result;
+}
+
+/// Bytes per stream in the three-way interleaved loops
+constexpr usize kCrcStride = 2048;
+
+#ifdef MANIFOLD_SIMD_X86
+/// Constants shifting a CRC by 2 and 1 strides, `x^(8n - 33)` for pclmul and
+/// `x^(8n)` for the portable multiply
+struct CrcShifts {
+  u32 clmul_two = xpow(8 * 2 * kCrcStride - 33);
+  u32 clmul_one = xpow(8 * kCrcStride - 33);
+  u32 two = xpow(8 * 2 * kCrcStride);
+  u32 one = xpow(8 * kCrcStride);
+};
+
+auto crc_shifts() -> const CrcShifts & {
+  static const CrcShifts shifts;
+  return shifts;
+}
+
+MANIFOLD_TARGET("sse4.2")
+auto crc32c_sse42(u32 crc, const u8 *p, usize n) -> u32 {
+  // three independent streams hide the 3-cycle latency of crc32
+  const auto &shifts = crc_shifts();
+  while (n >= 3 * kCrcStride) {
+    u64 c0 = crc, c1 = 0, c2 = 0;
+    for (usize i = 0; i < kCrcStride; i += 8) {
+      c0 = _mm_crc32_u64(c0, read64(p + i));
+      c1 = _mm_crc32_u64(c1, read64(p + kCrcStride + i));
+      c2 = _mm_crc32_u64(c2, read64(p + 2 * kCrcStride + i));
+    }
+
+    crc = multmodp(shifts.two, static_cast<u32>(c0)) ^
+          multmodp(shifts.one, static_cast<u32>(c1)) ^ static_cast<u32>(c2);
+    p += 3 * kCrcStride;
+    n -= 3 * kCrcStride;
+  }
+
+  u64 c = crc;
+  for (; n >= 8; n -= 8, p += 8)
+    c = _mm_crc32_u64(c, read64(p));
+  crc = static_cast<u32>(c);
+
+  for (; n > 0; n--)
+    crc = _mm_crc32_u8(crc, *p++);
+
+  return crc;
+}
+
+MANIFOLD_TARGET("sse4.2,pclmul")
+auto crc32c_sse42_pclmul(u32 crc, const u8 *p, usize n) -> u32 {
+  const auto &shifts = crc_shifts();
+  const __m128i k2 = _mm_cvtsi32_si128(static_cast<int>(shifts.clmul_two));
+  const __m128i k1 = _mm_cvtsi32_si128(static_cast<int>(shifts.clmul_one));
+
+  while (n >= 3 * kCrcStride) {
+    u64 c0 = crc, c1 = 0, c2 = 0;
+    for (usize i = 0; i < kCrcStride; i += 8) {
+      c0 = _mm_crc32_u64(c0, read64(p + i));
+      c1 = _mm_crc32_u64(c1, read64(p + kCrcStride + i));
+      c2 = _mm_crc32_u64(c2, read64(p + 2 * kCrcStride + i));
+    }
+
+    // carry-less multiply by x^(8n - 33), then let crc32 do the reduction
+    __m128i v0 = _mm_clmulepi64_si128(
+        _mm_cvtsi32_si128(static_cast<int>(c0)), k2, 0x00);
+    __m128i v1 = _mm_clmulepi64_si128(
+        _mm_cvtsi32_si128(static_cast<int>(c1)), k1, 0x00);
+    u64 folded = static_cast<u64>(_mm_cvtsi128_si64(_mm_xor_si128(v0, v1)));
+
+    crc = static_cast<u32>(_mm_crc32_u64(0, folded)) ^ static_cast<u32>(c2);
+    p += 3 * kCrcStride;
+    n -= 3 * kCrcStride;
+  }
+
+  return crc32c_sse42(crc, p, n);
+}
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+auto crc32c_arm(u32 crc, const u8 *p, usize n) -> u32 {
+  for (; n >= 8; n -= 8, p += 8)
+    crc = __crc32cd(crc, read64(p));
+
+  for (; n > 0; n--)
+    crc = __crc32cb(crc, *p++);
+
+  return crc;
+}
+#endif
+
+using crc_kernel = u32 (*)(u32, const u8 *, usize);
+
+auto crc_dispatch() -> crc_kernel {
+#ifdef MANIFOLD_SIMD_X86
+  if (simd::features().sse42 && simd::features().pclmul)
+    return crc32c_sse42_pclmul;
+  if (simd::features().sse42)
+    return crc32c_sse42;
+#endif
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+  return crc32c_arm;
+#endif
+  return crc32c_portable;
+}
+
+//===----------------------------------------------------------------------===//
+// XXH64
+//===----------------------------------------------------------------------===//
+
+constexpr u64 kPrime64_1 = 0x9E3779B185EBCA87UL;
+constexpr u64 kPrime64_2 = 0xC2B2AE3D27D4EB4FUL;
+constexpr u64 kPrime64_3 = 0x165667B19E3779F9UL;
+constexpr u64 kPrime64_4 = 0x85EBCA77C2B2AE63UL;
+constexpr u64 kPrime64_5 = 0x27D4EB2F165667C5UL;
+constexpr u64 kPrime32_1 = 0x9E3779B1U;
+constexpr u64 kPrime32_2 = 0x85EBCA77U;
+constexpr u64 kPrime32_3 = 0xC2B2AE3DU;
+
+auto xxh64_round(u64 acc, u64 input) -> u64 {
+  acc += input * kPrime64_2;
+  return rotl(acc, 31) * kPrime64_1;
+}
+
+auto xxh64_merge(u64 acc, u64 lane) -> u64 {
+  acc ^= xxh64_round(0, lane);
+  return acc * kPrime64_1 + kPrime64_4;
+}
+
+auto xxh64_avalanche(u64 h) -> u64 {
+  h ^= h >> 33;
+  h *= kPrime64_2;
+  h ^= h >> 29;
+  h *= kPrime64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+auto xxh64_finalize(u64 h, const u8 *p, usize n) -> u64 {
+  for (; n >= 8; n -= 8, p += 8) {
+    h ^= xxh64_round(0, read64(p));
+    h = rotl(h, 27) * kPrime64_1 + kPrime64_4;
+  }
+
+  if (n >= 4) {
+    h ^= static_cast<u64>(read32(p)) * kPrime64_1;
+    h = rotl(h, 23) * kPrime64_2 + kPrime64_3;
+    p += 4;
+    n -= 4;
+  }
+
+  for (; n > 0; n--) {
+    h ^= *p++ * kPrime64_5;
+    h = rotl(h, 11) * kPrime64_1;
+  }
+
+  return xxh64_avalanche(h);
+}
+
+auto xxh64_init(std::array<u64, 4> &lanes, u64 seed) -> void {
+  lanes = {seed + kPrime64_1 + kPrime64_2, seed + kPrime64_2, seed,
+           seed - kPrime64_1};
+}
+
+auto xxh64_stripes(std::array<u64, 4> &lanes, const u8 *p, usize count)
+    -> void {
+  for (usize i = 0; i < count; i++, p += 32) {
+    lanes[0] = xxh64_round(lanes[0], read64(p));
+    lanes[1] = xxh64_round(lanes[1], read64(p + 8));
+    lanes[2] = xxh64_round(lanes[2], read64(p + 16));
+    lanes[3] = xxh64_round(lanes[3], read64(p + 24));
+  }
+}
+
+auto xxh64_converge(const std::array<u64, 4> &lanes) -> u64 {
+  u64 h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) +
+          rotl(lanes[3], 18);
+  for (u64 lane : lanes)
+    h = xxh64_merge(h, lane);
+  return h;
+}
+
+//===----------------------------------------------------------------------===//
+// XXH3
+//===----------------------------------------------------------------------===//
+
+constexpr usize kStripeLength = 64;
+constexpr usize kSecretConsumeRate = 8;
+constexpr usize kStripesPerBlock =
+    (Xxh3::kSecretSize - kStripeLength) / kSecretConsumeRate;
+constexpr usize kMidSizeMax = 240;
+
+alignas(64) constexpr u8 kSecret[Xxh3::kSecretSize] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c,
+    0xf7, 0x21, 0xad, 0x1c, 0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb,
+    0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f, 0xcb, 0x79, 0xe6, 0x4e,
+    0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6,
+    0x81, 0x3a, 0x26, 0x4c, 0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb,
+    0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97,
+    0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7,
+    0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31,
+    0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64, 0xea, 0xc5, 0xac, 0x83,
+    0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26,
+    0x29, 0xd4, 0x68, 0x9e, 0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc,
+    0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f,
+    0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+constexpr std::array<u64, 8> kInitAcc = {
+    kPrime32_3, kPrime64_1, kPrime64_2, kPrime64_3,
+    kPrime64_4, kPrime32_2, kPrime64_5, kPrime32_1,
+};
+
+auto xxh3_avalanche(u64 h) -> u64 {
+  h ^= h >> 37;
+  h *= 0x165667919E3779F9UL;
+  h ^= h >> 32;
+  return h;
+}
+
+auto xxh3_rrmxmx(u64 h, u64 length) -> u64 {
+  h ^= rotl(h, 49) ^ rotl(h, 24);
+  h *= 0x9FB21C651E98DF25UL;
+  h ^= (h >> 35) + length;
+  h *= 0x9FB21C651E98DF25UL;
+  h ^= h >> 28;
+  return h;
+}
+
+auto xxh3_mix16(const u8 *p, const u8 *secret, u64 seed) -> u64 {
+  return mul128_fold64(read64(p) ^ (read64(secret) + seed),
+                       read64(p + 8) ^ (read64(secret + 8) - seed));
+}
+
+auto xxh3_len_0to16(const u8 *p, usize n, const u8 *secret, u64 seed) -> u64 {
+  if (n > 8) {
+    u64 flip1 = (read64(secret + 24) ^ read64(secret + 32)) + seed;
+    u64 flip2 = (read64(secret + 40) ^ read64(secret + 48)) - seed;
+    u64 lo = read64(p) ^ flip1;
+    u64 hi = read64(p + n - 8) ^ flip2;
+    return xxh3_avalanche(n + bswap64(lo) + hi + mul128_fold64(lo, hi));
+  }
+
+  if (n >= 4) {
+    seed ^= static_cast<u64>(bswap32(static_cast<u32>(seed))) << 32;
+    u64 flip = (read64(secret + 8) ^ read64(secret + 16)) - seed;
+    u64 input = read32(p + n - 4) + (static_cast<u64>(read32(p)) << 32);
+    return xxh3_rrmxmx(input ^ flip, n);
+  }
+
+  if (n > 0) {
+    u32 combined = (static_cast<u32>(p[0]) << 16) |
+                   (static_cast<u32>(p[n >> 1]) << 24) |
+                   static_cast<u32>(p[n - 1]) | (static_cast<u32>(n) << 8);
+    u64 flip = (read32(secret) ^ read32(secret + 4)) + seed;
+    return xxh64_avalanche(combined ^ flip);
+  }
+
+  return xxh64_avalanche(seed ^ read64(secret + 56) ^ read64(secret + 64));
+}
+
+auto xxh3_len_17to128(const u8 *p, usize n, const u8 *secret, u64 seed)
+    -> u64 {
+  u64 acc = n * kPrime64_1;
+  if (n > 32) {
+    if (n > 64) {
+      if (n > 96) {
+        acc += xxh3_mix16(p + 48, secret + 96, seed);
+        acc += xxh3_mix16(p + n - 64, secret + 112, seed);
+      }
+      acc += xxh3_mix16(p + 32, secret + 64, seed);
+      acc += xxh3_mix16(p + n - 48, secret + 80, seed);
+    }
+    acc += xxh3_mix16(p + 16, secret + 32, seed);
+    acc += xxh3_mix16(p + n - 32, secret + 48, seed);
+  }
+  acc += xxh3_mix16(p, secret, seed);
+  acc += xxh3_mix16(p + n - 16, secret + 16, seed);
+  return xxh3_avalanche(acc);
+}
+
+auto xxh3_len_129to240(const u8 *p, usize n, const u8 *secret, u64 seed)
+    -> u64 {
+  u64 acc = n * kPrime64_1;
+  usize rounds = n / 16;
+  for (usize i = 0; i < 8; i++)
+    acc += xxh3_mix16(p + 16 * i, secret + 16 * i, seed);
+  acc = xxh3_avalanche(acc);
+
+  for (usize i = 8; i < rounds; i++)
+    acc += xxh3_mix16(p + 16 * i, secret + 16 * (i - 8) + 3, seed);
+
+  acc += xxh3_mix16(p + n - 16, secret + 136 - 17, seed);
+  return xxh3_avalanche(acc);
+}
+
+/// Accumulates `stripes` 64-byte stripes, the secret advances 8 bytes each
+using xxh3_accumulate_fn = void (*)(u64 *acc, const u8 *input,
+                                    const u8 *secret, usize stripes);
+using xxh3_scramble_fn = void (*)(u64 *acc, const u8 *secret);
+
+[[maybe_unused]] auto xxh3_accumulate_scalar(u64 *acc, const u8 *input,
+                                            const u8 *secret, usize stripes)
+    -> void {
+  for (usize s = 0; s < stripes; s++) {
+    const u8 *in = input + s * kStripeLength;
+    const u8 *key = secret + s * kSecretConsumeRate;
+    for (usize i = 0; i < 8; i++) {
+      u64 value = read64(in + 8 * i);
+      u64 keyed = value ^ read64(key + 8 * i);
+      acc[i ^ 1] += value;
+      acc[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+    }
+  }
+}
+
+[[maybe_unused]] auto xxh3_scramble_scalar(u64 *acc, const u8 *secret) -> void {
+  for (usize i = 0; i < 8; i++) {
+    u64 a = acc[i];
+    a ^= a >> 47;
+    a ^= read64(secret + 8 * i);
+    acc[i] = a * kPrime32_1;
+  }
+}
+
+#ifdef MANIFOLD_SIMD_X86
+// SSE2 is part of x86-64, no target attribute needed
+auto xxh3_accumulate_sse2(u64 *acc, const u8 *input, const u8 *secret,
+                          usize stripes) -> void {
+  auto *xacc = reinterpret_cast<__m128i *>(acc);
+  __m128i a[4];
+  for (int i = 0; i < 4; i++)
+    a[i] = _mm_loadu_si128(xacc + i);
+
+  for (usize s = 0; s < stripes; s++) {
+    const u8 *in = input + s * kStripeLength;
+    const u8 *key = secret + s * kSecretConsumeRate;
+    for (int i = 0; i < 4; i++) {
+      __m128i data =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * i));
+      __m128i keys =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(key + 16 * i));
+      __m128i keyed = _mm_xor_si128(data, keys);
+      __m128i keyed_hi = _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1));
+      __m128i product = _mm_mul_epu32(keyed, keyed_hi);
+      __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      a[i] = _mm_add_epi64(a[i], _mm_add_epi64(product, swapped));
+    }
+  }
+
+  for (int i = 0; i < 4; i++)
+    _mm_storeu_si128(xacc + i, a[i]);
+}
+
+auto xxh3_scramble_sse2(u64 *acc, const u8 *secret) -> void {
+  auto *xacc = reinterpret_cast<__m128i *>(acc);
+  const __m128i prime = _mm_set1_epi32(static_cast<int>(kPrime32_1));
+  for (int i = 0; i < 4; i++) {
+    __m128i a = _mm_loadu_si128(xacc + i);
+    a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+    a = _mm_xor_si128(a, _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                             secret + 16 * i)));
+    __m128i a_hi = _mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1));
+    __m128i lo = _mm_mul_epu32(a, prime);
+    __m128i hi = _mm_mul_epu32(a_hi, prime);
+    _mm_storeu_si128(xacc + i, _mm_add_epi64(lo, _mm_slli_epi64(hi, 32)));
+  }
+}
+
+MANIFOLD_TARGET("avx2")
+auto xxh3_accumulate_avx2(u64 *acc, const u8 *input, const u8 *secret,
+                          usize stripes) -> void {
+  auto *xacc = reinterpret_cast<__m256i *>(acc);
+  __m256i a0 = _mm256_loadu_si256(xacc);
+  __m256i a1 = _mm256_loadu_si256(xacc + 1);
+
+  for (usize s = 0; s < stripes; s++) {
+    const auto *in =
+        reinterpret_cast<const __m256i *>(input + s * kStripeLength);
+    const auto *key =
+        reinterpret_cast<const __m256i *>(secret + s * kSecretConsumeRate);
+
+    __m256i d0 = _mm256_loadu_si256(in);
+    __m256i d1 = _mm256_loadu_si256(in + 1);
+    __m256i k0 = _mm256_xor_si256(d0, _mm256_loadu_si256(key));
+    __m256i k1 = _mm256_xor_si256(d1, _mm256_loadu_si256(key + 1));
+    __m256i p0 = _mm256_mul_epu32(k0, _mm256_srli_epi64(k0, 32));
+    __m256i p1 = _mm256_mul_epu32(k1, _mm256_srli_epi64(k1, 32));
+    __m256i s0 = _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2));
+    __m256i s1 = _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2));
+    a0 = _mm256_add_epi64(a0, _mm256_add_epi64(p0, s0));
+    a1 = _mm256_add_epi64(a1, _mm256_add_epi64(p1, s1));
+  }
+
+  _mm256_storeu_si256(xacc, a0);
+  _mm256_storeu_si256(xacc + 1, a1);
+}
+
+MANIFOLD_TARGET("avx2")
+auto xxh3_scramble_avx2(u64 *acc, const u8 *secret) -> void {
+  auto *xacc = reinterpret_cast<__m256i *>(acc);
+  const __m256i prime = _mm256_set1_epi32(static_cast<int>(kPrime32_1));
+  for (int i = 0; i < 2; i++) {
+    __m256i a = _mm256_loadu_si256(xacc + i);
+    a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+    a = _mm256_xor_si256(a, _mm256_loadu_si256(
+                                reinterpret_cast<const __m256i *>(secret) + i));
+    __m256i lo = _mm256_mul_epu32(a, prime);
+    __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+    _mm256_storeu_si256(xacc + i,
+                        _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+  }
+}
+#endif
+
+struct Xxh3Kernels {
+  xxh3_accumulate_fn accumulate;
+  xxh3_scramble_fn scramble;
+};
+
+auto xxh3_kernels() -> const Xxh3Kernels & {
+  static const Xxh3Kernels kernels = []() -> Xxh3Kernels {
+#ifdef MANIFOLD_SIMD_X86
+    if (simd::features().avx2)
+      return {xxh3_accumulate_avx2, xxh3_scramble_avx2};
+    return {xxh3_accumulate_sse2, xxh3_scramble_sse2};
+#else
+    return {xxh3_accumulate_scalar, xxh3_scramble_scalar};
+#endif
+  }();
+
+  return kernels;
+}
+
+auto xxh3_merge(const u64 *acc, const u8 *secret, u64 start) -> u64 {
+  u64 result = start;
+  for (usize i = 0; i < 4; i++) {
+    result += mul128_fold64(acc[2 * i] ^ read64(secret + 16 * i),
+                            acc[2 * i + 1] ^ read64(secret + 16 * i + 8));
+  }
+  return xxh3_avalanche(result);
+}
+
+auto xxh3_derive_secret(u8 *out, u64 seed) -> void {
+  for (usize i = 0; i < Xxh3::kSecretSize / 16; i++) {
+    write64(out + 16 * i, read64(kSecret + 16 * i) + seed);
+    write64(out + 16 * i + 8, read64(kSecret + 16 * i + 8) - seed);
+  }
+}
+
+auto xxh3_long(const u8 *p, usize n, const u8 *secret) -> u64 {
+  const auto &k = xxh3_kernels();
+  alignas(64) std::array<u64, 8> acc = kInitAcc;
+
+  constexpr usize block = kStripeLength * kStripesPerBlock;
+  usize blocks = (n - 1) / block;
+  for (usize b = 0; b < blocks; b++) {
+    k.accumulate(acc.data(), p + b * block, secret, kStripesPerBlock);
+    k.scramble(acc.data(), secret + Xxh3::kSecretSize - kStripeLength);
+  }
+
+  usize stripes = ((n - 1) - block * blocks) / kStripeLength;
+  k.accumulate(acc.data(), p + blocks * block, secret, stripes);
+  k.accumulate(acc.data(), p + n - kStripeLength,
+               secret + Xxh3::kSecretSize - kStripeLength - 7, 1);
+
+  return xxh3_merge(acc.data(), secret + 11, n * kPrime64_1);
+}
+
+auto xxh3_oneshot(const u8 *p, usize n, u64 seed) -> u64 {
+  if (n <= 16)
+    return xxh3_len_0to16(p, n, kSecret, seed);
+  if (n <= 128)
+    return xxh3_len_17to128(p, n, kSecret, seed);
+  if (n <= kMidSizeMax)
+    return xxh3_len_129to240(p, n, kSecret, seed);
+
+  if (seed == 0)
+    return xxh3_long(p, n, kSecret);
+
+  alignas(64) u8 secret[Xxh3::kSecretSize];
+  xxh3_derive_secret(secret, seed);
+  return xxh3_long(p, n, secret);
+}
+
+/// Consumes stripes from the streaming state, scrambling at block ends.
+/// Returns the number of stripes consumed in the current block.
+auto xxh3_consume(u64 *acc, usize done, const u8 *input, usize count,
+                  const u8 *secret) -> usize {
+  const auto &k = xxh3_kernels();
+  if (kStripesPerBlock - done <= count) {
+    usize to_end = kStripesPerBlock - done;
+    usize after = count - to_end;
+    k.accumulate(acc, input, secret + done * kSecretConsumeRate, to_end);
+    k.scramble(acc, secret + Xxh3::kSecretSize - kStripeLength);
+    k.accumulate(acc, input + to_end * kStripeLength, secret, after);
+    return after;
+  }
+
+  k.accumulate(acc, input, secret + done * kSecretConsumeRate, count);
+  return done + count;
+}
+
+//===----------------------------------------------------------------------===//
+// wyhash
+//===----------------------------------------------------------------------===//
+
+constexpr u64 kWyp[4] = {0x2d358dccaa6c78a5UL, 0x8bb84b93962eacc9UL,
+                         0x4b33a62ed433d4a3UL, 0x4d5a2da51de1aa47UL};
+
+auto wymix(u64 a, u64 b) -> u64 { return mul128_fold64(a, b); }
+
+//===----------------------------------------------------------------------===//
+// SipHash-1-3
+//===----------------------------------------------------------------------===//
+
+struct SipState {
+  u64 v0, v1, v2, v3;
+
+  auto round() -> void {
+    v0 += v1;
+    v1 = rotl(v1, 13);
+    v1 ^= v0;
+    v0 = rotl(v0, 32);
+    v2 += v3;
+    v3 = rotl(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotl(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotl(v1, 17);
+    v1 ^= v2;
+    v2 = rotl(v2, 32);
+  }
+
+  auto absorb(u64 m) -> void {
+    v3 ^= m;
+    round();
+    v0 ^= m;
+  }
+};
+
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// public api
+//===----------------------------------------------------------------------===//
+
+auto crc32c(std::span<const u8> data, u32 crc) -> u32 {
+  static const crc_kernel kernel = crc_dispatch();
+  return ~kernel(~crc, data.data(), data.size());
+}
+
+auto crc32c(std::string_view data, u32 crc) -> u32 {
+  return crc32c(std::span<const u8>(reinterpret_cast<const u8 *>(data.data()),
+                                    data.size()),
+                crc);
+}
+
+auto crc32c_combine(u32 crc_a, u32 crc_b, usize length_b) -> u32 {
+  return multmodp(xpow(8 * static_cast<u64>(length_b)), crc_a) ^ crc_b;
+}
+
+auto xxh64(std::span<const u8> data, u64 seed) -> u64 {
+  const u8 *p = data.data();
+  usize n = data.size();
+
+  u64 h;
+  if (n >= 32) {
+    std::array<u64, 4> lanes;
+    xxh64_init(lanes, seed);
+    xxh64_stripes(lanes, p, n / 32);
+    h = xxh64_converge(lanes);
+    p += n / 32 * 32;
+  } else {
+    h = seed + kPrime64_5;
+  }
+
+  h += n;
+  return xxh64_finalize(h, p, n % 32);
+}
+
+auto xxh64(std::string_view data, u64 seed) -> u64 {
+  return xxh64(std::span<const u8>(reinterpret_cast<const u8 *>(data.data()),
+                                   data.size()),
+               seed);
+}
+
+auto xxh3(std::span<const u8> data, u64 seed) -> u64 {
+  return xxh3_oneshot(data.data(), data.size(), seed);
+}
+
+auto xxh3(std::string_view data, u64 seed) -> u64 {
+  return xxh3_oneshot(reinterpret_cast<const u8 *>(data.data()), data.size(),
+                      seed);
+}
+
+auto wyhash(std::span<const u8> data, u64 seed) -> u64 {
+  const u8 *p = data.data();
+  usize n = data.size();
+
+  seed ^= wymix(seed ^ kWyp[0], kWyp[1]);
+
+  u64 a, b;
+  if (n <= 16) {
+    if (n >= 4) {
+      usize mid = (n >> 3) << 2;
+      a = (static_cast<u64>(read32(p)) << 32) | read32(p + mid);
+      b = (static_cast<u64>(read32(p + n - 4)) << 32) | read32(p + n - 4 - mid);
+    } else if (n > 0) {
+      a = (static_cast<u64>(p[0]) << 16) | (static_cast<u64>(p[n >> 1]) << 8) |
+          p[n - 1];
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    usize i = n;
+    if (i >= 48) {
+      u64 see1 = seed, see2 = seed;
+      do {
+        seed = wymix(read64(p) ^ kWyp[1], read64(p + 8) ^ seed);
+        see1 = wymix(read64(p + 16) ^ kWyp[2], read64(p + 24) ^ see1);
+        see2 = wymix(read64(p + 32) ^ kWyp[3], read64(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i >= 48);
+      seed ^= see1 ^ see2;
+    }
+
+    while (i > 16) {
+      seed = wymix(read64(p) ^ kWyp[1], read64(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+
+    a = read64(p + i - 16);
+    b = read64(p + i - 8);
+  }
+
+  a ^= kWyp[1];
+  b ^= seed;
+  a = mul128(a, b, b);
+  return wymix(a ^ kWyp[0] ^ n, b ^ kWyp[1]);
+}
+
+auto siphash13(std::span<const u8> data, u64 key0, u64 key1) -> u64 {
+  const u8 *p = data.data();
+  usize n = data.size();
+
+  SipState s{key0 ^ 0x736f6d6570736575UL, key1 ^ 0x646f72616e646f6dUL,
+             key0 ^ 0x6c7967656e657261UL, key1 ^ 0x7465646279746573UL};
+  for (; n >= 8; n -= 8, p += 8)
+    s.absorb(read64(p));
+
+  // the last word holds the remaining bytes and the length in its top byte
+  u64 last = static_cast<u64>(data.size()) << 56;
+  for (usize i = 0; i < n; i++)
+    last |= static_cast<u64>(p[i]) << (8 * i);
+
+  s.absorb(last);
+  s.v2 ^= 0xff;
+  s.round();
+  s.round();
+  s.round();
+  return s.v0 ^ s.v1 ^ s.v2 ^ s.v3;
+}
+
+auto siphash13(std::string_view data, u64 key0, u64 key1) -> u64 {
+  return siphash13(std::span<const u8>(
+                       reinterpret_cast<const u8 *>(data.data()), data.size()),
+                   key0, key1);
+}
+
+auto wyhash(std::string_view data, u64 seed) -> u64 {
+  return wyhash(std::span<const u8>(reinterpret_cast<const u8 *>(data.data()),
+                                    data.size()),
+                seed);
+}
+
+auto hash(Algorithm algo, std::span<const u8> data, u64 seed) -> u64 {
+  switch (algo) {
+  case Algorithm::Crc32c:
+    return crc32c(data, static_cast<u32>(seed));
+  case Algorithm::XXH64:
+    return xxh64(data, seed);
+  case Algorithm::XXH3:
+    return xxh3(data, seed);
+  }
+
+  MANIFOLD_UNREACHABLE;
+}
+
+//===----------------------------------------------------------------------===//
+// streaming
+//===----------------------------------------------------------------------===//
+
+auto Xxh64::update(std::span<const u8> data) -> void {
+  const u8 *p = data.data();
+  usize n = data.size();
+  total += n;
+
+  if (buffered + n < 32) {
+    std::memcpy(buffer.data() + buffered, p, n);
+    buffered += n;
+    return;
+  }
+
+  if (buffered > 0) {
+    usize fill = 32 - buffered;
+    std::memcpy(buffer.data() + buffered, p, fill);
+    xxh64_stripes(lanes, buffer.data(), 1);
+    p += fill;
+    n -= fill;
+    buffered = 0;
+  }
+
+  xxh64_stripes(lanes, p, n / 32);
+  p += n / 32 * 32;
+  n %= 32;
+
+  std::memcpy(buffer.data(), p, n);
+  buffered = n;
+}
+
+auto Xxh64::update(std::string_view data) -> void {
+  update(std::span<const u8>(reinterpret_cast<const u8 *>(data.data()),
+                             data.size()));
+}
+
+auto Xxh64::digest() const -> u64 {
+  u64 h = total >= 32 ? xxh64_converge(lanes) : seed_value + kPrime64_5;
+  h += total;
+  return xxh64_finalize(h, buffer.data(), buffered);
+}
+
+auto Xxh64::reset(u64 seed) -> void {
+  xxh64_init(lanes, seed);
+  buffered = 0;
+  total = 0;
+  seed_value = seed;
+}
+
+auto Xxh3::update(std::span<const u8> data) -> void {
+  const u8 *p = data.data();
+  usize n = data.size();
+  total += n;
+
+  if (buffered + n <= kBufferSize) {
+    std::memcpy(buffer.data() + buffered, p, n);
+    buffered += n;
+    return;
+  }
+
+  // the buffer is only flushed once more input arrives, so the last stripe
+  // is always available to digest()
+  constexpr usize buffer_stripes = kBufferSize / kStripeLength;
+  if (buffered > 0) {
+    usize fill = kBufferSize - buffered;
+    std::memcpy(buffer.data() + buffered, p, fill);
+    p += fill;
+    n -= fill;
+    consume(buffer.data(), buffer_stripes);
+    buffered = 0;
+  }
+
+  if (n > kBufferSize) {
+    do {
+      consume(p, buffer_stripes);
+      p += kBufferSize;
+      n -= kBufferSize;
+    } while (n > kBufferSize);
+
+    std::memcpy(buffer.data() + kBufferSize - kStripeLength, p - kStripeLength,
+                kStripeLength);
+  }
+
+  std::memcpy(buffer.data(), p, n);
+  buffered = n;
+}
+
+auto Xxh3::update(std::string_view data) -> void {
+  update(std::span<const u8>(reinterpret_cast<const u8 *>(data.data()),
+                             data.size()));
+}
+
+auto Xxh3::digest() const -> u64 {
+  if (total <= kMidSizeMax)
+    return xxh3_oneshot(buffer.data(), buffered, seed_value);
+
+  const auto &k = xxh3_kernels();
+  alignas(64) std::array<u64, 8> copy = acc;
+  const u8 *last_secret = secret.data() + kSecretSize - kStripeLength - 7;
+
+  if (buffered >= kStripeLength) {
+    usize count = (buffered - 1) / kStripeLength;
+    xxh3_consume(copy.data(), stripes, buffer.data(), count, secret.data());
+    k.accumulate(copy.data(), buffer.data() + buffered - kStripeLength,
+                 last_secret, 1);
+  } else {
+    // the last stripe straddles the previous contents of the buffer
+    u8 last[kStripeLength];
+    usize catchup = kStripeLength - buffered;
+    std::memcpy(last, buffer.data() + kBufferSize - catchup, catchup);
+    std::memcpy(last + catchup, buffer.data(), buffered);
+    k.accumulate(copy.data(), last, last_secret, 1);
+  }
+
+  return xxh3_merge(copy.data(), secret.data() + 11, total * kPrime64_1);
+}
+
+auto Xxh3::reset(u64 seed) -> void {
+  acc = kInitAcc;
+  if (seed == 0)
+    std::memcpy(secret.data(), kSecret, kSecretSize);
+  else
+    xxh3_derive_secret(secret.data(), seed);
+
+  buffered = 0;
+  stripes = 0;
+  total = 0;
+  seed_value = seed;
+}
+
+auto Xxh3::consume(const u8 *input, usize count) -> void {
+  stripes = xxh3_consume(acc.data(), stripes, input, count, secret.data());
+}
+
+} // namespace manifold::hash
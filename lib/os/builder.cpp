@@ -0,0 +1,148 @@
+#include <manifold/os/str.hpp>
+#include <utility>
+
+namespace manifold::str {
+
+// the moved-from builder is left empty, as a default constructed one
+Builder::Builder(Builder &&other) noexcept
+    : chunks(std::exchange(other.chunks, {})),
+      current(std::exchange(other.current, 0)),
+      length(std::exchange(other.length, 0)) {}
+
+auto Builder::operator=(Builder &&other) noexcept -> Builder & {
+  if (this != &other) {
+    chunks = std::exchange(other.chunks, {});
+    current = std::exchange(other.current, 0);
+    length = std::exchange(other.length, 0);
+  }
+
+  return *this;
+}
+
+auto Builder::next_chunk(usize size) -> Chunk & {
+  // reuse chunks left over from before a clear() when they are big enough
+  while (current + 1 < chunks.size()) {
+    auto &chunk = chunks[++current];
+    if (chunk.capacity >= size)
+      return chunk;
+  }
+
+  // grow with the builder, but don't let a single chunk get huge unless one
+  // append needs it
+  usize capacity = std::clamp(length, kMinChunk, kMaxChunk);
+  capacity = std::max(capacity, size);
+
+  Chunk chunk;
+  chunk.data = std::unique_ptr<char[]>(new char[capacity]);
+  chunk.capacity = capacity;
+  chunks.push_back(std::move(chunk));
+  current = chunks.size() - 1;
+  return chunks.back();
+}
+
+auto Builder::append(std::string_view str) -> Builder & {
+  if (str.empty())
+    return *this;
+
+  Chunk *chunk = chunks.empty() ? nullptr : &chunks[current];
+  if (chunk == nullptr || chunk->capacity - chunk->size < str.size()) {
+    // top off the current chunk first so no space is wasted
+    if (chunk != nullptr) {
+      usize fill = chunk->capacity - chunk->size;
+      std::memcpy(chunk->data.get() + chunk->size, str.data(), fill);
+      chunk->size += fill;
+      length += fill;
+      str.remove_prefix(fill);
+    }
+
+    chunk = &next_chunk(str.size());
+  }
+
+  std::memcpy(chunk->data.get() + chunk->size, str.data(), str.size());
+  chunk->size += str.size();
+  length += str.size();
+  return *this;
+}
+
+auto Builder::append(char ch) -> Builder & {
+  return append(std::string_view(&ch, 1));
+}
+
+auto Builder::reserve(usize size) -> void {
+  if (!chunks.empty() &&
+      chunks[current].capacity - chunks[current].size >= size)
+    return;
+
+  // an empty current chunk can simply be replaced
+  if (!chunks.empty() && chunks[current].size == 0) {
+    auto &chunk = chunks[current];
+    chunk.data = std::unique_ptr<char[]>(new char[size]);
+    chunk.capacity = size;
+    return;
+  }
+
+  next_chunk(size);
+}
+
+auto Builder::view() -> std::string_view {
+  if (chunks.empty())
+    return {};
+
+  if (current != 0 || chunks.size() > 1) {
+    if (chunks[current].size != length) {
+      Chunk merged;
+      merged.capacity = capacity();
+      merged.data = std::unique_ptr<char[]>(new char[merged.capacity]);
+      for (const auto &chunk : chunks) {
+        std::memcpy(merged.data.get() + merged.size, chunk.data.get(),
+                    chunk.size);
+        merged.size += chunk.size;
+      }
+
+      chunks.clear();
+      chunks.push_back(std::move(merged));
+    } else {
+      // everything is in one chunk already
+      std::swap(chunks[0], chunks[current]);
+    }
+
+    current = 0;
+  }
+
+  return std::string_view(chunks[0].data.get(), chunks[0].size);
+}
+
+auto Builder::str() const -> std::string {
+  std::string result(length, '\0');
+  char *out = result.data();
+  for (const auto &chunk : chunks) {
+    std::memcpy(out, chunk.data.get(), chunk.size);
+    out += chunk.size;
+  }
+
+  return result;
+}
+
+auto Builder::take() -> std::string {
+  auto result = str();
+  clear();
+  return result;
+}
+
+auto Builder::clear() -> void {
+  for (auto &chunk : chunks)
+    chunk.size = 0;
+
+  current = 0;
+  length = 0;
+}
+
+auto Builder::capacity() const -> usize {
+  usize total = 0;
+  for (const auto &chunk : chunks)
+    total += chunk.capacity;
+
+  return total;
+}
+
+} // namespace manifold::str
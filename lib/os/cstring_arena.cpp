@@ -0,0 +1,91 @@
+#include <manifold/os/str.hpp>
+#include <cstdint>
+#include <utility>
+
+namespace manifold::str {
+
+// the moved-from arena must not keep writing into blocks it no longer owns
+CStringArena::CStringArena(CStringArena &&other) noexcept
+    : blocks(std::exchange(other.blocks, {})),
+      cursor(std::exchange(other.cursor, nullptr)),
+      remaining(std::exchange(other.remaining, 0)) {}
+
+auto CStringArena::operator=(CStringArena &&other) noexcept
+    -> CStringArena & {
+  if (this != &other) {
+    blocks = std::exchange(other.blocks, {});
+    cursor = std::exchange(other.cursor, nullptr);
+    remaining = std::exchange(other.remaining, 0);
+  }
+
+  return *this;
+}
+
+auto CStringArena::add(std::string_view str) -> const char * {
+  char *at = allocate(str.size() + 1);
+  return copy(at, str);
+}
+
+auto CStringArena::allocate_batch(usize count, usize bytes) -> char ** {
+  // pointers first, so the block only needs pointer alignment at the start
+  usize misalign =
+      reinterpret_cast<std::uintptr_t>(cursor) & (alignof(char *) - 1);
+  usize pad = misalign == 0 ? 0 : alignof(char *) - misalign;
+  usize size = (count + 1) * sizeof(char *) + bytes;
+  if (cursor != nullptr && remaining >= pad + size) {
+    cursor += pad;
+    remaining -= pad;
+  } else {
+    // a fresh block starts out aligned
+    reserve(pad + size);
+  }
+
+  return reinterpret_cast<char **>(allocate(size));
+}
+
+auto CStringArena::allocate(usize size) -> char * {
+  if (cursor == nullptr || remaining < size)
+    reserve(size);
+
+  char *at = cursor;
+  cursor += size;
+  remaining -= size;
+  return at;
+}
+
+auto CStringArena::reserve(usize size) -> void {
+  if (cursor != nullptr && remaining >= size)
+    return;
+
+  // blocks double so a growing workload settles on one block after clear()
+  usize grown = blocks.empty() ? kMinBlock : blocks.back().size * 2;
+  Block block{nullptr, std::max(grown, size)};
+  block.data.reset(new char[block.size]);
+  cursor = block.data.get();
+  remaining = block.size;
+  blocks.push_back(std::move(block));
+}
+
+auto CStringArena::clear() -> void {
+  if (blocks.empty())
+    return;
+
+  auto largest = std::max_element(
+      blocks.begin(), blocks.end(),
+      [](const Block &a, const Block &b) { return a.size < b.size; });
+  Block kept = std::move(*largest);
+  blocks.clear();
+  blocks.push_back(std::move(kept));
+  cursor = blocks.back().data.get();
+  remaining = blocks.back().size;
+}
+
+auto CStringArena::capacity() const -> usize {
+  usize total = 0;
+  for (const auto &block : blocks)
+    total += block.size;
+
+  return total;
+}
+
+} // namespace manifold::str
@@ -0,0 +1,287 @@
+#include "../simd.hpp"
+#include <manifold/os/csv.hpp>
+#include <manifold/os/str.hpp>
+
+namespace manifold::str::csv {
+
+namespace {
+
+/// Bit i of each mask is set if byte i of a 64-byte block is a quote, or a
+/// delimiter or newline
+struct Masks {
+  u64 quotes;
+  u64 separators;
+};
+
+using mask_kernel = auto (*)(const char *, char, char) -> Masks;
+
+[[maybe_unused]] auto masks_scalar(const char *data, char delimiter,
+                                   char quote) -> Masks {
+  Masks masks{0, 0};
+  for (usize i = 0; i < 64; i++) {
+    u64 bit = u64{1} << i;
+    if (data[i] == quote)
+      masks.quotes |= bit;
+
+    if (data[i] == delimiter || data[i] == '\n')
+      masks.separators |= bit;
+  }
+
+  return masks;
+}
+
+#ifdef MANIFOLD_SIMD_X86
+auto masks_sse2(const char *data, char delimiter, char quote) -> Masks {
+  const __m128i quotes = _mm_set1_epi8(quote);
+  const __m128i delimiters = _mm_set1_epi8(delimiter);
+  const __m128i newlines = _mm_set1_epi8('\n');
+
+  Masks masks{0, 0};
+  for (usize i = 0; i < 64; i += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    auto quote_bits = static_cast<u32>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(x, quotes)));
+    auto separator_bits = static_cast<u32>(_mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(x, delimiters), _mm_cmpeq_epi8(x, newlines))));
+    masks.quotes |= static_cast<u64>(quote_bits) << i;
+    masks.separators |= static_cast<u64>(separator_bits) << i;
+  }
+
+  return masks;
+}
+
+MANIFOLD_TARGET("avx2")
+auto masks_avx2(const char *data, char delimiter, char quote) -> Masks {
+  const __m256i quotes = _mm256_set1_epi8(quote);
+  const __m256i delimiters = _mm256_set1_epi8(delimiter);
+  const __m256i newlines = _mm256_set1_epi8('\n');
+
+  Masks masks{0, 0};
+  for (usize i = 0; i < 64; i += 32) {
+    __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    auto quote_bits = static_cast<u32>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, quotes)));
+    auto separator_bits =
+        static_cast<u32>(_mm256_movemask_epi8(_mm256_or_si256(
+            _mm256_cmpeq_epi8(x, delimiters), _mm256_cmpeq_epi8(x, newlines))));
+    masks.quotes |= static_cast<u64>(quote_bits) << i;
+    masks.separators |= static_cast<u64>(separator_bits) << i;
+  }
+
+  return masks;
+}
+#endif
+
+#ifdef MANIFOLD_SIMD_NEON
+/// One bit per byte of four compare results, by weighting each lane with its
+/// bit and adding neighbouring lanes together until 8 bytes are left
+auto movemask_neon(uint8x16_t a, uint8x16_t b, uint8x16_t c, uint8x16_t d)
+    -> u64 {
+  const uint8x16_t weights = {1, 2, 4, 8, 16, 32, 64, 128,
+                              1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x16_t low = vpaddq_u8(vandq_u8(a, weights), vandq_u8(b, weights));
+  uint8x16_t high = vpaddq_u8(vandq_u8(c, weights), vandq_u8(d, weights));
+  uint8x16_t sum = vpaddq_u8(low, high);
+  sum = vpaddq_u8(sum, sum);
+  return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+}
+
+auto masks_neon(const char *data, char delimiter, char quote) -> Masks {
+  const auto *bytes = reinterpret_cast<const u8 *>(data);
+  const uint8x16_t quotes = vdupq_n_u8(static_cast<u8>(quote));
+  const uint8x16_t delimiters = vdupq_n_u8(static_cast<u8>(delimiter));
+  const uint8x16_t newlines = vdupq_n_u8('\n');
+
+  uint8x16_t x[4];
+  uint8x16_t q[4];
+  uint8x16_t s[4];
+  for (usize i = 0; i < 4; i++) {
+    x[i] = vld1q_u8(bytes + i * 16);
+    q[i] = vceqq_u8(x[i], quotes);
+    s[i] = vorrq_u8(vceqq_u8(x[i], delimiters), vceqq_u8(x[i], newlines));
+  }
+
+  return Masks{movemask_neon(q[0], q[1], q[2], q[3]),
+               movemask_neon(s[0], s[1], s[2], s[3])};
+}
+#endif
+
+auto masks(const char *data, char delimiter, char quote) -> Masks {
+  static const mask_kernel kernel = []() -> mask_kernel {
+#ifdef MANIFOLD_SIMD_X86
+    if (simd::features().avx2)
+      return masks_avx2;
+
+    return masks_sse2;
+#elif defined(MANIFOLD_SIMD_NEON)
+    return masks_neon;
+#else
+    return masks_scalar;
+#endif
+  }();
+
+  return kernel(data, delimiter, quote);
+}
+
+/// Bit i is the XOR of bits 0..i, i.e. set for bytes after an odd number of
+/// quotes (an opening quote is inside its region, the closing one is not)
+auto prefix_xor(u64 bits) -> u64 {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+} // namespace
+
+Reader::Reader(std::string_view data, const Options &dialect)
+    : options(dialect), text(data), exhausted(true) {}
+
+Reader::Reader(const fs::MappedFile &file, const Options &dialect)
+    : Reader(file.view(), dialect) {}
+
+Reader::Reader(chunk_reader input, const Options &dialect)
+    : options(dialect), source(std::move(input)), exhausted(false) {}
+
+auto Reader::next_separator() -> usize {
+  while (separators == 0) {
+    if (next_block >= text.size())
+      return std::string_view::npos;
+
+    // the last, partial block goes through a padded copy
+    usize valid = std::min<usize>(64, text.size() - next_block);
+    Masks found;
+    if (valid == 64) {
+      found = masks(text.data() + next_block, options.delimiter,
+                    options.quote);
+    } else {
+      char padded[64] = {};
+      std::memcpy(padded, text.data() + next_block, valid);
+      found = masks(padded, options.delimiter, options.quote);
+      u64 live = (u64{1} << valid) - 1;
+      found.quotes &= live;
+      found.separators &= live;
+    }
+
+    u64 inside = 0;
+    if (options.quote != '\0') {
+      inside = prefix_xor(found.quotes) ^ (quoted ? ~u64{0} : 0);
+      quoted = (inside >> 63) != 0;
+    }
+
+    block = next_block;
+    next_block += 64;
+    separators = found.separators & ~inside;
+  }
+
+  usize at = block + static_cast<usize>(__builtin_ctzll(separators));
+  separators &= separators - 1;
+  return at;
+}
+
+auto Reader::add_field(usize begin, usize end, bool last) -> void {
+  if (last && end > begin && text[end - 1] == '\r')
+    end--;
+
+  if (options.quote == '\0' || begin == end || text[begin] != options.quote) {
+    spans.push_back(Field{begin, end - begin, false});
+    return;
+  }
+
+  begin++;
+  if (end > begin && text[end - 1] == options.quote)
+    end--;
+
+  std::string_view content = text.substr(begin, end - begin);
+  if (content.find(options.quote) == std::string_view::npos) {
+    spans.push_back(Field{begin, end - begin, false});
+    return;
+  }
+
+  // "" inside a quoted field is one quote
+  usize offset = scratch.size();
+  for (usize i = 0; i < content.size(); i++) {
+    scratch.push_back(content[i]);
+    if (content[i] == options.quote && i + 1 < content.size() &&
+        content[i + 1] == options.quote)
+      i++;
+  }
+
+  spans.push_back(Field{offset, scratch.size() - offset, true});
+}
+
+auto Reader::refill(usize keep) -> void {
+  // the record in progress moves to the front, the buffer only grows when
+  // it alone fills it
+  usize kept = text.size() - keep;
+  if (buffer.empty())
+    buffer.resize(std::max<usize>(options.chunk_size, 1));
+
+  if (kept > 0)
+    std::memmove(buffer.data(), text.data() + keep, kept);
+
+  if (kept == buffer.size())
+    buffer.resize(buffer.size() * 2);
+
+  usize read = source(std::span<char>(buffer.data() + kept,
+                                      buffer.size() - kept));
+  if (read == 0)
+    exhausted = true;
+
+  text = std::string_view(buffer.data(), kept + read);
+  pos = 0;
+  block = 0;
+  next_block = 0;
+  separators = 0;
+  quoted = false;
+}
+
+auto Reader::next() -> bool {
+  spans.clear();
+  views.clear();
+  scratch.clear();
+
+  usize start = pos;
+  while (true) {
+    usize at = next_separator();
+    if (at == std::string_view::npos) {
+      // out of data mid-record: pull more and scan the record again
+      if (!exhausted) {
+        refill(pos);
+        spans.clear();
+        scratch.clear();
+        start = 0;
+        continue;
+      }
+
+      if (spans.empty() && start >= text.size())
+        return false;
+
+      add_field(start, text.size(), true);
+      pos = text.size();
+      break;
+    }
+
+    bool newline = text[at] == '\n';
+    add_field(start, at, newline);
+    start = at + 1;
+    if (newline) {
+      pos = start;
+      break;
+    }
+  }
+
+  for (const auto &span : spans) {
+    const char *base = span.unescaped ? scratch.data() : text.data();
+    views.emplace_back(base + span.offset, span.size);
+  }
+
+  count++;
+  return true;
+}
+
+} // namespace manifold::str::csv
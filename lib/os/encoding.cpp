@@ -0,0 +1,638 @@
+#include "../simd.hpp"
+#include <manifold/os/encoding.hpp>
+
+namespace manifold::str {
+
+namespace {
+
+constexpr u8 kInvalid = 0xff;
+
+/// The characters for 62 and 63, the only ones the base64 alphabets differ in
+struct Symbols {
+  char plus;
+  char slash;
+};
+
+/// Characters of a base64 alphabet by value, and values by character
+struct Base64Tables {
+  Symbols symbols;
+  std::array<char, 64> chars;
+  std::array<u8, 256> values;
+};
+
+constexpr auto make_tables(Symbols symbols) -> Base64Tables {
+  Base64Tables tables{symbols, {}, {}};
+  for (usize i = 0; i < 26; i++) {
+    tables.chars[i] = static_cast<char>('A' + i);
+    tables.chars[26 + i] = static_cast<char>('a' + i);
+  }
+
+  for (usize i = 0; i < 10; i++)
+    tables.chars[52 + i] = static_cast<char>('0' + i);
+
+  tables.chars[62] = symbols.plus;
+  tables.chars[63] = symbols.slash;
+
+  tables.values.fill(kInvalid);
+  for (usize i = 0; i < 64; i++)
+    tables.values[static_cast<u8>(tables.chars[i])] = static_cast<u8>(i);
+
+  return tables;
+}
+
+constexpr Base64Tables kStandard = make_tables({'+', '/'});
+constexpr Base64Tables kUrl = make_tables({'-', '_'});
+
+auto tables_of(base64::Alphabet alphabet) -> const Base64Tables & {
+  return alphabet == base64::Alphabet::Url ? kUrl : kStandard;
+}
+
+constexpr std::array<u8, 256> kHexValues = [] {
+  std::array<u8, 256> values{};
+  values.fill(kInvalid);
+  for (u8 i = 0; i < 10; i++)
+    values['0' + i] = i;
+
+  for (u8 i = 0; i < 6; i++) {
+    values['a' + i] = static_cast<u8>(10 + i);
+    values['A' + i] = static_cast<u8>(10 + i);
+  }
+
+  return values;
+}();
+
+constexpr std::string_view kHexLower = "0123456789abcdef";
+constexpr std::string_view kHexUpper = "0123456789ABCDEF";
+
+// Vector kernels work through whole blocks and return how much input they
+// consumed; the scalar code finishes the rest. Decoders stop before a block
+// with an invalid character, so the scalar code is also what reports it.
+
+using base64_encode_kernel = auto (*)(const u8 *data, usize size, char *out,
+                                      Symbols symbols) -> usize;
+using base64_decode_kernel = auto (*)(const char *text, usize size, u8 *out,
+                                      usize capacity, Symbols symbols)
+    -> usize;
+using hex_encode_kernel = auto (*)(const u8 *data, usize size, char *out,
+                                   const char *digits) -> usize;
+using hex_decode_kernel = auto (*)(const char *text, usize size, u8 *out)
+    -> usize;
+
+struct Kernels {
+  base64_encode_kernel base64_encode;
+  base64_decode_kernel base64_decode;
+  hex_encode_kernel hex_encode;
+  hex_decode_kernel hex_decode;
+};
+
+#ifdef MANIFOLD_SIMD_X86
+/// Adds to each base64 value (0..63) the distance to its character, found
+/// by shuffling a table of the offsets of the six ranges of the alphabet
+/// (Muła's method)
+auto shifts_of(Symbols symbols) -> std::array<char, 16> {
+  return {'a' - 26,
+          '0' - 52,
+          '0' - 52,
+          '0' - 52,
+          '0' - 52,
+          '0' - 52,
+          '0' - 52,
+          '0' - 52,
+          '0' - 52,
+          '0' - 52,
+          '0' - 52,
+          static_cast<char>(symbols.plus - 62),
+          static_cast<char>(symbols.slash - 63),
+          'A',
+          0,
+          0};
+}
+
+MANIFOLD_TARGET("ssse3")
+auto base64_encode_ssse3(const u8 *data, usize size, char *out,
+                         Symbols symbols) -> usize {
+  auto table = shifts_of(symbols);
+  const __m128i shifts =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(table.data()));
+  // bytes s0 s1 s2 of each group go to a 32-bit lane as s1 s0 s2 s1
+  const __m128i spread =
+      _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+  usize i = 0;
+  for (; i + 16 <= size; i += 12, out += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    x = _mm_shuffle_epi8(x, spread);
+
+    // the four 6-bit fields of each lane, moved to the low bits of its bytes
+    __m128i high = _mm_mulhi_epu16(_mm_and_si128(x, _mm_set1_epi32(0x0fc0fc00)),
+                                   _mm_set1_epi32(0x04000040));
+    __m128i low = _mm_mullo_epi16(_mm_and_si128(x, _mm_set1_epi32(0x003f03f0)),
+                                  _mm_set1_epi32(0x01000010));
+    __m128i values = _mm_or_si128(high, low);
+
+    // 0..25 -> 13, 26..51 -> 0, 52..63 -> 1..12
+    __m128i range = _mm_subs_epu8(values, _mm_set1_epi8(51));
+    __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), values);
+    range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+    __m128i chars = _mm_add_epi8(values, _mm_shuffle_epi8(shifts, range));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), chars);
+  }
+
+  return i;
+}
+
+MANIFOLD_TARGET("avx2")
+auto base64_encode_avx2(const u8 *data, usize size, char *out,
+                        Symbols symbols) -> usize {
+  auto table = shifts_of(symbols);
+  const __m256i shifts = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(table.data())));
+  const __m256i spread = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+  usize i = 0;
+  for (; i + 28 <= size; i += 24, out += 32) {
+    // twelve bytes for each 128-bit lane
+    __m256i x = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 12)), 1);
+    x = _mm256_shuffle_epi8(x, spread);
+
+    __m256i high = _mm256_mulhi_epu16(
+        _mm256_and_si256(x, _mm256_set1_epi32(0x0fc0fc00)),
+        _mm256_set1_epi32(0x04000040));
+    __m256i low = _mm256_mullo_epi16(
+        _mm256_and_si256(x, _mm256_set1_epi32(0x003f03f0)),
+        _mm256_set1_epi32(0x01000010));
+    __m256i values = _mm256_or_si256(high, low);
+
+    __m256i range = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+    __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), values);
+    range =
+        _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+    __m256i chars =
+        _mm256_add_epi8(values, _mm256_shuffle_epi8(shifts, range));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), chars);
+  }
+
+  return i;
+}
+
+/// All ones in the bytes of `x` from `first` to `first + count - 1`, with
+/// one signed compare: the range is moved to the bottom of the signed bytes
+MANIFOLD_TARGET("ssse3")
+auto in_range_ssse3(__m128i x, char first, int count) -> __m128i {
+  return _mm_cmplt_epi8(
+      _mm_add_epi8(x, _mm_set1_epi8(static_cast<char>(0x80 - first))),
+      _mm_set1_epi8(static_cast<char>(-128 + count)));
+}
+
+MANIFOLD_TARGET("avx2")
+auto in_range_avx2(__m256i x, char first, int count) -> __m256i {
+  return _mm256_cmpgt_epi8(
+      _mm256_set1_epi8(static_cast<char>(-128 + count)),
+      _mm256_add_epi8(x, _mm256_set1_epi8(static_cast<char>(0x80 - first))));
+}
+
+MANIFOLD_TARGET("ssse3")
+auto base64_decode_ssse3(const char *text, usize size, u8 *out,
+                         usize capacity, Symbols symbols) -> usize {
+  usize i = 0;
+  for (usize o = 0; i + 16 <= size && o + 16 <= capacity; i += 16, o += 12) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i));
+    __m128i upper = in_range_ssse3(x, 'A', 26);
+    __m128i lower = in_range_ssse3(x, 'a', 26);
+    __m128i digit = in_range_ssse3(x, '0', 10);
+    __m128i plus = _mm_cmpeq_epi8(x, _mm_set1_epi8(symbols.plus));
+    __m128i slash = _mm_cmpeq_epi8(x, _mm_set1_epi8(symbols.slash));
+    __m128i valid =
+        _mm_or_si128(_mm_or_si128(upper, lower),
+                     _mm_or_si128(_mm_or_si128(digit, plus), slash));
+    if (_mm_movemask_epi8(valid) != 0xffff)
+      break;
+
+    __m128i offset = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                     _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+        _mm_or_si128(
+            _mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+            _mm_or_si128(
+                _mm_and_si128(plus, _mm_set1_epi8(static_cast<char>(
+                                        62 - symbols.plus))),
+                _mm_and_si128(slash, _mm_set1_epi8(static_cast<char>(
+                                         63 - symbols.slash))))));
+    __m128i values = _mm_add_epi8(x, offset);
+
+    // pairs of 6-bit values to 12 bits, pairs of those to 24, then the three
+    // bytes of each lane to the front in big-endian order
+    __m128i merged =
+        _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    packed = _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                                    14, 13, 12, -1, -1, -1,
+                                                    -1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + o), packed);
+  }
+
+  return i;
+}
+
+MANIFOLD_TARGET("avx2")
+auto base64_decode_avx2(const char *text, usize size, u8 *out,
+                        usize capacity, Symbols symbols) -> usize {
+  usize i = 0;
+  for (usize o = 0; i + 32 <= size && o + 32 <= capacity; i += 32, o += 24) {
+    __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i));
+    __m256i upper = in_range_avx2(x, 'A', 26);
+    __m256i lower = in_range_avx2(x, 'a', 26);
+    __m256i digit = in_range_avx2(x, '0', 10);
+    __m256i plus = _mm256_cmpeq_epi8(x, _mm256_set1_epi8(symbols.plus));
+    __m256i slash = _mm256_cmpeq_epi8(x, _mm256_set1_epi8(symbols.slash));
+    __m256i valid =
+        _mm256_or_si256(_mm256_or_si256(upper, lower),
+                        _mm256_or_si256(_mm256_or_si256(digit, plus), slash));
+    if (_mm256_movemask_epi8(valid) != -1)
+      break;
+
+    __m256i offset = _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                        _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+        _mm256_or_si256(
+            _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')),
+            _mm256_or_si256(
+                _mm256_and_si256(plus, _mm256_set1_epi8(static_cast<char>(
+                                           62 - symbols.plus))),
+                _mm256_and_si256(slash, _mm256_set1_epi8(static_cast<char>(
+                                            63 - symbols.slash))))));
+    __m256i values = _mm256_add_epi8(x, offset);
+
+    __m256i merged =
+        _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    __m256i packed = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+    packed = _mm256_shuffle_epi8(
+        packed, _mm256_broadcastsi128_si256(_mm_setr_epi8(
+                    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+    // twelve bytes at the front of each lane, made contiguous
+    packed = _mm256_permutevar8x32_epi32(
+        packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + o), packed);
+  }
+
+  return i;
+}
+
+MANIFOLD_TARGET("ssse3")
+auto hex_encode_ssse3(const u8 *data, usize size, char *out,
+                      const char *digits) -> usize {
+  const __m128i table =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(digits));
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+
+  usize i = 0;
+  for (; i + 16 <= size; i += 16, out += 32) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    __m128i high = _mm_shuffle_epi8(
+        table, _mm_and_si128(_mm_srli_epi16(x, 4), nibble));
+    __m128i low = _mm_shuffle_epi8(table, _mm_and_si128(x, nibble));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                     _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16),
+                     _mm_unpackhi_epi8(high, low));
+  }
+
+  return i;
+}
+
+MANIFOLD_TARGET("avx2")
+auto hex_encode_avx2(const u8 *data, usize size, char *out,
+                     const char *digits) -> usize {
+  const __m256i table = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(digits)));
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+
+  usize i = 0;
+  for (; i + 32 <= size; i += 32, out += 64) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    __m256i high = _mm256_shuffle_epi8(
+        table, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+    __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(x, nibble));
+
+    // the unpacks interleave within lanes: bytes 0-7 and 16-23, then 8-15
+    // and 24-31
+    __m256i first = _mm256_unpacklo_epi8(high, low);
+    __m256i second = _mm256_unpackhi_epi8(high, low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out),
+                        _mm256_permute2x128_si256(first, second, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 32),
+                        _mm256_permute2x128_si256(first, second, 0x31));
+  }
+
+  return i;
+}
+
+MANIFOLD_TARGET("ssse3")
+auto hex_values_ssse3(__m128i x, bool &valid) -> __m128i {
+  __m128i digit = in_range_ssse3(x, '0', 10);
+  __m128i lower = in_range_ssse3(x, 'a', 6);
+  __m128i upper = in_range_ssse3(x, 'A', 6);
+  valid = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(digit, lower), upper)) ==
+          0xffff;
+
+  __m128i offset =
+      _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(-'0')),
+                   _mm_or_si128(_mm_and_si128(lower, _mm_set1_epi8(10 - 'a')),
+                                _mm_and_si128(upper, _mm_set1_epi8(10 - 'A'))));
+  // each pair of nibbles to one 16-bit lane, high nibble first
+  return _mm_maddubs_epi16(_mm_add_epi8(x, offset), _mm_set1_epi16(0x0110));
+}
+
+MANIFOLD_TARGET("ssse3")
+auto hex_decode_ssse3(const char *text, usize size, u8 *out) -> usize {
+  usize i = 0;
+  for (; i + 32 <= size; i += 32, out += 16) {
+    bool first_valid;
+    bool second_valid;
+    __m128i first = hex_values_ssse3(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i)),
+        first_valid);
+    __m128i second = hex_values_ssse3(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i + 16)),
+        second_valid);
+    if (!first_valid || !second_valid)
+      break;
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                     _mm_packus_epi16(first, second));
+  }
+
+  return i;
+}
+
+MANIFOLD_TARGET("avx2")
+auto hex_decode_avx2(const char *text, usize size, u8 *out) -> usize {
+  usize i = 0;
+  for (; i + 32 <= size; i += 32, out += 16) {
+    __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i));
+    __m256i digit = in_range_avx2(x, '0', 10);
+    __m256i lower = in_range_avx2(x, 'a', 6);
+    __m256i upper = in_range_avx2(x, 'A', 6);
+    __m256i valid =
+        _mm256_or_si256(_mm256_or_si256(digit, lower), upper);
+    if (_mm256_movemask_epi8(valid) != -1)
+      break;
+
+    __m256i offset = _mm256_or_si256(
+        _mm256_and_si256(digit, _mm256_set1_epi8(-'0')),
+        _mm256_or_si256(_mm256_and_si256(lower, _mm256_set1_epi8(10 - 'a')),
+                        _mm256_and_si256(upper, _mm256_set1_epi8(10 - 'A'))));
+    __m256i pairs = _mm256_maddubs_epi16(_mm256_add_epi8(x, offset),
+                                         _mm256_set1_epi16(0x0110));
+
+    // eight bytes per lane, then the two lanes' halves side by side
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(pairs, pairs),
+                                              0xd8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                     _mm256_castsi256_si128(packed));
+  }
+
+  return i;
+}
+#endif
+
+auto kernels() -> const Kernels & {
+  static const Kernels selected = []() -> Kernels {
+#ifdef MANIFOLD_SIMD_X86
+    if (simd::features().avx2)
+      return {base64_encode_avx2, base64_decode_avx2, hex_encode_avx2,
+              hex_decode_avx2};
+    if (simd::features().ssse3)
+      return {base64_encode_ssse3, base64_decode_ssse3, hex_encode_ssse3,
+              hex_decode_ssse3};
+#endif
+    return {nullptr, nullptr, nullptr, nullptr};
+  }();
+
+  return selected;
+}
+
+/// Decodes whole groups of four characters, returning the offset of the
+/// first invalid one or `npos`
+auto base64_decode_scalar(const char *text, usize size, u8 *out,
+                          const std::array<u8, 256> &values) -> usize {
+  for (usize i = 0; i < size; i += 4, out += 3) {
+    u32 word = 0;
+    for (usize k = 0; k < 4; k++) {
+      u8 value = values[static_cast<u8>(text[i + k])];
+      if (value == kInvalid)
+        return i + k;
+
+      word = word << 6 | value;
+    }
+
+    out[0] = static_cast<u8>(word >> 16);
+    out[1] = static_cast<u8>(word >> 8);
+    out[2] = static_cast<u8>(word);
+  }
+
+  return std::string_view::npos;
+}
+
+/// `text` without the padding (at most two '=') of a base64 string
+auto unpadded(std::string_view text) -> std::string_view {
+  for (int i = 0; i < 2 && !text.empty() && text.back() == '='; i++)
+    text.remove_suffix(1);
+
+  return text;
+}
+
+} // namespace
+
+namespace base64 {
+
+auto decoded_size(std::string_view text) -> usize {
+  usize size = unpadded(text).size();
+  return size / 4 * 3 + (size % 4 > 1 ? size % 4 - 1 : 0);
+}
+
+auto encode(std::span<const u8> data, std::span<char> out, Alphabet alphabet)
+    -> usize {
+  usize size = encoded_size(data.size(), alphabet);
+  if (size > out.size())
+    return 0;
+
+  const Base64Tables &tables = tables_of(alphabet);
+  char *at = out.data();
+  usize i = 0;
+  if (auto kernel = kernels().base64_encode) {
+    i = kernel(data.data(), data.size(), at, tables.symbols);
+    at += i / 3 * 4;
+  }
+
+  for (; i + 3 <= data.size(); i += 3, at += 4) {
+    u32 word = static_cast<u32>(data[i]) << 16 |
+               static_cast<u32>(data[i + 1]) << 8 | data[i + 2];
+    at[0] = tables.chars[word >> 18];
+    at[1] = tables.chars[(word >> 12) & 63];
+    at[2] = tables.chars[(word >> 6) & 63];
+    at[3] = tables.chars[word & 63];
+  }
+
+  if (usize rest = data.size() - i; rest > 0) {
+    u32 word = static_cast<u32>(data[i]) << 16 |
+               (rest > 1 ? static_cast<u32>(data[i + 1]) << 8 : 0);
+    *at++ = tables.chars[word >> 18];
+    *at++ = tables.chars[(word >> 12) & 63];
+    if (rest > 1)
+      *at++ = tables.chars[(word >> 6) & 63];
+
+    if (alphabet == Alphabet::Standard) {
+      *at++ = '=';
+      if (rest == 1)
+        *at++ = '=';
+    }
+  }
+
+  return size;
+}
+
+auto encode(std::span<const u8> data, Alphabet alphabet) -> std::string {
+  std::string result(encoded_size(data.size(), alphabet), '\0');
+  encode(data, result, alphabet);
+  return result;
+}
+
+auto encode(std::string_view data, Alphabet alphabet) -> std::string {
+  return encode(std::span(reinterpret_cast<const u8 *>(data.data()),
+                          data.size()),
+                alphabet);
+}
+
+auto decode(std::string_view text, std::span<u8> out, Alphabet alphabet)
+    -> manifold::result<usize, DecodeError> {
+  std::string_view body = unpadded(text);
+  if ((body.size() != text.size() && text.size() % 4 != 0) ||
+      body.size() % 4 == 1)
+    return fail(DecodeError{DecodeError::Kind::BadLength, text.size()});
+
+  usize size = decoded_size(text);
+  if (size > out.size())
+    return fail(DecodeError{DecodeError::Kind::BufferTooSmall, 0});
+
+  const Base64Tables &tables = tables_of(alphabet);
+  usize whole = body.size() - body.size() % 4;
+  usize i = 0;
+  if (auto kernel = kernels().base64_decode)
+    i = kernel(body.data(), whole, out.data(), whole / 4 * 3, tables.symbols);
+
+  usize bad = base64_decode_scalar(body.data() + i, whole - i,
+                                   out.data() + i / 4 * 3, tables.values);
+  if (bad != std::string_view::npos)
+    return fail(DecodeError{DecodeError::Kind::InvalidChar, i + bad});
+
+  // two or three characters left make one or two bytes
+  if (usize rest = body.size() - whole; rest > 0) {
+    u32 word = 0;
+    for (usize k = 0; k < rest; k++) {
+      u8 value = tables.values[static_cast<u8>(body[whole + k])];
+      if (value == kInvalid)
+        return fail(DecodeError{DecodeError::Kind::InvalidChar, whole + k});
+
+      word |= static_cast<u32>(value) << (18 - 6 * k);
+    }
+
+    u8 *at = out.data() + whole / 4 * 3;
+    at[0] = static_cast<u8>(word >> 16);
+    if (rest == 3)
+      at[1] = static_cast<u8>(word >> 8);
+  }
+
+  return size;
+}
+
+auto decode(std::string_view text, Alphabet alphabet)
+    -> manifold::result<std::vector<u8>, DecodeError> {
+  std::vector<u8> result(decoded_size(text));
+  auto written = decode(text, result, alphabet);
+  if (written.has_error())
+    return fail(written.error());
+
+  return result;
+}
+
+} // namespace base64
+
+namespace hex {
+
+auto encode(std::span<const u8> data, std::span<char> out, bool uppercase)
+    -> usize {
+  if (data.size() * 2 > out.size())
+    return 0;
+
+  const char *digits = uppercase ? kHexUpper.data() : kHexLower.data();
+  usize i = 0;
+  if (auto kernel = kernels().hex_encode)
+    i = kernel(data.data(), data.size(), out.data(), digits);
+
+  for (; i < data.size(); i++) {
+    out[2 * i] = digits[data[i] >> 4];
+    out[2 * i + 1] = digits[data[i] & 15];
+  }
+
+  return data.size() * 2;
+}
+
+auto encode(std::span<const u8> data, bool uppercase) -> std::string {
+  std::string result(data.size() * 2, '\0');
+  encode(data, result, uppercase);
+  return result;
+}
+
+auto encode(std::string_view data, bool uppercase) -> std::string {
+  return encode(std::span(reinterpret_cast<const u8 *>(data.data()),
+                          data.size()),
+                uppercase);
+}
+
+auto decode(std::string_view text, std::span<u8> out)
+    -> manifold::result<usize, DecodeError> {
+  if (text.size() % 2 != 0)
+    return fail(DecodeError{DecodeError::Kind::BadLength, text.size()});
+
+  usize size = text.size() / 2;
+  if (size > out.size())
+    return fail(DecodeError{DecodeError::Kind::BufferTooSmall, 0});
+
+  usize i = 0;
+  if (auto kernel = kernels().hex_decode)
+    i = kernel(text.data(), text.size(), out.data());
+
+  for (; i < text.size(); i += 2) {
+    u8 high = kHexValues[static_cast<u8>(text[i])];
+    u8 low = kHexValues[static_cast<u8>(text[i + 1])];
+    if (high == kInvalid || low == kInvalid) {
+      usize at = high == kInvalid ? i : i + 1;
+      return fail(DecodeError{DecodeError::Kind::InvalidChar, at});
+    }
+
+    out[i / 2] = static_cast<u8>(high << 4 | low);
+  }
+
+  return size;
+}
+
+auto decode(std::string_view text)
+    -> manifold::result<std::vector<u8>, DecodeError> {
+  std::vector<u8> result(text.size() / 2);
+  auto written = decode(text, result);
+  if (written.has_error())
+    return fail(written.error());
+
+  return result;
+}
+
+} // namespace hex
+
+} // namespace manifold::str
@@ -0,0 +1,309 @@
+#include <manifold/os/format.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+
+#ifdef MANIFOLD_PLATFORM_WINDOWS
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace manifold::str {
+
+// only ever reached while a format string is parsed at compile time
+auto format_error(const char *) -> void {}
+
+namespace {
+
+/// Output buffer that is handed on (`drain`) only when it is full, so each
+/// field costs plain memory writes rather than a call into its destination
+struct Sink {
+  char *begin;
+  char *cursor;
+  char *end;
+
+  /// Empties the buffer into the destination, false once no more output
+  /// can be taken
+  bool (*drain)(Sink &);
+  void *target;
+  bool stopped = false;
+
+  auto put(std::string_view str) -> void {
+    while (!str.empty()) {
+      if (cursor == end && !make_room())
+        return;
+
+      usize size = std::min(str.size(), static_cast<usize>(end - cursor));
+      std::memcpy(cursor, str.data(), size);
+      cursor += size;
+      str.remove_prefix(size);
+    }
+  }
+
+  auto fill(char ch, usize count) -> void {
+    while (count > 0) {
+      if (cursor == end && !make_room())
+        return;
+
+      usize size = std::min(count, static_cast<usize>(end - cursor));
+      std::memset(cursor, ch, size);
+      cursor += size;
+      count -= size;
+    }
+  }
+
+  auto make_room() -> bool {
+    if (!stopped && !drain(*this))
+      stopped = true;
+
+    return !stopped && cursor != end;
+  }
+
+  auto flush() -> void {
+    if (!stopped && cursor != begin && !drain(*this))
+      stopped = true;
+  }
+};
+
+/// Writes `body` padded to the spec's width; `sign` leading bytes of a
+/// number stay in front of zero padding
+auto pad(Sink &sink, const FormatSpec &spec, std::string_view body,
+         char align, usize sign = 0) -> void {
+  usize padding = spec.width > body.size() ? spec.width - body.size() : 0;
+  if (spec.zero && spec.align == '\0') {
+    sink.put(body.substr(0, sign));
+    sink.fill('0', padding);
+    sink.put(body.substr(sign));
+    return;
+  }
+
+  if (spec.align != '\0')
+    align = spec.align;
+
+  usize before = align == '>' ? padding : align == '^' ? padding / 2 : 0;
+  sink.fill(spec.fill, before);
+  sink.put(body);
+  sink.fill(spec.fill, padding - before);
+}
+
+auto write_integer(Sink &sink, const FormatSpec &spec, u64 magnitude,
+                   bool negative) -> void {
+  char buffer[72];
+  usize sign = 0;
+  if (negative || spec.plus)
+    buffer[sign++] = negative ? '-' : '+';
+
+  int base = 10;
+  switch (spec.type) {
+  case 'x':
+  case 'X':
+    base = 16;
+    break;
+  case 'b':
+    base = 2;
+    break;
+  case 'o':
+    base = 8;
+    break;
+  default:
+    break;
+  }
+
+  usize size;
+  if (base == 10) {
+    size = sign + format_int(magnitude, std::span(buffer).subspan(sign));
+  } else {
+    auto [end, error] =
+        std::to_chars(buffer + sign, buffer + sizeof(buffer), magnitude, base);
+    size = static_cast<usize>(end - buffer);
+  }
+
+  if (spec.type == 'X')
+    to_upper_in_place(std::span(buffer + sign, size - sign));
+
+  pad(sink, spec, std::string_view(buffer, size), '>', sign);
+}
+
+template <typename T>
+auto write_float(Sink &sink, const FormatSpec &spec, T value) -> void {
+  // fixed notation of the largest double at the largest precision fits
+  char buffer[512];
+  usize size = 0;
+  if (spec.plus && !std::signbit(value))
+    buffer[size++] = '+';
+
+  std::span<char> out = std::span(buffer).subspan(size);
+  if (spec.type == '\0' && spec.precision < 0) {
+    size += format_float(value, out);
+  } else {
+    auto format = spec.type == 'f'   ? std::chars_format::fixed
+                  : spec.type == 'e' ? std::chars_format::scientific
+                                     : std::chars_format::general;
+    // a type without a precision means 6 digits, as in printf
+    int precision = spec.precision < 0 ? 6 : spec.precision;
+    auto [end, error] = std::to_chars(out.data(), out.data() + out.size(),
+                                      value, format, precision);
+    size = static_cast<usize>(end - buffer);
+  }
+
+  usize sign = size > 0 && (buffer[0] == '-' || buffer[0] == '+') ? 1 : 0;
+  if (!std::isfinite(value) && spec.zero) {
+    // "00inf" reads as a number, so the fill pads it instead
+    FormatSpec padded = spec;
+    padded.zero = false;
+    pad(sink, padded, std::string_view(buffer, size), '>');
+    return;
+  }
+
+  pad(sink, spec, std::string_view(buffer, size), '>', sign);
+}
+
+auto write_argument(Sink &sink, const FormatSpec &spec, const FormatArg &arg)
+    -> void {
+  switch (arg.kind) {
+  case FormatArg::Kind::Bool:
+    pad(sink, spec, arg.boolean ? "true" : "false", '<');
+    break;
+  case FormatArg::Kind::Char:
+    pad(sink, spec, std::string_view(&arg.ch, 1), '<');
+    break;
+  case FormatArg::Kind::Int: {
+    auto magnitude = static_cast<u64>(arg.integer);
+    write_integer(sink, spec, arg.integer < 0 ? 0 - magnitude : magnitude,
+                  arg.integer < 0);
+    break;
+  }
+  case FormatArg::Kind::Uint:
+    write_integer(sink, spec, arg.uinteger, false);
+    break;
+  case FormatArg::Kind::Float:
+    write_float(sink, spec, arg.floating);
+    break;
+  case FormatArg::Kind::Float32:
+    write_float(sink, spec, arg.single);
+    break;
+  case FormatArg::Kind::String: {
+    std::string_view str(arg.string.data, arg.string.size);
+    if (spec.precision >= 0)
+      str = str.substr(0, static_cast<usize>(spec.precision));
+
+    pad(sink, spec, str, '<');
+    break;
+  }
+  case FormatArg::Kind::Pointer: {
+    char buffer[2 + 16] = {'0', 'x'};
+    auto address = reinterpret_cast<std::uintptr_t>(arg.pointer);
+    auto [end, error] =
+        std::to_chars(buffer + 2, buffer + sizeof(buffer), address, 16);
+    pad(sink, spec,
+        std::string_view(buffer, static_cast<usize>(end - buffer)), '>');
+    break;
+  }
+  }
+}
+
+/// Literal text, with "{{" and "}}" collapsed if the parser saw any
+auto write_literal(Sink &sink, std::string_view text, const FormatField &field)
+    -> void {
+  std::string_view literal = text.substr(
+      field.literal_begin, field.literal_end - field.literal_begin);
+  if (!field.escaped) {
+    sink.put(literal);
+    return;
+  }
+
+  usize start = 0;
+  for (usize i = 0; i + 1 < literal.size(); i++) {
+    if ((literal[i] == '{' || literal[i] == '}') &&
+        literal[i + 1] == literal[i]) {
+      sink.put(literal.substr(start, i + 1 - start));
+      start = i + 2;
+      i++;
+    }
+  }
+
+  sink.put(literal.substr(start));
+}
+
+auto run(Sink &sink, const ParsedFormat &fmt, std::span<const FormatArg> args)
+    -> void {
+  for (usize i = 0; i < fmt.fields.size(); i++) {
+    write_literal(sink, fmt.text, fmt.fields[i]);
+    write_argument(sink, fmt.fields[i].spec, args[i]);
+  }
+
+  write_literal(sink, fmt.text, fmt.tail);
+  sink.flush();
+}
+
+/// Bytes staged on the stack before they go to a string, builder or fd
+constexpr usize kStage = 512;
+
+template <typename Target> auto append_to(Sink &sink) -> bool {
+  auto *target = static_cast<Target *>(sink.target);
+  target->append(std::string_view(
+      sink.begin, static_cast<usize>(sink.cursor - sink.begin)));
+  sink.cursor = sink.begin;
+  return true;
+}
+
+} // namespace
+
+auto vformat(const ParsedFormat &fmt, std::span<const FormatArg> args)
+    -> std::string {
+  std::string result;
+  char stage[kStage];
+  Sink sink{stage, stage, stage + kStage, append_to<std::string>, &result};
+  run(sink, fmt, args);
+  return result;
+}
+
+auto vformat_to(Builder &out, const ParsedFormat &fmt,
+                std::span<const FormatArg> args) -> void {
+  char stage[kStage];
+  Sink sink{stage, stage, stage + kStage, append_to<Builder>, &out};
+  run(sink, fmt, args);
+}
+
+auto vformat_to(std::span<char> out, const ParsedFormat &fmt,
+                std::span<const FormatArg> args) -> usize {
+  // the caller's buffer is the sink, it cannot be drained
+  Sink sink{out.data(), out.data(), out.data() + out.size(),
+            [](Sink &) { return false; }, nullptr};
+  run(sink, fmt, args);
+  return static_cast<usize>(sink.cursor - sink.begin);
+}
+
+auto vprint(int fd, const ParsedFormat &fmt, std::span<const FormatArg> args)
+    -> bool {
+  char stage[4096];
+  auto drain = [](Sink &sink) {
+    int target = *static_cast<int *>(sink.target);
+    const char *at = sink.begin;
+    while (at < sink.cursor) {
+      auto remaining = static_cast<usize>(sink.cursor - at);
+#ifdef MANIFOLD_PLATFORM_WINDOWS
+      int n = ::_write(target, at, static_cast<unsigned>(remaining));
+#else
+      ssize_t n = ::write(target, at, remaining);
+      if (n < 0 && errno == EINTR)
+        continue;
+#endif
+      if (n <= 0)
+        return false;
+
+      at += n;
+    }
+
+    sink.cursor = sink.begin;
+    return true;
+  };
+
+  Sink sink{stage, stage, stage + sizeof(stage), drain, &fd};
+  run(sink, fmt, args);
+  return !sink.stopped;
+}
+
+} // namespace manifold::str
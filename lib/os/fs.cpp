@@ -95,4 +95,21 @@ auto search(const path_type &dir,
   return manifold::fail(fs::Error::NoFileExists);
 }
 
+auto search_all(const path_type &dir,
+                const std::function<bool(const path_type &path)> &matcher)
+    -> manifold::result<PathTable, Error> {
+  if (!manifold::fs::path_exists(dir)) {
+    return manifold::fail(fs::Error::NoFileExists);
+  }
+
+  PathTable table;
+  for (auto &p : std::filesystem::recursive_directory_iterator(dir)) {
+    if (matcher(p.path())) {
+      table.insert(p.path());
+    }
+  }
+
+  return table;
+}
+
 } // namespace manifold::fs
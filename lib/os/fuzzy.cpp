@@ -0,0 +1,538 @@
+#include "../simd.hpp"
+#include <manifold/os/str.hpp>
+
+namespace manifold::str {
+
+namespace {
+
+/// Bit i of word w of a byte's masks is set if byte 64 * w + i of the
+/// pattern is that byte; patterns of one word keep them on the stack
+class MatchMasks {
+public:
+  explicit MatchMasks(std::string_view pattern)
+      : size(pattern.size()), words((pattern.size() + 63) / 64) {
+    if (words > 1) {
+      large.assign(256 * words, 0);
+      masks = large.data();
+    } else {
+      small.fill(0);
+    }
+
+    for (usize i = 0; i < pattern.size(); i++)
+      masks[static_cast<u8>(pattern[i]) * words + i / 64] |= u64{1}
+                                                             << (i % 64);
+  }
+
+  MatchMasks(const MatchMasks &) = delete;
+  auto operator=(const MatchMasks &) -> MatchMasks & = delete;
+
+  auto get(char ch) const -> const u64 * {
+    return masks + static_cast<u8>(ch) * words;
+  }
+
+  usize size;
+  usize words;
+
+private:
+  std::array<u64, 256> small;
+  std::vector<u64> large;
+  u64 *masks = small.data();
+};
+
+/// True once the distance so far, less one edit for each byte of `text`
+/// still to come, is beyond `max`
+auto hopeless(usize score, usize remaining, usize max) -> bool {
+  return score > remaining && score - remaining > max;
+}
+
+// In the column for text byte j, bit i of `vp` (`vn`) is set if the distance
+// from pattern[0..i] to text[0..j] is one more (less) than from
+// pattern[0..i-1]; the score is the distance for the whole pattern, and the
+// text is given up on (returning `max + 1`) once it cannot come back under
+// `max`.
+
+auto levenshtein_word(const MatchMasks &pattern, std::string_view text,
+                      usize max) -> usize {
+  u64 last = u64{1} << (pattern.size - 1);
+  u64 vp = ~u64{0};
+  u64 vn = 0;
+  usize score = pattern.size;
+  for (usize j = 0; j < text.size(); j++) {
+    u64 eq = *pattern.get(text[j]);
+    u64 d0 = (((eq & vp) + vp) ^ vp) | eq | vn;
+    u64 hp = vn | ~(d0 | vp);
+    u64 hn = d0 & vp;
+    score += (hp & last) != 0;
+    score -= (hn & last) != 0;
+    if (hopeless(score, text.size() - j - 1, max))
+      return max + 1;
+
+    hp = (hp << 1) | 1;
+    hn <<= 1;
+    vp = hn | ~(d0 | hp);
+    vn = hp & d0;
+  }
+
+  return score;
+}
+
+/// `levenshtein_word` for patterns longer than 64 bytes: each word takes the
+/// horizontal difference out of the top of the word below it
+auto levenshtein_blocks(const MatchMasks &pattern, std::string_view text,
+                        usize max) -> usize {
+  u64 last = u64{1} << ((pattern.size - 1) % 64);
+  std::vector<u64> vp(pattern.words, ~u64{0});
+  std::vector<u64> vn(pattern.words, 0);
+  usize score = pattern.size;
+  for (usize j = 0; j < text.size(); j++) {
+    const u64 *eq = pattern.get(text[j]);
+    u64 hp_carry = 1;
+    u64 hn_carry = 0;
+    for (usize w = 0; w < pattern.words; w++) {
+      u64 x = eq[w] | hn_carry;
+      u64 d0 = (((x & vp[w]) + vp[w]) ^ vp[w]) | x | vn[w];
+      u64 hp = vn[w] | ~(d0 | vp[w]);
+      u64 hn = d0 & vp[w];
+
+      u64 hp_in = hp_carry;
+      u64 hn_in = hn_carry;
+      u64 top = w + 1 < pattern.words ? u64{1} << 63 : last;
+      hp_carry = (hp & top) != 0;
+      hn_carry = (hn & top) != 0;
+
+      hp = (hp << 1) | hp_in;
+      hn = (hn << 1) | hn_in;
+      vp[w] = hn | ~(d0 | hp);
+      vn[w] = hp & d0;
+    }
+
+    score += hp_carry;
+    score -= hn_carry;
+    if (hopeless(score, text.size() - j - 1, max))
+      return max + 1;
+  }
+
+  return score;
+}
+
+/// Hyyrö's extension of `levenshtein_word` to transpositions: a match of the
+/// previous text byte one row up, next to a mismatch, is a diagonal step
+auto damerau_word(const MatchMasks &pattern, std::string_view text) -> usize {
+  u64 last = u64{1} << (pattern.size - 1);
+  u64 vp = ~u64{0};
+  u64 vn = 0;
+  u64 d0 = 0;
+  u64 previous = 0;
+  usize score = pattern.size;
+  for (char ch : text) {
+    u64 eq = *pattern.get(ch);
+    u64 transposed = ((~d0 & eq) << 1) & previous;
+    d0 = (((eq & vp) + vp) ^ vp) | eq | vn | transposed;
+    u64 hp = vn | ~(d0 | vp);
+    u64 hn = d0 & vp;
+    score += (hp & last) != 0;
+    score -= (hn & last) != 0;
+
+    hp = (hp << 1) | 1;
+    hn <<= 1;
+    vp = hn | ~(d0 | hp);
+    vn = hp & d0;
+    previous = eq;
+  }
+
+  return score;
+}
+
+auto damerau_blocks(const MatchMasks &pattern, std::string_view text)
+    -> usize {
+  u64 last = u64{1} << ((pattern.size - 1) % 64);
+  std::vector<u64> vp(pattern.words, ~u64{0});
+  std::vector<u64> vn(pattern.words, 0);
+  std::vector<u64> d0(pattern.words, 0);
+  std::vector<u64> previous(pattern.words, 0);
+  usize score = pattern.size;
+  for (char ch : text) {
+    const u64 *eq = pattern.get(ch);
+    u64 hp_carry = 1;
+    u64 hn_carry = 0;
+    u64 transposed_carry = 0;
+    for (usize w = 0; w < pattern.words; w++) {
+      u64 unmatched = ~d0[w] & eq[w];
+      u64 transposed = ((unmatched << 1) | transposed_carry) & previous[w];
+      transposed_carry = unmatched >> 63;
+
+      u64 x = eq[w] | hn_carry;
+      d0[w] = (((x & vp[w]) + vp[w]) ^ vp[w]) | x | vn[w] | transposed;
+      u64 hp = vn[w] | ~(d0[w] | vp[w]);
+      u64 hn = d0[w] & vp[w];
+
+      u64 hp_in = hp_carry;
+      u64 hn_in = hn_carry;
+      u64 top = w + 1 < pattern.words ? u64{1} << 63 : last;
+      hp_carry = (hp & top) != 0;
+      hn_carry = (hn & top) != 0;
+
+      hp = (hp << 1) | hp_in;
+      hn = (hn << 1) | hn_in;
+      vp[w] = hn | ~(d0[w] | hp);
+      vn[w] = hp & d0[w];
+      previous[w] = eq[w];
+    }
+
+    score += hp_carry;
+    score -= hn_carry;
+  }
+
+  return score;
+}
+
+auto levenshtein_bounded(const MatchMasks &pattern, std::string_view text,
+                         usize max) -> usize {
+  if (pattern.size == 0)
+    return text.size();
+
+  if (pattern.words == 1)
+    return levenshtein_word(pattern, text, max);
+
+  return levenshtein_blocks(pattern, text, max);
+}
+
+/// Drops the prefix and suffix `a` and `b` share, which no edit touches,
+/// and orders them shorter first
+auto trim_common(std::string_view &a, std::string_view &b) -> void {
+  usize prefix = 0;
+  while (prefix < a.size() && prefix < b.size() && a[prefix] == b[prefix])
+    prefix++;
+
+  a.remove_prefix(prefix);
+  b.remove_prefix(prefix);
+
+  usize suffix = 0;
+  while (suffix < a.size() && suffix < b.size() &&
+         a[a.size() - suffix - 1] == b[b.size() - suffix - 1])
+    suffix++;
+
+  a.remove_suffix(suffix);
+  b.remove_suffix(suffix);
+  if (a.size() > b.size())
+    std::swap(a, b);
+}
+
+using batch_kernel = auto (*)(const MatchMasks &, const std::string_view *,
+                              usize *) -> void;
+
+#ifdef MANIFOLD_SIMD_X86
+/// `levenshtein_word` against four texts, one per 64-bit lane; a lane's
+/// score stops moving once its text runs out
+MANIFOLD_TARGET("avx2")
+auto levenshtein_avx2(const MatchMasks &pattern, const std::string_view *texts,
+                      usize *out) -> void {
+  usize longest = 0;
+  for (usize lane = 0; lane < 4; lane++)
+    longest = std::max(longest, texts[lane].size());
+
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  const __m256i one = _mm256_set1_epi64x(1);
+  const __m256i last =
+      _mm256_set1_epi64x(static_cast<i64>(u64{1} << (pattern.size - 1)));
+  const __m256i sizes = _mm256_set_epi64x(
+      static_cast<i64>(texts[3].size()), static_cast<i64>(texts[2].size()),
+      static_cast<i64>(texts[1].size()), static_cast<i64>(texts[0].size()));
+
+  __m256i vp = ones;
+  __m256i vn = _mm256_setzero_si256();
+  __m256i score = _mm256_set1_epi64x(static_cast<i64>(pattern.size));
+  alignas(32) u64 lanes[4];
+  for (usize j = 0; j < longest; j++) {
+    for (usize lane = 0; lane < 4; lane++)
+      lanes[lane] =
+          j < texts[lane].size() ? *pattern.get(texts[lane][j]) : 0;
+
+    __m256i eq = _mm256_load_si256(reinterpret_cast<const __m256i *>(lanes));
+    __m256i active =
+        _mm256_cmpgt_epi64(sizes, _mm256_set1_epi64x(static_cast<i64>(j)));
+
+    __m256i sum = _mm256_add_epi64(_mm256_and_si256(eq, vp), vp);
+    __m256i d0 =
+        _mm256_or_si256(_mm256_or_si256(_mm256_xor_si256(sum, vp), eq), vn);
+    __m256i hp = _mm256_or_si256(
+        vn, _mm256_andnot_si256(_mm256_or_si256(d0, vp), ones));
+    __m256i hn = _mm256_and_si256(d0, vp);
+
+    // all ones (-1) in lanes whose top row moved up (down)
+    __m256i up = _mm256_cmpeq_epi64(_mm256_and_si256(hp, last), last);
+    __m256i down = _mm256_cmpeq_epi64(_mm256_and_si256(hn, last), last);
+    score = _mm256_sub_epi64(score, _mm256_and_si256(up, active));
+    score = _mm256_add_epi64(score, _mm256_and_si256(down, active));
+
+    hp = _mm256_or_si256(_mm256_slli_epi64(hp, 1), one);
+    hn = _mm256_slli_epi64(hn, 1);
+    vp = _mm256_or_si256(
+        hn, _mm256_andnot_si256(_mm256_or_si256(d0, hp), ones));
+    vn = _mm256_and_si256(hp, d0);
+  }
+
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), score);
+  for (usize lane = 0; lane < 4; lane++)
+    out[lane] = lanes[lane];
+}
+#endif
+
+/// Kernel comparing a pattern of up to 64 bytes with four texts at a time,
+/// or null without one
+auto batch() -> batch_kernel {
+  static const batch_kernel kernel = []() -> batch_kernel {
+#ifdef MANIFOLD_SIMD_X86
+    if (simd::features().avx2)
+      return levenshtein_avx2;
+#endif
+    return nullptr;
+  }();
+
+  return kernel;
+}
+
+// fzf's scoring (its "v1" algorithm: a greedy forward match, shortened
+// backwards, then scored once)
+
+enum class CharClass : u8 {
+  White,
+  NonWord,
+  Delimiter,
+  Lower,
+  Upper,
+  Number,
+};
+
+constexpr i32 kScoreMatch = 16;
+constexpr i32 kScoreGapStart = -3;
+constexpr i32 kScoreGapExtension = -1;
+constexpr i32 kBonusBoundary = kScoreMatch / 2;
+constexpr i32 kBonusNonWord = kScoreMatch / 2;
+constexpr i32 kBonusCamel123 = kBonusBoundary + kScoreGapExtension;
+constexpr i32 kBonusConsecutive = -(kScoreGapStart + kScoreGapExtension);
+constexpr i32 kBonusFirstCharMultiplier = 2;
+constexpr i32 kBonusBoundaryWhite = kBonusBoundary + 2;
+constexpr i32 kBonusBoundaryDelimiter = kBonusBoundary + 1;
+
+auto class_of(char ch) -> CharClass {
+  if (ch >= 'a' && ch <= 'z')
+    return CharClass::Lower;
+  if (ch >= 'A' && ch <= 'Z')
+    return CharClass::Upper;
+  if (ch >= '0' && ch <= '9')
+    return CharClass::Number;
+  if (chars::whitespace.contains(ch))
+    return CharClass::White;
+  if (ch == '/' || ch == ',' || ch == ':' || ch == ';' || ch == '|')
+    return CharClass::Delimiter;
+  // bytes of multibyte UTF-8 sequences count as letters
+  if (static_cast<u8>(ch) >= 0x80)
+    return CharClass::Lower;
+
+  return CharClass::NonWord;
+}
+
+/// Bonus for a match at a byte of class `current` following one of class
+/// `previous`
+auto bonus_for(CharClass previous, CharClass current) -> i32 {
+  if (current > CharClass::NonWord) {
+    if (previous == CharClass::White)
+      return kBonusBoundaryWhite;
+    if (previous == CharClass::Delimiter)
+      return kBonusBoundaryDelimiter;
+    if (previous == CharClass::NonWord)
+      return kBonusBoundary;
+  }
+
+  if ((previous == CharClass::Lower && current == CharClass::Upper) ||
+      (previous != CharClass::Number && current == CharClass::Number))
+    return kBonusCamel123;
+
+  if (current == CharClass::NonWord || current == CharClass::Delimiter)
+    return kBonusNonWord;
+  if (current == CharClass::White)
+    return kBonusBoundaryWhite;
+
+  return 0;
+}
+
+auto fold(char ch, bool ignore_case) -> char {
+  return ignore_case && ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch + 32)
+                                               : ch;
+}
+
+/// Scores the matches of `pattern` in text[begin..end), which starts and
+/// ends with one
+auto score_window(std::string_view pattern, std::string_view text,
+                  usize begin, usize end, bool ignore_case) -> i32 {
+  CharClass previous = begin > 0 ? class_of(text[begin - 1]) : CharClass::White;
+  usize matched = 0;
+  usize consecutive = 0;
+  i32 score = 0;
+  i32 first_bonus = 0;
+  bool in_gap = false;
+  for (usize i = begin; i < end; i++) {
+    CharClass current = class_of(text[i]);
+    if (matched < pattern.size() &&
+        fold(text[i], ignore_case) == pattern[matched]) {
+      score += kScoreMatch;
+      i32 bonus = bonus_for(previous, current);
+      if (consecutive == 0) {
+        first_bonus = bonus;
+      } else {
+        // a boundary starts a new chunk of consecutive matches
+        if (bonus >= kBonusBoundary && bonus > first_bonus)
+          first_bonus = bonus;
+
+        bonus = std::max({bonus, first_bonus, kBonusConsecutive});
+      }
+
+      score += matched == 0 ? bonus * kBonusFirstCharMultiplier : bonus;
+      in_gap = false;
+      consecutive++;
+      matched++;
+    } else {
+      score += in_gap ? kScoreGapExtension : kScoreGapStart;
+      in_gap = true;
+      consecutive = 0;
+      first_bonus = 0;
+    }
+
+    previous = current;
+  }
+
+  return score;
+}
+
+} // namespace
+
+auto levenshtein(std::string_view a, std::string_view b) -> usize {
+  trim_common(a, b);
+  return levenshtein_bounded(MatchMasks(a), b, std::string_view::npos);
+}
+
+auto damerau(std::string_view a, std::string_view b) -> usize {
+  trim_common(a, b);
+  if (a.empty())
+    return b.size();
+
+  MatchMasks pattern(a);
+  if (pattern.words == 1)
+    return damerau_word(pattern, b);
+
+  return damerau_blocks(pattern, b);
+}
+
+auto within_distance(std::string_view a, std::string_view b, usize max)
+    -> bool {
+  trim_common(a, b);
+  if (b.size() - a.size() > max)
+    return false;
+
+  return levenshtein_bounded(MatchMasks(a), b, max) <= max;
+}
+
+auto levenshtein(std::string_view query,
+                 std::span<const std::string_view> candidates,
+                 std::span<usize> out) -> void {
+  MatchMasks pattern(query);
+  usize i = 0;
+  if (pattern.words == 1) {
+    if (batch_kernel kernel = batch()) {
+      for (; i + 4 <= candidates.size(); i += 4)
+        kernel(pattern, candidates.data() + i, out.data() + i);
+    }
+  }
+
+  for (; i < candidates.size(); i++)
+    out[i] =
+        levenshtein_bounded(pattern, candidates[i], std::string_view::npos);
+}
+
+auto closest(std::string_view query,
+             std::span<const std::string_view> candidates, usize max)
+    -> usize {
+  MatchMasks pattern(query);
+  usize best = std::string_view::npos;
+  for (usize i = 0; i < candidates.size(); i++) {
+    usize size = candidates[i].size();
+    usize gap = size > query.size() ? size - query.size() : query.size() - size;
+    if (gap > max)
+      continue;
+
+    // later candidates have to beat the best so far
+    usize distance = levenshtein_bounded(pattern, candidates[i], max);
+    if (distance <= max) {
+      best = i;
+      if (distance == 0)
+        break;
+
+      max = distance - 1;
+    }
+  }
+
+  return best;
+}
+
+auto fuzzy_score(std::string_view pattern, std::string_view text)
+    -> std::optional<i32> {
+  if (pattern.empty())
+    return 0;
+
+  // smart case: an uppercase letter makes the whole pattern case-sensitive
+  bool ignore_case = std::none_of(pattern.begin(), pattern.end(), [](char ch) {
+    return ch >= 'A' && ch <= 'Z';
+  });
+
+  usize matched = 0;
+  usize end = 0;
+  for (; end < text.size() && matched < pattern.size(); end++) {
+    if (fold(text[end], ignore_case) == pattern[matched])
+      matched++;
+  }
+
+  if (matched < pattern.size())
+    return std::nullopt;
+
+  // walking back from the end of the match finds the latest start for it
+  usize begin = end;
+  while (matched > 0) {
+    begin--;
+    if (fold(text[begin], ignore_case) == pattern[matched - 1])
+      matched--;
+  }
+
+  return score_window(pattern, text, begin, end, ignore_case);
+}
+
+auto fuzzy_search(std::string_view pattern,
+                  std::span<const std::string_view> candidates, usize limit)
+    -> std::vector<FuzzyMatch> {
+  std::vector<FuzzyMatch> matches;
+  for (usize i = 0; i < candidates.size(); i++) {
+    if (auto score = fuzzy_score(pattern, candidates[i]))
+      matches.push_back(FuzzyMatch{i, *score});
+  }
+
+  auto better = [&](const FuzzyMatch &a, const FuzzyMatch &b) {
+    if (a.score != b.score)
+      return a.score > b.score;
+    if (candidates[a.index].size() != candidates[b.index].size())
+      return candidates[a.index].size() < candidates[b.index].size();
+
+    return a.index < b.index;
+  };
+
+  if (limit < matches.size()) {
+    std::partial_sort(matches.begin(), matches.begin() + limit, matches.end(),
+                      better);
+    matches.resize(limit);
+  } else {
+    std::sort(matches.begin(), matches.end(), better);
+  }
+
+  return matches;
+}
+
+} // namespace manifold::str
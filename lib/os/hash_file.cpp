@@ -0,0 +1,66 @@
+#include "../parallel.hpp"
+#include <manifold/os/fs.hpp>
+#include <algorithm>
+
+namespace manifold::fs {
+
+namespace {
+
+auto hash_bytes(std::span<const u8> bytes, hash::Algorithm algo,
+                HashMode mode) -> u64 {
+  usize chunks = (bytes.size() + kHashChunk - 1) / kHashChunk;
+  if (chunks <= 1)
+    return hash::hash(algo, bytes);
+
+  if (mode == HashMode::Flat && algo != hash::Algorithm::Crc32c)
+    return hash::hash(algo, bytes);
+
+  auto chunk = [&](usize i) {
+    return bytes.subspan(i * kHashChunk,
+                         std::min(kHashChunk, bytes.size() - i * kHashChunk));
+  };
+
+  std::vector<u64> digests(chunks);
+  manifold::internal::parallel_for(chunks, 0, [&](usize i) {
+    digests[i] = hash::hash(algo, chunk(i));
+  });
+
+  if (mode == HashMode::Flat) {
+    // CRC-32C checksums of consecutive chunks combine exactly
+    u32 crc = static_cast<u32>(digests[0]);
+    for (usize i = 1; i < chunks; i++) {
+      crc = hash::crc32c_combine(crc, static_cast<u32>(digests[i]),
+                                 chunk(i).size());
+    }
+    return crc;
+  }
+
+  std::vector<u8> leaves(chunks * sizeof(u64));
+  for (usize i = 0; i < chunks; i++) {
+    for (usize b = 0; b < sizeof(u64); b++)
+      leaves[i * sizeof(u64) + b] = static_cast<u8>(digests[i] >> (8 * b));
+  }
+
+  return hash::hash(algo, leaves);
+}
+
+} // namespace
+
+auto hash_file(const path_type &path, hash::Algorithm algo, HashMode mode)
+    -> manifold::result<u64, fs::Error> {
+  auto mapped = MappedFile::open(path);
+  if (!mapped.has_error())
+    return hash_bytes(mapped.value().bytes(), algo, mode);
+
+  if (mapped.error() != fs::Error::Unsupported)
+    return manifold::fail(mapped.error());
+
+  // no mappings on this platform, fall back to reading the file
+  auto bytes = read_file_bytes(path);
+  if (bytes.has_error())
+    return manifold::fail(bytes.error());
+
+  return hash_bytes(bytes.value(), algo, mode);
+}
+
+} // namespace manifold::fs
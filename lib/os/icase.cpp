@@ -0,0 +1,287 @@
+#include "../simd.hpp"
+#include <manifold/os/str.hpp>
+
+namespace manifold::str {
+
+namespace {
+
+/// Offset of the first byte at which `a` and `b` differ once folded, or `n`
+using mismatch_kernel = usize (*)(const char *a, const char *b, usize n);
+
+/// Finds `needle` (at least one byte) from `pos` on while whole blocks fit,
+/// leaving `pos` where the caller has to carry on
+using find_kernel = usize (*)(std::string_view haystack,
+                              std::string_view needle, usize &pos);
+
+struct Kernels {
+  mismatch_kernel mismatch;
+  find_kernel find;
+};
+
+auto fold(char ch) -> u8 {
+  auto byte = static_cast<u8>(ch);
+  return static_cast<u8>(byte - 'A') < 26 ? byte | 0x20 : byte;
+}
+
+auto mismatch_scalar(const char *a, const char *b, usize n) -> usize {
+  for (usize i = 0; i < n; i++) {
+    if (fold(a[i]) != fold(b[i]))
+      return i;
+  }
+
+  return n;
+}
+
+auto kernels() -> const Kernels &;
+
+/// Checks a candidate whose first and last bytes already matched
+[[maybe_unused]] auto verify(const char *at, std::string_view needle)
+    -> bool {
+  if (needle.size() <= 2)
+    return true;
+
+  usize inner = needle.size() - 2;
+  return kernels().mismatch(at + 1, needle.data() + 1, inner) == inner;
+}
+
+#ifdef MANIFOLD_SIMD_X86
+// Uppercase letters are found with the biased signed compare of
+// `convert_case` and get bit 0x20 set.
+auto fold_sse2(__m128i x) -> __m128i {
+  __m128i upper = _mm_cmplt_epi8(
+      _mm_add_epi8(x, _mm_set1_epi8(static_cast<char>(0x80 - 'A'))),
+      _mm_set1_epi8(-128 + 26));
+  return _mm_or_si128(x, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+MANIFOLD_TARGET("avx2")
+auto fold_avx2(__m256i x) -> __m256i {
+  __m256i upper = _mm256_cmpgt_epi8(
+      _mm256_set1_epi8(-128 + 26),
+      _mm256_add_epi8(x, _mm256_set1_epi8(static_cast<char>(0x80 - 'A'))));
+  return _mm256_or_si256(x, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+auto mismatch_sse2(const char *a, const char *b, usize n) -> usize {
+  usize i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i x =
+        fold_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)));
+    __m128i y =
+        fold_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+    auto equal = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+    if (equal != 0xffff)
+      return i + static_cast<usize>(__builtin_ctz(~equal));
+  }
+
+  return i + mismatch_scalar(a + i, b + i, n - i);
+}
+
+MANIFOLD_TARGET("avx2")
+auto mismatch_avx2(const char *a, const char *b, usize n) -> usize {
+  usize i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i x = fold_avx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)));
+    __m256i y = fold_avx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+    auto equal =
+        static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+    if (equal != ~u32{0})
+      return i + static_cast<usize>(__builtin_ctz(~equal));
+  }
+
+  return i + mismatch_sse2(a + i, b + i, n - i);
+}
+
+// Like `find_pair_sse2` in search.cpp, on the needle's first and last bytes
+// folded, with both sides of each compare folded
+auto find_sse2(std::string_view haystack, std::string_view needle,
+               usize &pos) -> usize {
+  const usize n = haystack.size();
+  const usize k = needle.size();
+  const char *h = haystack.data();
+
+  const __m128i first = _mm_set1_epi8(static_cast<char>(fold(needle[0])));
+  const __m128i last = _mm_set1_epi8(static_cast<char>(fold(needle[k - 1])));
+
+  for (; pos + k + 15 <= n; pos += 16) {
+    __m128i a = fold_sse2(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + pos)));
+    __m128i b = fold_sse2(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + pos + k - 1)));
+    auto mask = static_cast<u32>(_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+
+    for (; mask != 0; mask &= mask - 1) {
+      usize at = pos + static_cast<usize>(__builtin_ctz(mask));
+      if (verify(h + at, needle))
+        return at;
+    }
+  }
+
+  return std::string_view::npos;
+}
+
+MANIFOLD_TARGET("avx2")
+auto find_avx2(std::string_view haystack, std::string_view needle,
+               usize &pos) -> usize {
+  const usize n = haystack.size();
+  const usize k = needle.size();
+  const char *h = haystack.data();
+
+  const __m256i first = _mm256_set1_epi8(static_cast<char>(fold(needle[0])));
+  const __m256i last =
+      _mm256_set1_epi8(static_cast<char>(fold(needle[k - 1])));
+
+  for (; pos + k + 31 <= n; pos += 32) {
+    __m256i a = fold_avx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + pos)));
+    __m256i b = fold_avx2(_mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(h + pos + k - 1)));
+    auto mask = static_cast<u32>(_mm256_movemask_epi8(_mm256_and_si256(
+        _mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+
+    for (; mask != 0; mask &= mask - 1) {
+      usize at = pos + static_cast<usize>(__builtin_ctz(mask));
+      if (verify(h + at, needle))
+        return at;
+    }
+  }
+
+  return std::string_view::npos;
+}
+#endif
+
+#ifdef MANIFOLD_SIMD_NEON
+auto fold_neon(uint8x16_t x) -> uint8x16_t {
+  uint8x16_t upper = vcltq_u8(vsubq_u8(x, vdupq_n_u8('A')), vdupq_n_u8(26));
+  return vorrq_u8(x, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+
+/// Four bits per byte of a compare result (NEON has no movemask)
+auto nibble_mask(uint8x16_t x) -> u64 {
+  return vget_lane_u64(
+      vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(x), 4)), 0);
+}
+
+auto mismatch_neon(const char *a, const char *b, usize n) -> usize {
+  const auto *x = reinterpret_cast<const u8 *>(a);
+  const auto *y = reinterpret_cast<const u8 *>(b);
+
+  usize i = 0;
+  for (; i + 16 <= n; i += 16) {
+    uint8x16_t equal =
+        vceqq_u8(fold_neon(vld1q_u8(x + i)), fold_neon(vld1q_u8(y + i)));
+    u64 differ = ~nibble_mask(equal);
+    if (differ != 0)
+      return i + static_cast<usize>(__builtin_ctzll(differ)) / 4;
+  }
+
+  return i + mismatch_scalar(a + i, b + i, n - i);
+}
+
+auto find_neon(std::string_view haystack, std::string_view needle,
+               usize &pos) -> usize {
+  const usize n = haystack.size();
+  const usize k = needle.size();
+  const auto *h = reinterpret_cast<const u8 *>(haystack.data());
+
+  const uint8x16_t first = vdupq_n_u8(fold(needle[0]));
+  const uint8x16_t last = vdupq_n_u8(fold(needle[k - 1]));
+
+  for (; pos + k + 15 <= n; pos += 16) {
+    uint8x16_t a = fold_neon(vld1q_u8(h + pos));
+    uint8x16_t b = fold_neon(vld1q_u8(h + pos + k - 1));
+    u64 mask = nibble_mask(vandq_u8(vceqq_u8(a, first), vceqq_u8(b, last)));
+    mask &= 0x8888888888888888UL;
+    for (; mask != 0; mask &= mask - 1) {
+      usize at = pos + static_cast<usize>(__builtin_ctzll(mask)) / 4;
+      if (verify(haystack.data() + at, needle))
+        return at;
+    }
+  }
+
+  return std::string_view::npos;
+}
+#endif
+
+auto kernels() -> const Kernels & {
+  static const Kernels chosen = []() -> Kernels {
+#if defined(MANIFOLD_SIMD_X86)
+    if (simd::features().avx2)
+      return {mismatch_avx2, find_avx2};
+
+    return {mismatch_sse2, find_sse2};
+#elif defined(MANIFOLD_SIMD_NEON)
+    return {mismatch_neon, find_neon};
+#else
+    return {mismatch_scalar, nullptr};
+#endif
+  }();
+
+  return chosen;
+}
+
+} // namespace
+
+auto iequals(std::string_view a, std::string_view b) -> bool {
+  return a.size() == b.size() &&
+         kernels().mismatch(a.data(), b.data(), a.size()) == a.size();
+}
+
+auto icompare(std::string_view a, std::string_view b) -> std::strong_ordering {
+  usize size = std::min(a.size(), b.size());
+  usize at = kernels().mismatch(a.data(), b.data(), size);
+  if (at < size)
+    return fold(a[at]) <=> fold(b[at]);
+
+  return a.size() <=> b.size();
+}
+
+auto ihash(std::string_view str, u64 seed) -> u64 {
+  // folded a stage at a time on the stack; keys that fit in one (nearly all
+  // of them) are hashed like `str::hash` hashes their lowercase form
+  constexpr usize kStage = manifold::hash::Xxh3::kBufferSize;
+  char stage[kStage];
+  if (str.size() <= kStage) {
+    usize size = to_lower(str, stage);
+    return manifold::hash::wyhash(std::string_view(stage, size), seed);
+  }
+
+  manifold::hash::Xxh3 state(seed);
+  while (!str.empty()) {
+    usize size = to_lower(str.substr(0, kStage), stage);
+    state.update(std::string_view(stage, size));
+    str.remove_prefix(size);
+  }
+
+  return state.digest();
+}
+
+auto ifind(std::string_view haystack, std::string_view needle, usize pos)
+    -> usize {
+  if (pos > haystack.size() || needle.size() > haystack.size() - pos)
+    return std::string_view::npos;
+
+  if (needle.empty())
+    return pos;
+
+  if (auto search = kernels().find) {
+    usize found = search(haystack, needle, pos);
+    if (found != std::string_view::npos)
+      return found;
+  }
+
+  u8 first = fold(needle[0]);
+  for (; pos + needle.size() <= haystack.size(); pos++) {
+    if (fold(haystack[pos]) == first &&
+        kernels().mismatch(haystack.data() + pos, needle.data(),
+                           needle.size()) == needle.size())
+      return pos;
+  }
+
+  return std::string_view::npos;
+}
+
+} // namespace manifold::str
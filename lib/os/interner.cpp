@@ -0,0 +1,173 @@
+#include <manifold/hash.hpp>
+#include <manifold/os/str.hpp>
+#include <bit>
+#include <mutex>
+
+namespace manifold::str {
+
+namespace {
+
+/// Strings longer than this get an allocation of their own
+constexpr usize kArenaBlock = 64 * 1024;
+
+/// A table slot packs the low 32 bits of the hash (which also pick the slot)
+/// with `id + 1`, 0 is an empty slot
+auto pack(u64 hash, Interner::id_type id) -> u64 {
+  return (hash << 32) | (static_cast<u64>(id) + 1);
+}
+
+struct Table {
+  explicit Table(usize capacity)
+      : mask(capacity - 1), slots(new std::atomic<u64>[capacity]) {
+    for (usize i = 0; i < capacity; i++)
+      slots[i].store(0, std::memory_order_relaxed);
+  }
+
+  usize mask;
+  std::unique_ptr<std::atomic<u64>[]> slots;
+};
+
+} // namespace
+
+struct Interner::Shard {
+  std::mutex lock;
+  std::atomic<Table *> table = nullptr;
+
+  /// Every table the shard ever used: readers may still be probing an old one
+  /// after a resize, so they are only freed with the interner
+  std::vector<std::unique_ptr<Table>> tables;
+  usize count = 0;
+
+  std::vector<std::unique_ptr<char[]>> blocks;
+  char *cursor = nullptr;
+  usize remaining = 0;
+
+  auto store(std::string_view str) -> const char * {
+    if (str.size() > kArenaBlock / 4) {
+      blocks.emplace_back(new char[str.size()]);
+      std::memcpy(blocks.back().get(), str.data(), str.size());
+      return blocks.back().get();
+    }
+
+    if (cursor == nullptr || remaining < str.size()) {
+      blocks.emplace_back(new char[kArenaBlock]);
+      cursor = blocks.back().get();
+      remaining = kArenaBlock;
+    }
+
+    char *at = cursor;
+    std::memcpy(at, str.data(), str.size());
+    cursor += str.size();
+    remaining -= str.size();
+    return at;
+  }
+};
+
+Interner::Interner()
+    : shards(new Shard[kShards]),
+      segments(new std::atomic<Entry *>[kSegments]) {
+  for (usize i = 0; i < kSegments; i++)
+    segments[i].store(nullptr, std::memory_order_relaxed);
+}
+
+Interner::~Interner() {
+  for (usize i = 0; i < kSegments; i++)
+    delete[] segments[i].load(std::memory_order_relaxed);
+}
+
+auto Interner::entry(id_type id) const -> Entry & {
+  // segment k holds ids [kFirstSegment * (2^k - 1), kFirstSegment * (2^(k+1)
+  // - 1)), so earlier entries never move as the interner grows
+  usize block = id / kFirstSegment + 1;
+  auto segment = static_cast<usize>(std::bit_width(block) - 1);
+  usize offset = id - kFirstSegment * ((usize{1} << segment) - 1);
+
+  Entry *entries = segments[segment].load(std::memory_order_acquire);
+  if (entries == nullptr) {
+    auto *created = new Entry[kFirstSegment << segment];
+    if (segments[segment].compare_exchange_strong(
+            entries, created, std::memory_order_acq_rel))
+      entries = created;
+    else
+      delete[] created;
+  }
+
+  return entries[offset];
+}
+
+auto Interner::lookup(const Shard &shard, std::string_view str, u64 hash) const
+    -> std::optional<id_type> {
+  const Table *table = shard.table.load(std::memory_order_acquire);
+  if (table == nullptr)
+    return std::nullopt;
+
+  for (usize i = hash & table->mask;; i = (i + 1) & table->mask) {
+    u64 slot = table->slots[i].load(std::memory_order_acquire);
+    if (slot == 0)
+      return std::nullopt;
+
+    auto id = static_cast<id_type>(slot - 1);
+    if ((slot >> 32) == (hash & 0xffffffff) && view(id) == str)
+      return id;
+  }
+}
+
+auto Interner::find(std::string_view str) const -> std::optional<id_type> {
+  u64 hash = manifold::hash::wyhash(str);
+  return lookup(shards[hash >> 58], str, hash);
+}
+
+auto Interner::intern(std::string_view str) -> id_type {
+  u64 hash = manifold::hash::wyhash(str);
+  auto &shard = shards[hash >> 58];
+  static_assert(kShards == 64, "shards are picked by the top 6 hash bits");
+
+  if (auto id = lookup(shard, str, hash))
+    return *id;
+
+  std::lock_guard guard(shard.lock);
+  if (auto id = lookup(shard, str, hash))
+    return *id;
+
+  // grow past half full, publishing the new table only once it is complete
+  Table *table = shard.table.load(std::memory_order_relaxed);
+  if (table == nullptr || (shard.count + 1) * 2 > table->mask + 1) {
+    usize capacity = table == nullptr ? 64 : (table->mask + 1) * 2;
+    auto grown = std::make_unique<Table>(capacity);
+    if (table != nullptr) {
+      for (usize i = 0; i <= table->mask; i++) {
+        u64 slot = table->slots[i].load(std::memory_order_relaxed);
+        if (slot == 0)
+          continue;
+
+        usize at = (slot >> 32) & grown->mask;
+        while (grown->slots[at].load(std::memory_order_relaxed) != 0)
+          at = (at + 1) & grown->mask;
+
+        grown->slots[at].store(slot, std::memory_order_relaxed);
+      }
+    }
+
+    table = grown.get();
+    shard.tables.push_back(std::move(grown));
+    shard.table.store(table, std::memory_order_release);
+  }
+
+  id_type id = next_id.fetch_add(1, std::memory_order_relaxed);
+  entry(id) = Entry{shard.store(str), str.size()};
+
+  usize at = hash & table->mask;
+  while (table->slots[at].load(std::memory_order_relaxed) != 0)
+    at = (at + 1) & table->mask;
+
+  table->slots[at].store(pack(hash, id), std::memory_order_release);
+  shard.count++;
+  return id;
+}
+
+auto Interner::view(id_type id) const -> std::string_view {
+  const auto &found = entry(id);
+  return std::string_view(found.data, found.size);
+}
+
+} // namespace manifold::str
@@ -0,0 +1,75 @@
+#include <manifold/os/fs.hpp>
+#include <utility>
+
+#ifndef MANIFOLD_PLATFORM_WINDOWS
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace manifold::fs {
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data(std::exchange(other.data, nullptr)),
+      length(std::exchange(other.length, 0)) {}
+
+auto MappedFile::operator=(MappedFile &&other) noexcept -> MappedFile & {
+  if (this != &other) {
+    unmap();
+    data = std::exchange(other.data, nullptr);
+    length = std::exchange(other.length, 0);
+  }
+
+  return *this;
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+auto MappedFile::open(const path_type &path)
+    -> manifold::result<MappedFile, fs::Error> {
+#ifdef MANIFOLD_PLATFORM_WINDOWS
+  static_cast<void>(path);
+  return manifold::fail(fs::Error::Unsupported);
+#else
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return manifold::fail(errno == ENOENT ? fs::Error::NoFileExists
+                                          : fs::Error::IoError);
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    return manifold::fail(fs::Error::IoError);
+  }
+
+  // empty files can't be mapped, they're simply an empty view
+  auto size = static_cast<usize>(st.st_size);
+  if (size == 0) {
+    ::close(fd);
+    return MappedFile(nullptr, 0);
+  }
+
+  void *map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED)
+    return manifold::fail(fs::Error::IoError);
+
+  ::madvise(map, size, MADV_SEQUENTIAL);
+  return MappedFile(static_cast<const u8 *>(map), size);
+#endif
+}
+
+auto MappedFile::unmap() -> void {
+#ifndef MANIFOLD_PLATFORM_WINDOWS
+  if (data != nullptr)
+    ::munmap(const_cast<u8 *>(data), length);
+#endif
+
+  data = nullptr;
+  length = 0;
+}
+
+} // namespace manifold::fs
@@ -0,0 +1,201 @@
+#include <manifold/os/fs.hpp>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#ifndef MANIFOLD_PLATFORM_WINDOWS
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace manifold::fs {
+
+#ifndef MANIFOLD_PLATFORM_WINDOWS
+namespace {
+
+auto page_size() -> usize {
+  static const usize size = static_cast<usize>(::sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+} // namespace
+#endif
+
+MappedWriter::MappedWriter(int file, u8 *map, usize size)
+    : fd(file), data(map), mapped(size) {}
+
+MappedWriter::MappedWriter(MappedWriter &&other) noexcept
+    : fd(std::exchange(other.fd, -1)), data(std::exchange(other.data, nullptr)),
+      mapped(std::exchange(other.mapped, 0)),
+      length(std::exchange(other.length, 0)),
+      synced(std::exchange(other.synced, 0)) {}
+
+auto MappedWriter::operator=(MappedWriter &&other) noexcept -> MappedWriter & {
+  if (this != &other) {
+    static_cast<void>(close());
+    fd = std::exchange(other.fd, -1);
+    data = std::exchange(other.data, nullptr);
+    mapped = std::exchange(other.mapped, 0);
+    length = std::exchange(other.length, 0);
+    synced = std::exchange(other.synced, 0);
+  }
+
+  return *this;
+}
+
+MappedWriter::~MappedWriter() { static_cast<void>(close()); }
+
+auto MappedWriter::create(const path_type &path, usize capacity)
+    -> manifold::result<MappedWriter, fs::Error> {
+#ifdef MANIFOLD_PLATFORM_WINDOWS
+  static_cast<void>(path);
+  static_cast<void>(capacity);
+  return manifold::fail(fs::Error::Unsupported);
+#else
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return manifold::fail(errno == ENOENT ? fs::Error::NoFileExists
+                                          : fs::Error::IoError);
+  }
+
+  // round up to whole pages, mappings can't be empty
+  capacity = std::max(capacity, page_size());
+  capacity = (capacity + page_size() - 1) & ~(page_size() - 1);
+
+  if (::ftruncate(fd, static_cast<off_t>(capacity)) != 0) {
+    ::close(fd);
+    return manifold::fail(fs::Error::IoError);
+  }
+
+  void *map =
+      ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    ::close(fd);
+    return manifold::fail(fs::Error::IoError);
+  }
+
+  return MappedWriter(fd, static_cast<u8 *>(map), capacity);
+#endif
+}
+
+auto MappedWriter::write(std::span<const u8> bytes)
+    -> manifold::result<void, fs::Error> {
+  auto region = reserve(bytes.size());
+  if (region.has_error())
+    return manifold::fail(region.error());
+
+  if (!bytes.empty())
+    std::memcpy(region.value().data(), bytes.data(), bytes.size());
+
+  commit(bytes.size());
+  if (length - synced >= kSyncInterval)
+    return flush();
+
+  return manifold::result<void, fs::Error>();
+}
+
+auto MappedWriter::write(std::string_view str)
+    -> manifold::result<void, fs::Error> {
+  return write(std::span<const u8>(reinterpret_cast<const u8 *>(str.data()),
+                                   str.size()));
+}
+
+auto MappedWriter::reserve(usize size)
+    -> manifold::result<std::span<u8>, fs::Error> {
+  if (fd < 0)
+    return manifold::fail(fs::Error::IoError);
+
+  if (length + size > mapped) {
+    auto res = grow(length + size);
+    if (res.has_error())
+      return manifold::fail(res.error());
+  }
+
+  return std::span<u8>(data + length, mapped - length);
+}
+
+auto MappedWriter::commit(usize size) -> void {
+  length += std::min(size, mapped - length);
+}
+
+auto MappedWriter::flush() -> manifold::result<void, fs::Error> {
+#ifdef MANIFOLD_PLATFORM_WINDOWS
+  return manifold::fail(fs::Error::Unsupported);
+#else
+  if (fd < 0)
+    return manifold::fail(fs::Error::IoError);
+
+  // msync wants a page-aligned start
+  usize start = synced & ~(page_size() - 1);
+  if (length > start &&
+      ::msync(data + start, length - start, MS_ASYNC) != 0) {
+    return manifold::fail(fs::Error::IoError);
+  }
+
+  synced = length;
+  return manifold::result<void, fs::Error>();
+#endif
+}
+
+auto MappedWriter::close() -> manifold::result<void, fs::Error> {
+#ifdef MANIFOLD_PLATFORM_WINDOWS
+  return manifold::result<void, fs::Error>();
+#else
+  if (fd < 0)
+    return manifold::result<void, fs::Error>();
+
+  bool ok = ::munmap(data, mapped) == 0;
+  ok = ::ftruncate(fd, static_cast<off_t>(length)) == 0 && ok;
+  ok = ::close(fd) == 0 && ok;
+
+  fd = -1;
+  data = nullptr;
+  mapped = 0;
+
+  if (!ok)
+    return manifold::fail(fs::Error::IoError);
+
+  return manifold::result<void, fs::Error>();
+#endif
+}
+
+auto MappedWriter::grow(usize needed) -> manifold::result<void, fs::Error> {
+#ifdef MANIFOLD_PLATFORM_WINDOWS
+  static_cast<void>(needed);
+  return manifold::fail(fs::Error::Unsupported);
+#else
+  usize capacity = mapped;
+  while (capacity < needed)
+    capacity *= 2;
+
+  if (::ftruncate(fd, static_cast<off_t>(capacity)) != 0)
+    return manifold::fail(fs::Error::IoError);
+
+#ifdef MANIFOLD_PLATFORM_LINUX
+  void *map = ::mremap(data, mapped, capacity, MREMAP_MAYMOVE);
+#else
+  ::munmap(data, mapped);
+  void *map =
+      ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+#endif
+
+  if (map == MAP_FAILED) {
+#ifdef MANIFOLD_PLATFORM_LINUX
+    ::munmap(data, mapped);
+#endif
+    data = nullptr;
+    mapped = 0;
+    ::close(fd);
+    fd = -1;
+    return manifold::fail(fs::Error::IoError);
+  }
+
+  data = static_cast<u8 *>(map);
+  mapped = capacity;
+  return manifold::result<void, fs::Error>();
+#endif
+}
+
+} // namespace manifold::fs
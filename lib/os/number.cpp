@@ -0,0 +1,225 @@
+#include <manifold/os/str.hpp>
+#include <bit>
+#include <charconv>
+#include <limits>
+
+namespace manifold::str {
+
+namespace {
+
+auto load_eight(const char *data) -> u64 {
+  u64 chunk;
+  std::memcpy(&chunk, data, sizeof(chunk));
+  return chunk;
+}
+
+/// True if all eight bytes are '0'..'9' (both nibble checks together reject
+/// anything outside 0x30..0x39)
+auto is_eight_digits(u64 chunk) -> bool {
+  return ((chunk & 0xf0f0f0f0f0f0f0f0UL) |
+          (((chunk + 0x0606060606060606UL) & 0xf0f0f0f0f0f0f0f0UL) >> 4)) ==
+         0x3333333333333333UL;
+}
+
+/// Value of eight ASCII digits loaded little-endian (the first digit in the
+/// low byte), combining pairs, then quads, then the two halves
+auto parse_eight(u64 chunk) -> u64 {
+  chunk -= 0x3030303030303030UL;
+  chunk = (chunk * 10) + (chunk >> 8);
+  chunk =
+      (((chunk & 0x000000ff000000ffUL) * (100 + (u64{1000000} << 32))) +
+       (((chunk >> 16) & 0x000000ff000000ffUL) * (1 + (u64{10000} << 32)))) >>
+      32;
+  return chunk;
+}
+
+/// Parses the digits of `str` into a magnitude no larger than `max`
+auto parse_magnitude(std::string_view str, u64 max)
+    -> result<u64, ParseError> {
+  if (str.empty())
+    return fail(ParseError::Invalid);
+
+  const char *at = str.data();
+  const char *end = at + str.size();
+  while (at < end && *at == '0')
+    at++;
+
+  // sixteen digits can never overflow, so the fast path needs no checks
+  u64 value = 0;
+  if constexpr (std::endian::native == std::endian::little) {
+    for (int i = 0; i < 2 && end - at >= 8; i++) {
+      u64 chunk = load_eight(at);
+      if (!is_eight_digits(chunk))
+        break;
+
+      value = value * 100000000 + parse_eight(chunk);
+      at += 8;
+    }
+  }
+
+  bool overflow = false;
+  for (; at < end; at++) {
+    auto digit = static_cast<u64>(static_cast<u8>(*at - '0'));
+    if (digit > 9)
+      return fail(ParseError::Invalid);
+
+    if (value > (max - digit) / 10)
+      overflow = true;
+    else
+      value = value * 10 + digit;
+  }
+
+  // the unchecked digits alone can exceed the limit of a small type
+  if (overflow || value > max)
+    return fail(ParseError::OutOfRange);
+
+  return value;
+}
+
+template <typename T>
+auto parse_integer(std::string_view str) -> result<T, ParseError> {
+  if (str.empty())
+    return fail(ParseError::Empty);
+
+  bool negative = str.front() == '-';
+  if (negative || str.front() == '+')
+    str.remove_prefix(1);
+
+  if constexpr (std::is_unsigned_v<T>) {
+    if (negative)
+      return fail(ParseError::Invalid);
+
+    auto value = parse_magnitude(str, std::numeric_limits<T>::max());
+    if (value.has_error())
+      return fail(value.error());
+
+    return static_cast<T>(value.value());
+  } else {
+    // the most negative value has one more unit of magnitude than the most
+    // positive one
+    auto max = static_cast<u64>(std::numeric_limits<T>::max());
+    auto value = parse_magnitude(str, negative ? max + 1 : max);
+    if (value.has_error())
+      return fail(value.error());
+
+    u64 magnitude = value.value();
+    return static_cast<T>(negative ? 0 - magnitude : magnitude);
+  }
+}
+
+template <typename T>
+auto parse_float(std::string_view str) -> result<T, ParseError> {
+  if (str.empty())
+    return fail(ParseError::Empty);
+
+  if (str.front() == '+' && str.size() > 1 && str[1] != '-')
+    str.remove_prefix(1);
+
+  T value;
+  auto [end, error] = std::from_chars(str.data(), str.data() + str.size(),
+                                      value);
+  if (error == std::errc::result_out_of_range)
+    return fail(ParseError::OutOfRange);
+
+  if (error != std::errc() || end != str.data() + str.size())
+    return fail(ParseError::Invalid);
+
+  return value;
+}
+
+constexpr char kDigitPairs[] = "00010203040506070809"
+                               "10111213141516171819"
+                               "20212223242526272829"
+                               "30313233343536373839"
+                               "40414243444546474849"
+                               "50515253545556575859"
+                               "60616263646566676869"
+                               "70717273747576777879"
+                               "80818283848586878889"
+                               "90919293949596979899";
+
+auto format_magnitude(u64 value, bool negative, std::span<char> out)
+    -> usize {
+  // digits are produced two at a time from the end of a scratch buffer
+  char scratch[kMaxNumberChars];
+  char *at = scratch + sizeof(scratch);
+  while (value >= 100) {
+    usize pair = (value % 100) * 2;
+    value /= 100;
+    at -= 2;
+    std::memcpy(at, kDigitPairs + pair, 2);
+  }
+
+  if (value >= 10) {
+    at -= 2;
+    std::memcpy(at, kDigitPairs + value * 2, 2);
+  } else {
+    *--at = static_cast<char>('0' + value);
+  }
+
+  if (negative)
+    *--at = '-';
+
+  auto size = static_cast<usize>(scratch + sizeof(scratch) - at);
+  if (size > out.size())
+    return 0;
+
+  std::memcpy(out.data(), at, size);
+  return size;
+}
+
+} // namespace
+
+template <typename T>
+auto parse(std::string_view str) -> manifold::result<T, ParseError> {
+  if constexpr (std::is_floating_point_v<T>)
+    return parse_float<T>(str);
+  else
+    return parse_integer<T>(str);
+}
+
+template <typename T> auto format_int(T value, std::span<char> out) -> usize {
+  if constexpr (std::is_unsigned_v<T>) {
+    return format_magnitude(value, false, out);
+  } else {
+    auto magnitude = static_cast<u64>(value);
+    return format_magnitude(value < 0 ? 0 - magnitude : magnitude, value < 0,
+                            out);
+  }
+}
+
+template <typename T>
+auto format_float(T value, std::span<char> out) -> usize {
+  auto [end, error] = std::to_chars(out.data(), out.data() + out.size(), value);
+  if (error != std::errc())
+    return 0;
+
+  return static_cast<usize>(end - out.data());
+}
+
+#define MANIFOLD_STR_INTEGER(T)                                                \
+  template auto parse<T>(std::string_view str)                                 \
+      -> manifold::result<T, ParseError>;                                      \
+  template auto format_int<T>(T value, std::span<char> out) -> usize;
+
+MANIFOLD_STR_INTEGER(signed char)
+MANIFOLD_STR_INTEGER(short)
+MANIFOLD_STR_INTEGER(int)
+MANIFOLD_STR_INTEGER(long)
+MANIFOLD_STR_INTEGER(long long)
+MANIFOLD_STR_INTEGER(unsigned char)
+MANIFOLD_STR_INTEGER(unsigned short)
+MANIFOLD_STR_INTEGER(unsigned int)
+MANIFOLD_STR_INTEGER(unsigned long)
+MANIFOLD_STR_INTEGER(unsigned long long)
+#undef MANIFOLD_STR_INTEGER
+
+template auto parse<float>(std::string_view str)
+    -> manifold::result<float, ParseError>;
+template auto parse<double>(std::string_view str)
+    -> manifold::result<double, ParseError>;
+template auto format_float<float>(float value, std::span<char> out) -> usize;
+template auto format_float<double>(double value, std::span<char> out)
+    -> usize;
+
+} // namespace manifold::str
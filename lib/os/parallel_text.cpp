@@ -0,0 +1,59 @@
+#include "../parallel.hpp"
+#include <manifold/os/parallel_text.hpp>
+#include <manifold/os/str.hpp>
+
+namespace manifold::str {
+
+auto line_chunks(std::string_view text, usize size)
+    -> std::vector<std::string_view> {
+  size = std::max<usize>(size, 1);
+
+  std::vector<std::string_view> chunks;
+  chunks.reserve(text.size() / size + 1);
+  while (!text.empty()) {
+    usize end = text.size();
+    if (size < text.size()) {
+      // a line longer than the chunk size stays whole
+      usize newline = text.find('\n', size - 1);
+      if (newline != std::string_view::npos)
+        end = newline + 1;
+    }
+
+    chunks.push_back(text.substr(0, end));
+    text.remove_prefix(end);
+  }
+
+  return chunks;
+}
+
+auto parallel_chunks(std::span<const std::string_view> chunks,
+                     const std::function<void(usize, std::string_view)> &fn,
+                     usize threads) -> void {
+  manifold::internal::parallel_for(chunks.size(), threads,
+                                   [&](usize i) { fn(i, chunks[i]); });
+}
+
+auto parallel_count(std::string_view text, std::string_view needle,
+                    usize threads) -> usize {
+  Searcher searcher(needle);
+  if (needle.find('\n') != std::string_view::npos)
+    return searcher.count(text);
+
+  // matches never span a newline, so none spans two chunks either
+  auto chunks = line_chunks(text);
+  std::vector<usize> counts(chunks.size());
+  parallel_chunks(
+      chunks,
+      [&](usize i, std::string_view chunk) {
+        counts[i] = searcher.count(chunk);
+      },
+      threads);
+
+  usize total = 0;
+  for (usize count : counts)
+    total += count;
+
+  return total;
+}
+
+} // namespace manifold::str
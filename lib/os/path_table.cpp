@@ -0,0 +1,387 @@
+#include <manifold/os/fs.hpp>
+#include <algorithm>
+#include <numeric>
+
+namespace manifold::fs {
+
+namespace {
+
+auto mix(u64 x) -> u64 {
+  // splitmix64 finalizer
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9UL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebUL;
+  x ^= x >> 31;
+  return x;
+}
+
+auto hash_name(std::string_view name) -> u64 {
+  return mix(std::hash<std::string_view>{}(name));
+}
+
+auto hash_child(PathTable::id_type parent, PathTable::id_type name) -> u64 {
+  return mix((static_cast<u64>(parent) << 32) | name);
+}
+
+auto put_varint(std::vector<u8> &out, usize value) -> void {
+  while (value >= 0x80) {
+    out.push_back(static_cast<u8>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<u8>(value));
+}
+
+auto get_varint(const u8 *&in) -> usize {
+  usize value = 0;
+  for (u32 shift = 0;; shift += 7) {
+    u8 byte = *in++;
+    value |= static_cast<usize>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return value;
+  }
+}
+
+/// Decodes every front-coded name in order, calling `fn(id, name)`
+template <typename F>
+auto each_name(const std::vector<u8> &names, u32 count, F &&fn) -> void {
+  std::string name;
+  const u8 *in = names.data();
+  for (u32 i = 0; i < count; i++) {
+    usize shared = get_varint(in);
+    usize length = get_varint(in);
+
+    name.resize(shared);
+    name.append(reinterpret_cast<const char *>(in), length);
+    in += length;
+
+    fn(i, std::string_view(name));
+  }
+}
+
+auto tag_of(u64 hash) -> u8 { return static_cast<u8>(hash >> 56); }
+
+auto components(const path_type &path) -> std::vector<std::string> {
+  std::vector<std::string> comps;
+  for (const auto &comp : path)
+    comps.push_back(comp.string());
+  return comps;
+}
+
+} // namespace
+
+auto PathTable::iterator::operator*() const -> path_type {
+  return table->path(table->entries[index]);
+}
+
+auto PathTable::iterator::id() const -> id_type {
+  return table->entries[index];
+}
+
+auto PathTable::insert(const path_type &path) -> id_type {
+  id_type node = root;
+  for (const auto &comp : components(path)) {
+    id_type name_id = intern(comp);
+    id_type child = lookup_child(node, name_id);
+
+    if (child == root) {
+      if ((nodes.size() + 1) * 4 > child_slots.size() * 3)
+        grow_children();
+
+      child = static_cast<id_type>(nodes.size());
+      nodes.push_back({node, name_id});
+
+      usize mask = child_slots.size() - 1;
+      usize slot = hash_child(node, name_id) & mask;
+      while (child_slots[slot] != 0)
+        slot = (slot + 1) & mask;
+      child_slots[slot] = child + 1;
+    }
+
+    node = child;
+  }
+
+  if (node == root)
+    return root;
+
+  if (!is_entry(node)) {
+    if (entry_bits.size() <= node / 64)
+      entry_bits.resize(node / 64 + 1, 0);
+
+    entry_bits[node / 64] |= u64{1} << (node % 64);
+    entries.push_back(node);
+  }
+
+  return node;
+}
+
+auto PathTable::find(const path_type &path) const
+    -> manifold::result<id_type, fs::Error> {
+  id_type node = root;
+  for (const auto &comp : components(path)) {
+    id_type name_id = lookup_name(comp, hash_name(comp));
+    if (name_id == root)
+      return manifold::fail(fs::Error::NoFileExists);
+
+    node = lookup_child(node, name_id);
+    if (node == root)
+      return manifold::fail(fs::Error::NoFileExists);
+  }
+
+  if (node == root || !is_entry(node))
+    return manifold::fail(fs::Error::NoFileExists);
+
+  return node;
+}
+
+auto PathTable::contains(const path_type &path) const -> bool {
+  return !find(path).has_error();
+}
+
+auto PathTable::path(id_type id) const -> path_type {
+  std::vector<id_type> chain;
+  for (id_type node = id; node != root; node = nodes[node].parent)
+    chain.push_back(nodes[node].name);
+
+  path_type result;
+  std::string buffer;
+  for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+    decode_name(*it, buffer);
+    result /= path_type(buffer);
+  }
+
+  return result;
+}
+
+auto PathTable::name(id_type id) const -> std::string {
+  std::string buffer;
+  decode_name(nodes[id].name, buffer);
+  return buffer;
+}
+
+auto PathTable::parent(id_type id) const -> id_type {
+  return nodes[id].parent;
+}
+
+auto PathTable::sorted() const -> std::vector<id_type> {
+  // rank every name once, so siblings can be ordered by integer compare
+  std::string pool;
+  std::vector<usize> offsets(name_count + 1, 0);
+  each_name(names, name_count, [&](id_type i, std::string_view name) {
+    pool += name;
+    offsets[i + 1] = pool.size();
+  });
+
+  auto view = [&](id_type i) {
+    return std::string_view(pool.data() + offsets[i],
+                            offsets[i + 1] - offsets[i]);
+  };
+
+  std::vector<id_type> order(name_count);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&](id_type a, id_type b) { return view(a) < view(b); });
+
+  std::vector<id_type> rank(name_count);
+  for (id_type i = 0; i < name_count; i++)
+    rank[order[i]] = i;
+
+  pool.clear();
+  pool.shrink_to_fit();
+
+  // children of each node (CSR), slot 0 holds the top-level components
+  std::vector<usize> first(nodes.size() + 2, 0);
+  for (const auto &node : nodes)
+    first[node.parent == root ? 1 : node.parent + 2]++;
+  std::partial_sum(first.begin(), first.end(), first.begin());
+
+  std::vector<id_type> children(nodes.size());
+  std::vector<usize> fill(first.begin(), first.end() - 1);
+  for (id_type i = 0; i < nodes.size(); i++) {
+    usize group = nodes[i].parent == root ? 0 : nodes[i].parent + 1;
+    children[fill[group]++] = i;
+  }
+
+  for (usize group = 0; group + 1 < first.size(); group++) {
+    std::sort(children.begin() + first[group],
+              children.begin() + first[group + 1], [&](id_type a, id_type b) {
+                return rank[nodes[a].name] < rank[nodes[b].name];
+              });
+  }
+
+  // preorder walk: a parent always sorts before its children
+  std::vector<id_type> result;
+  result.reserve(entries.size());
+
+  std::vector<id_type> stack;
+  for (usize i = first[1]; i > first[0]; i--)
+    stack.push_back(children[i - 1]);
+
+  while (!stack.empty()) {
+    id_type node = stack.back();
+    stack.pop_back();
+
+    if (is_entry(node))
+      result.push_back(node);
+
+    for (usize i = first[node + 2]; i > first[node + 1]; i--)
+      stack.push_back(children[i - 1]);
+  }
+
+  return result;
+}
+
+auto PathTable::clear() -> void {
+  nodes.clear();
+  entries.clear();
+  entry_bits.clear();
+  names.clear();
+  restarts.clear();
+  last_name.clear();
+  name_count = 0;
+  name_slots.clear();
+  name_tags.clear();
+  child_slots.clear();
+}
+
+auto PathTable::shrink_to_fit() -> void {
+  nodes.shrink_to_fit();
+  entries.shrink_to_fit();
+  entry_bits.shrink_to_fit();
+  names.shrink_to_fit();
+  restarts.shrink_to_fit();
+}
+
+auto PathTable::memory_usage() const -> usize {
+  return nodes.capacity() * sizeof(Node) +
+         entries.capacity() * sizeof(id_type) +
+         entry_bits.capacity() * sizeof(u64) + names.capacity() +
+         restarts.capacity() * sizeof(usize) + last_name.capacity() +
+         name_slots.capacity() * sizeof(id_type) + name_tags.capacity() +
+         child_slots.capacity() * sizeof(id_type);
+}
+
+auto PathTable::is_entry(id_type node) const -> bool {
+  return node / 64 < entry_bits.size() &&
+         (entry_bits[node / 64] & (u64{1} << (node % 64)));
+}
+
+auto PathTable::intern(std::string_view name) -> id_type {
+  u64 hash = hash_name(name);
+  id_type found = lookup_name(name, hash);
+  if (found != root)
+    return found;
+
+  if ((name_count + 1) * 4 > name_slots.size() * 3)
+    grow_names();
+
+  id_type id = name_count++;
+
+  // front-code against the previous name, restarting every block
+  usize shared = 0;
+  if (id % kBlockSize == 0) {
+    restarts.push_back(names.size());
+  } else {
+    usize limit = std::min(name.size(), last_name.size());
+    while (shared < limit && name[shared] == last_name[shared])
+      shared++;
+  }
+
+  put_varint(names, shared);
+  put_varint(names, name.size() - shared);
+  names.insert(names.end(), name.begin() + shared, name.end());
+  last_name.assign(name);
+
+  usize mask = name_slots.size() - 1;
+  usize slot = hash & mask;
+  while (name_slots[slot] != 0)
+    slot = (slot + 1) & mask;
+  name_slots[slot] = id + 1;
+  name_tags[slot] = tag_of(hash);
+
+  return id;
+}
+
+auto PathTable::lookup_name(std::string_view name, u64 hash) const
+    -> id_type {
+  if (name_slots.empty())
+    return root;
+
+  u8 tag = tag_of(hash);
+  usize mask = name_slots.size() - 1;
+  std::string buffer;
+
+  for (usize slot = hash & mask; name_slots[slot] != 0;
+       slot = (slot + 1) & mask) {
+    if (name_tags[slot] != tag)
+      continue;
+
+    decode_name(name_slots[slot] - 1, buffer);
+    if (buffer == name)
+      return name_slots[slot] - 1;
+  }
+
+  return root;
+}
+
+auto PathTable::decode_name(id_type name, std::string &out) const -> void {
+  out.clear();
+
+  const u8 *in = names.data() + restarts[name / kBlockSize];
+  for (id_type i = name - name % kBlockSize;; i++) {
+    usize shared = get_varint(in);
+    usize length = get_varint(in);
+
+    out.resize(shared);
+    out.append(reinterpret_cast<const char *>(in), length);
+    in += length;
+
+    if (i == name)
+      return;
+  }
+}
+
+auto PathTable::lookup_child(id_type parent, id_type name) const -> id_type {
+  if (child_slots.empty())
+    return root;
+
+  usize mask = child_slots.size() - 1;
+  for (usize slot = hash_child(parent, name) & mask; child_slots[slot] != 0;
+       slot = (slot + 1) & mask) {
+    const Node &node = nodes[child_slots[slot] - 1];
+    if (node.parent == parent && node.name == name)
+      return child_slots[slot] - 1;
+  }
+
+  return root;
+}
+
+auto PathTable::grow_names() -> void {
+  // only ids are stored in the index, so rehashing re-decodes the names
+  name_slots.assign(name_slots.empty() ? 16 : name_slots.size() * 2, 0);
+  name_tags.assign(name_slots.size(), 0);
+
+  usize mask = name_slots.size() - 1;
+  each_name(names, name_count, [&](id_type id, std::string_view name) {
+    u64 hash = hash_name(name);
+    usize slot = hash & mask;
+    while (name_slots[slot] != 0)
+      slot = (slot + 1) & mask;
+    name_slots[slot] = id + 1;
+    name_tags[slot] = tag_of(hash);
+  });
+}
+
+auto PathTable::grow_children() -> void {
+  child_slots.assign(child_slots.empty() ? 16 : child_slots.size() * 2, 0);
+
+  usize mask = child_slots.size() - 1;
+  for (id_type i = 0; i < nodes.size(); i++) {
+    usize slot = hash_child(nodes[i].parent, nodes[i].name) & mask;
+    while (child_slots[slot] != 0)
+      slot = (slot + 1) & mask;
+    child_slots[slot] = i + 1;
+  }
+}
+
+} // namespace manifold::fs
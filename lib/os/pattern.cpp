@@ -0,0 +1,703 @@
+#include <manifold/os/pattern.hpp>
+#include <mutex>
+
+namespace manifold::str {
+
+namespace {
+
+/// Largest NFA a pattern may compile to (bounded repeats are copies)
+constexpr usize kMaxNodes = 1 << 16;
+
+/// Largest count in `{n,m}`
+constexpr u32 kMaxRepeat = 1000;
+
+constexpr CharSet kAscii = CharSet::range('\0', '\x7f');
+constexpr CharSet kWord = chars::alnum | CharSet("_");
+
+// `Cache::flags` of a DFA state
+constexpr u8 kAccept = 1;
+constexpr u8 kAcceptAtEnd = 2;
+constexpr u8 kDead = 4;
+
+auto hex_digit(char ch) -> int {
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+
+  return -1;
+}
+
+/// Adds the other case of every ASCII letter in `set`
+auto fold(CharSet set) -> CharSet {
+  for (char ch = 'a'; ch <= 'z'; ch++) {
+    auto upper = static_cast<char>(ch - 32);
+    if (set.contains(ch) || set.contains(upper)) {
+      set.insert(ch);
+      set.insert(upper);
+    }
+  }
+
+  return set;
+}
+
+} // namespace
+
+/// Recursive descent over the pattern, emitting a Thompson NFA as it goes
+struct Pattern::Compiler {
+  /// Nodes whose `out` (even) or `alt` (odd) edge is yet to be set, as
+  /// `node * 2 + edge`
+  using holes_type = std::vector<u32>;
+
+  struct Fragment {
+    u32 start = 0;
+    holes_type holes;
+  };
+
+  Pattern &pattern;
+  std::string_view source;
+  bool ignore_case;
+  usize pos = 0;
+  std::optional<PatternError> error;
+
+  auto fail(PatternError::Kind kind, usize offset) -> Fragment {
+    if (!error)
+      error = PatternError{kind, offset};
+
+    return {};
+  }
+
+  auto emit(Node node) -> u32 {
+    if (pattern.nodes.size() >= kMaxNodes)
+      fail(PatternError::Kind::TooLarge, pos);
+
+    pattern.nodes.push_back(node);
+    return static_cast<u32>(pattern.nodes.size() - 1);
+  }
+
+  auto patch(const holes_type &holes, u32 target) -> void {
+    for (u32 hole : holes) {
+      Node &node = pattern.nodes[hole / 2];
+      (hole % 2 == 0 ? node.out : node.alt) = target;
+    }
+  }
+
+  auto empty() -> Fragment {
+    u32 node = emit(Node{Node::Op::Jump});
+    return {node, {node * 2}};
+  }
+
+  auto bytes(const CharSet &set) -> Fragment {
+    auto found = std::find(pattern.sets.begin(), pattern.sets.end(), set);
+    auto index = static_cast<u32>(found - pattern.sets.begin());
+    if (found == pattern.sets.end())
+      pattern.sets.push_back(set);
+
+    u32 node = emit(Node{Node::Op::Byte, index});
+    return {node, {node * 2}};
+  }
+
+  auto sequence(Fragment first, Fragment second) -> Fragment {
+    patch(first.holes, second.start);
+    return {first.start, std::move(second.holes)};
+  }
+
+  auto either(Fragment first, Fragment second) -> Fragment {
+    u32 split = emit(Node{Node::Op::Split, 0, first.start, second.start});
+    first.holes.insert(first.holes.end(), second.holes.begin(),
+                       second.holes.end());
+    return {split, std::move(first.holes)};
+  }
+
+  auto optional(Fragment body) -> Fragment {
+    u32 split = emit(Node{Node::Op::Split, 0, body.start});
+    body.holes.push_back(split * 2 + 1);
+    return {split, std::move(body.holes)};
+  }
+
+  auto star(Fragment body) -> Fragment {
+    u32 split = emit(Node{Node::Op::Split, 0, body.start});
+    patch(body.holes, split);
+    return {split, {split * 2 + 1}};
+  }
+
+  auto plus(Fragment body) -> Fragment {
+    u32 split = emit(Node{Node::Op::Split, 0, body.start});
+    patch(body.holes, split);
+    return {body.start, {split * 2 + 1}};
+  }
+
+  /// Any UTF-8 sequence of two to four bytes (by lead byte, without checking
+  /// for overlong forms)
+  auto multibyte() -> Fragment {
+    const CharSet tail = CharSet::range('\x80', '\xbf');
+    Fragment two = sequence(bytes(CharSet::range('\xc2', '\xdf')),
+                            bytes(tail));
+    Fragment three = bytes(CharSet::range('\xe0', '\xef'));
+    for (int i = 0; i < 2; i++)
+      three = sequence(std::move(three), bytes(tail));
+
+    Fragment four = bytes(CharSet::range('\xf0', '\xf4'));
+    for (int i = 0; i < 3; i++)
+      four = sequence(std::move(four), bytes(tail));
+
+    return either(std::move(two), either(std::move(three), std::move(four)));
+  }
+
+  /// Bytes of `set`, or with `non_ascii` any multibyte sequence as well
+  auto characters(const CharSet &set, bool non_ascii) -> Fragment {
+    if (!non_ascii)
+      return bytes(set);
+
+    if (set.empty())
+      return multibyte();
+
+    return either(bytes(set), multibyte());
+  }
+
+  /// Reads an escape at `pos`, adding a class to `set` (returning -1) or
+  /// returning the byte it stands for
+  auto escape(CharSet &set, bool &non_ascii) -> int {
+    usize at = pos++;
+    if (pos >= source.size()) {
+      fail(PatternError::Kind::BadEscape, at);
+      return -1;
+    }
+
+    char ch = source[pos++];
+    switch (ch) {
+    case 'd':
+      set = set | chars::digits;
+      return -1;
+    case 'w':
+      set = set | kWord;
+      return -1;
+    case 's':
+      set = set | chars::whitespace;
+      return -1;
+    case 'D':
+      set = set | (~chars::digits & kAscii);
+      non_ascii = true;
+      return -1;
+    case 'W':
+      set = set | (~kWord & kAscii);
+      non_ascii = true;
+      return -1;
+    case 'S':
+      set = set | (~chars::whitespace & kAscii);
+      non_ascii = true;
+      return -1;
+    case 'n':
+      return '\n';
+    case 't':
+      return '\t';
+    case 'r':
+      return '\r';
+    case 'f':
+      return '\f';
+    case 'v':
+      return '\v';
+    case 'x': {
+      int high = pos + 2 <= source.size() ? hex_digit(source[pos]) : -1;
+      int low = pos + 2 <= source.size() ? hex_digit(source[pos + 1]) : -1;
+      if (high < 0 || low < 0) {
+        fail(PatternError::Kind::BadEscape, at);
+        return -1;
+      }
+
+      pos += 2;
+      return high * 16 + low;
+    }
+    default:
+      if (static_cast<u8>(ch) < 0x80 && !chars::alnum.contains(ch))
+        return static_cast<u8>(ch);
+
+      fail(PatternError::Kind::BadEscape, at);
+      return -1;
+    }
+  }
+
+  /// One byte of a bracket class at `pos`, or -1 for a class escape
+  auto class_member(CharSet &set, bool &non_ascii) -> int {
+    char ch = source[pos];
+    if (ch == '\\')
+      return escape(set, non_ascii);
+
+    if (static_cast<u8>(ch) >= 0x80) {
+      fail(PatternError::Kind::NonAsciiClass, pos);
+      return -1;
+    }
+
+    pos++;
+    return static_cast<u8>(ch);
+  }
+
+  auto bracket() -> Fragment {
+    usize open = pos++;
+    bool negated = pos < source.size() && source[pos] == '^';
+    if (negated)
+      pos++;
+
+    CharSet set;
+    bool non_ascii = false;
+    // a ']' straight after the opening bracket is a member
+    for (bool first = true;; first = false) {
+      if (pos >= source.size())
+        return fail(PatternError::Kind::UnterminatedClass, open);
+
+      if (source[pos] == ']' && !first) {
+        pos++;
+        break;
+      }
+
+      usize at = pos;
+      int low = class_member(set, non_ascii);
+      if (error)
+        return {};
+
+      if (low < 0)
+        continue;
+
+      if (pos + 1 < source.size() && source[pos] == '-' &&
+          source[pos + 1] != ']') {
+        pos++;
+        int high = class_member(set, non_ascii);
+        if (error)
+          return {};
+
+        if (high < low)
+          return fail(PatternError::Kind::BadRange, at);
+
+        set = set | CharSet::range(static_cast<char>(low),
+                                   static_cast<char>(high));
+      } else {
+        set.insert(static_cast<char>(low));
+      }
+    }
+
+    if (ignore_case)
+      set = fold(set);
+
+    if (negated)
+      return characters(~set & kAscii, !non_ascii);
+
+    return characters(set, non_ascii);
+  }
+
+  auto atom() -> Fragment {
+    char ch = source[pos];
+    switch (ch) {
+    case '(': {
+      usize open = pos++;
+      if (source.substr(pos, 2) == "?:")
+        pos += 2;
+
+      Fragment body = alternation();
+      if (error)
+        return {};
+
+      if (pos >= source.size() || source[pos] != ')')
+        return fail(PatternError::Kind::UnbalancedGroup, open);
+
+      pos++;
+      return body;
+    }
+    case '*':
+    case '+':
+    case '?':
+    case '{':
+      return fail(PatternError::Kind::NothingToRepeat, pos);
+    case '^': {
+      pos++;
+      u32 node = emit(Node{Node::Op::Begin});
+      return {node, {node * 2}};
+    }
+    case '$': {
+      pos++;
+      u32 node = emit(Node{Node::Op::End});
+      return {node, {node * 2}};
+    }
+    case '.':
+      pos++;
+      return characters(~CharSet("\n") & kAscii, true);
+    case '[':
+      return bracket();
+    case '\\': {
+      CharSet set;
+      bool non_ascii = false;
+      int byte = escape(set, non_ascii);
+      if (error)
+        return {};
+
+      if (byte >= 0)
+        set.insert(static_cast<char>(byte));
+
+      return characters(ignore_case ? fold(set) : set, non_ascii);
+    }
+    default: {
+      pos++;
+      CharSet set;
+      set.insert(ch);
+      return bytes(ignore_case ? fold(set) : set);
+    }
+    }
+  }
+
+  /// Reads the number at `pos` of a `{n,m}` repeat
+  auto count(usize open) -> std::optional<u32> {
+    usize begin = pos;
+    while (pos < source.size() && chars::digits.contains(source[pos]))
+      pos++;
+
+    auto value = parse<u32>(source.substr(begin, pos - begin));
+    if (value.has_error() || value.value() > kMaxRepeat) {
+      fail(PatternError::Kind::BadRepeat, open);
+      return std::nullopt;
+    }
+
+    return value.value();
+  }
+
+  auto repeat() -> Fragment {
+    usize begin = pos;
+    Fragment body = atom();
+    if (error || pos >= source.size())
+      return body;
+
+    u32 min = 0;
+    u32 max = 0;
+    bool unbounded = false;
+    usize open = pos;
+    switch (source[pos]) {
+    case '*':
+      unbounded = true;
+      break;
+    case '+':
+      min = 1;
+      unbounded = true;
+      break;
+    case '?':
+      max = 1;
+      break;
+    case '{': {
+      pos++;
+      auto low = count(open);
+      if (!low)
+        return {};
+
+      min = max = *low;
+      if (pos < source.size() && source[pos] == ',') {
+        pos++;
+        if (pos < source.size() && source[pos] == '}') {
+          unbounded = true;
+        } else {
+          auto high = count(open);
+          if (!high)
+            return {};
+
+          max = *high;
+        }
+      }
+
+      if (pos >= source.size() || source[pos] != '}' ||
+          (!unbounded && max < min))
+        return fail(PatternError::Kind::BadRepeat, open);
+
+      break;
+    }
+    default:
+      return body;
+    }
+
+    pos++;
+    // lazy repeats match the same texts, which is all a DFA can tell
+    if (pos < source.size() && source[pos] == '?')
+      pos++;
+
+    if (pos < source.size() &&
+        (source[pos] == '*' || source[pos] == '+' || source[pos] == '?' ||
+         source[pos] == '{'))
+      return fail(PatternError::Kind::BadRepeat, pos);
+
+    if (min == 0 && unbounded)
+      return star(std::move(body));
+    if (min == 1 && unbounded)
+      return plus(std::move(body));
+    if (min == 0 && max == 1)
+      return optional(std::move(body));
+
+    // `{n,m}` is n copies, then m - n optional ones (or a starred one); the
+    // copies come from parsing the atom again
+    usize after = pos;
+    bool used = false;
+    auto copy = [&]() -> Fragment {
+      if (!used) {
+        used = true;
+        return std::move(body);
+      }
+
+      pos = begin;
+      Fragment again = atom();
+      pos = after;
+      return again;
+    };
+
+    std::optional<Fragment> result;
+    auto append = [&](Fragment next) {
+      result = result ? sequence(std::move(*result), std::move(next))
+                      : std::move(next);
+    };
+
+    for (u32 i = 0; i < min && !error; i++)
+      append(copy());
+
+    if (unbounded) {
+      append(star(copy()));
+    } else {
+      for (u32 i = min; i < max && !error; i++)
+        append(optional(copy()));
+    }
+
+    if (error)
+      return {};
+
+    return result ? std::move(*result) : empty();
+  }
+
+  auto concatenation() -> Fragment {
+    std::optional<Fragment> result;
+    while (pos < source.size() && source[pos] != '|' && source[pos] != ')') {
+      Fragment next = repeat();
+      if (error)
+        return {};
+
+      result = result ? sequence(std::move(*result), std::move(next))
+                      : std::move(next);
+    }
+
+    return result ? std::move(*result) : empty();
+  }
+
+  auto alternation() -> Fragment {
+    Fragment result = concatenation();
+    while (!error && pos < source.size() && source[pos] == '|') {
+      pos++;
+      Fragment next = concatenation();
+      result = either(std::move(result), std::move(next));
+    }
+
+    return result;
+  }
+};
+
+struct Pattern::CachePool {
+  std::mutex lock;
+  std::vector<std::unique_ptr<Cache>> idle;
+};
+
+auto Pattern::compile(std::string_view source, const PatternOptions &options)
+    -> manifold::result<Pattern, PatternError> {
+  Pattern pattern;
+  pattern.caches = std::make_shared<CachePool>();
+  Compiler compiler{pattern, source, options.ignore_case, 0, std::nullopt};
+  Compiler::Fragment body = compiler.alternation();
+  if (!compiler.error && compiler.pos < source.size())
+    compiler.fail(PatternError::Kind::UnbalancedGroup, compiler.pos);
+
+  u32 match = compiler.emit(Node{Node::Op::Match});
+  compiler.patch(body.holes, match);
+  pattern.anchored_start = body.start;
+
+  // searching starts the pattern at every byte, by looping over any byte
+  // before it
+  Compiler::Fragment skip = compiler.star(compiler.bytes(~CharSet()));
+  compiler.patch(skip.holes, body.start);
+  pattern.search_start = skip.start;
+  if (compiler.error)
+    return fail(*compiler.error);
+
+  // each set splits the classes so far into the bytes in and out of it
+  usize count = 1;
+  for (const CharSet &set : pattern.sets) {
+    std::array<i32, 512> renamed;
+    renamed.fill(-1);
+    usize next = 0;
+    for (usize byte = 0; byte < 256; byte++) {
+      usize key = pattern.classes[byte] * 2 +
+                  (set.contains(static_cast<char>(byte)) ? 1 : 0);
+      if (renamed[key] < 0)
+        renamed[key] = static_cast<i32>(next++);
+
+      pattern.classes[byte] = static_cast<u8>(renamed[key]);
+    }
+
+    count = next;
+  }
+
+  pattern.representatives.assign(count, 0);
+  for (usize byte = 256; byte-- > 0;)
+    pattern.representatives[pattern.classes[byte]] = static_cast<u8>(byte);
+
+  return pattern;
+}
+
+auto Pattern::follow(u32 node, bool at_start, bool at_end,
+                     std::vector<u32> &members, std::vector<bool> &seen) const
+    -> void {
+  std::vector<u32> stack = {node};
+  while (!stack.empty()) {
+    u32 at = stack.back();
+    stack.pop_back();
+    if (seen[at])
+      continue;
+
+    seen[at] = true;
+    const Node &current = nodes[at];
+    switch (current.op) {
+    case Node::Op::Split:
+      stack.push_back(current.alt);
+      stack.push_back(current.out);
+      break;
+    case Node::Op::Jump:
+      stack.push_back(current.out);
+      break;
+    case Node::Op::Begin:
+      if (at_start)
+        stack.push_back(current.out);
+      break;
+    case Node::Op::End:
+      // kept, for a state to tell if it accepts once the text is over
+      members.push_back(at);
+      if (at_end)
+        stack.push_back(current.out);
+      break;
+    case Node::Op::Byte:
+    case Node::Op::Match:
+      members.push_back(at);
+      break;
+    }
+  }
+}
+
+auto Pattern::add_state(Cache &cache, std::vector<u32> &members,
+                        bool at_start) const -> state_type {
+  std::sort(members.begin(), members.end());
+  std::string key(1, at_start ? 's' : 'n');
+  key.append(reinterpret_cast<const char *>(members.data()),
+             members.size() * sizeof(u32));
+  if (auto found = cache.ids.find(key); found != cache.ids.end())
+    return found->second;
+
+  u8 flags = members.empty() ? kDead : 0;
+  std::vector<u32> at_end;
+  std::vector<bool> seen(nodes.size());
+  for (u32 member : members) {
+    if (nodes[member].op == Node::Op::Match)
+      flags |= kAccept | kAcceptAtEnd;
+    else if (nodes[member].op == Node::Op::End)
+      follow(nodes[member].out, at_start, true, at_end, seen);
+  }
+
+  for (u32 member : at_end) {
+    if (nodes[member].op == Node::Op::Match)
+      flags |= kAcceptAtEnd;
+  }
+
+  auto state = static_cast<state_type>(cache.keys.size());
+  cache.ids.emplace(key, state);
+  cache.keys.push_back(std::move(key));
+  cache.next.resize(cache.next.size() + representatives.size(), unknown);
+  cache.flags.push_back(flags);
+  return state;
+}
+
+auto Pattern::start(Cache &cache, bool anchored) const -> state_type {
+  state_type &state = cache.starts[anchored ? 0 : 1];
+  if (state != unknown)
+    return state;
+
+  std::vector<u32> members;
+  std::vector<bool> seen(nodes.size());
+  follow(anchored ? anchored_start : search_start, true, false, members, seen);
+  if (cache.keys.size() >= kMaxStates)
+    cache.clear();
+
+  state = add_state(cache, members, true);
+  return state;
+}
+
+auto Pattern::step(Cache &cache, state_type state, u8 cls) const
+    -> state_type {
+  auto byte = static_cast<char>(representatives[cls]);
+  const std::string &key = cache.keys[state];
+  std::vector<u32> members;
+  std::vector<bool> seen(nodes.size());
+  for (usize at = 1; at < key.size(); at += sizeof(u32)) {
+    u32 member;
+    std::memcpy(&member, key.data() + at, sizeof(member));
+    const Node &node = nodes[member];
+    if (node.op == Node::Op::Byte && sets[node.set].contains(byte))
+      follow(node.out, false, false, members, seen);
+  }
+
+  // a full cache starts over, from the state about to be added
+  if (cache.keys.size() >= kMaxStates) {
+    cache.clear();
+    return add_state(cache, members, false);
+  }
+
+  state_type next = add_state(cache, members, false);
+  cache.next[state * representatives.size() + cls] = next;
+  return next;
+}
+
+auto Pattern::run(std::string_view text, bool anchored) const -> bool {
+  std::unique_ptr<Cache> cache;
+  {
+    std::lock_guard guard(caches->lock);
+    if (!caches->idle.empty()) {
+      cache = std::move(caches->idle.back());
+      caches->idle.pop_back();
+    }
+  }
+
+  // one cache per thread matching at once, kept for the pattern's lifetime
+  if (cache == nullptr)
+    cache = std::make_unique<Cache>();
+
+  bool matched = run(*cache, text, anchored);
+  std::lock_guard guard(caches->lock);
+  caches->idle.push_back(std::move(cache));
+  return matched;
+}
+
+auto Pattern::run(Cache &cache, std::string_view text, bool anchored) const
+    -> bool {
+  // a search is over at the first accepting state, a whole match at the
+  // first dead one
+  const u8 stop = anchored ? kDead : kAccept;
+  usize stride = representatives.size();
+  state_type state = start(cache, anchored);
+  for (char ch : text) {
+    if (cache.flags[state] & stop)
+      return !anchored;
+
+    u8 cls = classes[static_cast<u8>(ch)];
+    state_type next = cache.next[state * stride + cls];
+    state = next != unknown ? next : step(cache, state, cls);
+  }
+
+  return (cache.flags[state] & kAcceptAtEnd) != 0;
+}
+
+auto Pattern::matches(std::string_view text) const -> bool {
+  return run(text, true);
+}
+
+auto Pattern::search(std::string_view text) const -> bool {
+  return run(text, false);
+}
+
+} // namespace manifold::str
@@ -0,0 +1,181 @@
+#include <manifold/os/str.hpp>
+#include <algorithm>
+#include <numeric>
+
+namespace manifold::str {
+
+namespace {
+
+auto views_of(std::span<const std::string> patterns)
+    -> std::vector<std::string_view> {
+  return std::vector<std::string_view>(patterns.begin(), patterns.end());
+}
+
+} // namespace
+
+PrefixSet::PrefixSet(std::initializer_list<std::string_view> patterns) {
+  build(std::span<const std::string_view>(patterns.begin(), patterns.size()));
+}
+
+PrefixSet::PrefixSet(std::span<const std::string_view> patterns) {
+  build(patterns);
+}
+
+PrefixSet::PrefixSet(std::span<const std::string> patterns) {
+  build(views_of(patterns));
+}
+
+auto PrefixSet::build(std::span<const std::string_view> patterns) -> void {
+  count = patterns.size();
+
+  // Sorted, every node's patterns are one contiguous range that starts with
+  // the pattern ending at the node, and each child's is a sub-range. Equal
+  // patterns stay in ID order so the first one is taken.
+  std::vector<u32> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](u32 a, u32 b) {
+    return patterns[a] < patterns[b];
+  });
+  auto pattern = [&](usize i) { return patterns[order[i]]; };
+
+  struct Pending {
+    u32 node;
+    usize begin;
+    usize end;
+    /// Length of the path from the root to the node
+    usize depth;
+  };
+
+  nodes.assign(1, Node{});
+  first_bytes.assign(1, 0);
+  labels.clear();
+
+  // nodes are added in breadth-first order, so siblings end up adjacent
+  std::vector<Pending> queue{{0, 0, count, 0}};
+  for (usize head = 0; head < queue.size(); head++) {
+    auto [node, begin, end, depth] = queue[head];
+    if (begin < end && pattern(begin).size() == depth)
+      nodes[node].id = order[begin];
+
+    while (begin < end && pattern(begin).size() == depth)
+      begin++;
+
+    nodes[node].first_child = static_cast<u32>(nodes.size());
+    while (begin < end) {
+      char byte = pattern(begin)[depth];
+      usize group = begin + 1;
+      while (group < end && pattern(group)[depth] == byte)
+        group++;
+
+      // the label runs as far as the first and last pattern of the group
+      // (and so all of them) agree
+      std::string_view first = pattern(begin);
+      std::string_view last = pattern(group - 1);
+      usize shared = depth + 1;
+      while (shared < first.size() && shared < last.size() &&
+             first[shared] == last[shared])
+        shared++;
+
+      Node child;
+      child.label = static_cast<u32>(labels.size());
+      child.label_size = static_cast<u32>(shared - depth);
+      labels.append(first.substr(depth, shared - depth));
+
+      queue.push_back({static_cast<u32>(nodes.size()), begin, group, shared});
+      nodes.push_back(child);
+      first_bytes.push_back(static_cast<u8>(byte));
+      nodes[node].child_count++;
+      begin = group;
+    }
+  }
+
+  root_edges.assign(256, 0);
+  for (u32 i = 0; i < nodes[0].child_count; i++)
+    root_edges[first_bytes[nodes[0].first_child + i]] =
+        nodes[0].first_child + i;
+}
+
+template <bool Reverse>
+auto PrefixSet::walk(std::string_view text) const -> std::optional<Match> {
+  if (nodes.empty())
+    return std::nullopt;
+
+  auto byte_at = [&](usize i) {
+    return static_cast<u8>(Reverse ? text[text.size() - 1 - i] : text[i]);
+  };
+
+  std::optional<Match> best;
+  if (nodes[0].id != none)
+    best = Match{nodes[0].id, 0};
+
+  u32 node = 0;
+  usize offset = 0;
+  while (offset < text.size()) {
+    u8 byte = byte_at(offset);
+    u32 child = 0;
+    if (node == 0) {
+      child = root_edges[byte];
+      if (child == 0)
+        break;
+    } else {
+      const u8 *begin = first_bytes.data() + nodes[node].first_child;
+      const u8 *end = begin + nodes[node].child_count;
+      const u8 *edge = std::lower_bound(begin, end, byte);
+      if (edge == end || *edge != byte)
+        break;
+
+      child = static_cast<u32>(edge - first_bytes.data());
+    }
+
+    const Node &next = nodes[child];
+    if (next.label_size > text.size() - offset)
+      break;
+
+    const char *label = labels.data() + next.label;
+    if constexpr (Reverse) {
+      usize i = 1;
+      while (i < next.label_size &&
+             static_cast<u8>(label[i]) == byte_at(offset + i))
+        i++;
+
+      if (i < next.label_size)
+        break;
+    } else {
+      if (std::memcmp(label, text.data() + offset, next.label_size) != 0)
+        break;
+    }
+
+    offset += next.label_size;
+    node = child;
+    if (next.id != none)
+      best = Match{next.id, offset};
+  }
+
+  return best;
+}
+
+auto PrefixSet::longest(std::string_view text) const -> std::optional<Match> {
+  return walk<false>(text);
+}
+
+SuffixSet::SuffixSet(std::initializer_list<std::string_view> patterns)
+    : SuffixSet(std::span<const std::string_view>(patterns.begin(),
+                                                  patterns.size())) {}
+
+SuffixSet::SuffixSet(std::span<const std::string_view> patterns) {
+  std::vector<std::string> copies;
+  copies.reserve(patterns.size());
+  for (auto pattern : patterns)
+    copies.emplace_back(pattern.rbegin(), pattern.rend());
+
+  reversed.build(views_of(copies));
+}
+
+SuffixSet::SuffixSet(std::span<const std::string> patterns)
+    : SuffixSet(views_of(patterns)) {}
+
+auto SuffixSet::longest(std::string_view text) const -> std::optional<Match> {
+  return reversed.walk<true>(text);
+}
+
+} // namespace manifold::str
@@ -0,0 +1,152 @@
+#include "../parallel.hpp"
+#include <manifold/os/fs.hpp>
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+#ifndef MANIFOLD_PLATFORM_WINDOWS
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef MANIFOLD_PLATFORM_LINUX
+#include <linux/fiemap.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+namespace manifold::fs {
+
+namespace {
+
+using bytes_result = manifold::result<std::vector<u8>, fs::Error>;
+
+/// Where a file lives on disk, used to order the reads
+struct Placement {
+  u64 device = 0;
+  bool physical = false; // `offset` is a FIEMAP offset rather than an inode
+  u64 offset = 0;
+
+  auto key() const { return std::make_tuple(device, !physical, offset); }
+};
+
+#ifndef MANIFOLD_PLATFORM_WINDOWS
+auto placement(const path_type &path) -> Placement {
+  Placement place;
+
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return place;
+
+  struct stat st;
+  if (::fstat(fd, &st) == 0) {
+    place.device = static_cast<u64>(st.st_dev);
+    place.offset = static_cast<u64>(st.st_ino);
+  }
+
+#ifdef MANIFOLD_PLATFORM_LINUX
+  // only the first extent is needed to know where reading starts
+  alignas(struct fiemap) u8 buffer[sizeof(struct fiemap) +
+                                   sizeof(struct fiemap_extent)] = {};
+  auto *map = reinterpret_cast<struct fiemap *>(buffer);
+  map->fm_start = 0;
+  map->fm_length = FIEMAP_MAX_OFFSET;
+  map->fm_extent_count = 1;
+
+  if (::ioctl(fd, FS_IOC_FIEMAP, map) == 0 && map->fm_mapped_extents > 0 &&
+      !(map->fm_extents[0].fe_flags & FIEMAP_EXTENT_UNKNOWN)) {
+    place.physical = true;
+    place.offset = static_cast<u64>(map->fm_extents[0].fe_physical);
+  }
+#endif
+
+  ::close(fd);
+  return place;
+}
+
+auto read_whole(const path_type &path) -> bytes_result {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return manifold::fail(errno == ENOENT ? fs::Error::NoFileExists
+                                          : fs::Error::IoError);
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || S_ISDIR(st.st_mode)) {
+    ::close(fd);
+    return manifold::fail(fs::Error::IoError);
+  }
+
+  // size is only a hint (files may change or report 0, e.g. procfs), so a
+  // full buffer is only grown once a small read shows there is more
+  std::vector<u8> contents(static_cast<usize>(std::max<off_t>(st.st_size, 0)));
+  usize length = 0;
+  u8 probe[4096];
+  for (;;) {
+    bool full = length == contents.size();
+    u8 *into = full ? probe : contents.data() + length;
+    usize room = full ? sizeof(probe) : contents.size() - length;
+
+    ssize_t n = ::read(fd, into, room);
+    if (n < 0 && errno == EINTR)
+      continue;
+
+    if (n < 0) {
+      ::close(fd);
+      return manifold::fail(fs::Error::IoError);
+    }
+
+    if (n == 0)
+      break;
+
+    if (full)
+      contents.insert(contents.end(), probe, probe + n);
+
+    length += static_cast<usize>(n);
+  }
+
+  ::close(fd);
+  contents.resize(length);
+  return contents;
+}
+#else
+auto placement(const path_type &) -> Placement { return {}; }
+
+auto read_whole(const path_type &path) -> bytes_result {
+  return read_file_bytes(path);
+}
+#endif
+
+} // namespace
+
+auto read_files(std::span<const path_type> paths, usize concurrency)
+    -> std::vector<bytes_result> {
+  std::vector<bytes_result> results(paths.size(),
+                                    manifold::fail(fs::Error::NoFileExists));
+  if (paths.empty())
+    return results;
+
+  // looking files up costs an open and an ioctl each, which is the same
+  // latency the reads have, so it is spread over the workers as well
+  std::vector<Placement> places(paths.size());
+  manifold::internal::parallel_for(paths.size(), concurrency, [&](usize i) {
+    places[i] = placement(paths[i]);
+  });
+
+  std::vector<usize> order(paths.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](usize a, usize b) {
+    return places[a].key() < places[b].key();
+  });
+
+  // workers pull the next file in disk order
+  manifold::internal::parallel_for(order.size(), concurrency, [&](usize i) {
+    results[order[i]] = read_whole(paths[order[i]]);
+  });
+
+  return results;
+}
+
+} // namespace manifold::fs
@@ -0,0 +1,169 @@
+#include <manifold/os/str.hpp>
+#include <algorithm>
+
+namespace manifold::str {
+
+Replacer::Replacer(std::initializer_list<Rule> rules) {
+  build(std::span<const Rule>(rules.begin(), rules.size()));
+}
+
+Replacer::Replacer(std::span<const Rule> rules) { build(rules); }
+
+auto Replacer::build(std::span<const Rule> rules) -> void {
+  struct Node {
+    std::vector<std::pair<u8, state_type>> children;
+    u32 depth = 0;
+    u32 rule = none;
+  };
+
+  // plain trie first, flattened into sorted edge arrays below
+  std::vector<Node> trie(1);
+  for (const auto &rule : rules) {
+    if (rule.from.empty())
+      continue;
+
+    state_type at = 0;
+    for (char ch : rule.from) {
+      auto byte = static_cast<u8>(ch);
+      auto &children = trie[at].children;
+      auto it =
+          std::find_if(children.begin(), children.end(),
+                       [&](const auto &edge) { return edge.first == byte; });
+      if (it != children.end()) {
+        at = it->second;
+        continue;
+      }
+
+      auto next = static_cast<state_type>(trie.size());
+      children.emplace_back(byte, next);
+      u32 depth = trie[at].depth + 1;
+      trie.push_back(Node{{}, depth, none});
+      at = next;
+    }
+
+    if (trie[at].rule == none) {
+      trie[at].rule = static_cast<u32>(targets.size());
+      lengths.push_back(static_cast<u32>(rule.from.size()));
+      targets.emplace_back(rule.to);
+    }
+  }
+
+  states.assign(trie.size(), State{});
+  for (usize i = 0; i < trie.size(); i++) {
+    auto &children = trie[i].children;
+    std::sort(children.begin(), children.end());
+
+    states[i].first_edge = static_cast<u32>(edge_bytes.size());
+    states[i].edge_count = static_cast<u32>(children.size());
+    states[i].depth = trie[i].depth;
+    for (auto [byte, target] : children) {
+      edge_bytes.push_back(byte);
+      edge_targets.push_back(target);
+    }
+  }
+
+  // the root is hit on nearly every byte, so it gets a dense table
+  root_edges.assign(256, 0);
+  for (auto [byte, target] : trie[0].children)
+    root_edges[byte] = target;
+
+  // failure links in breadth-first order, so every state's fail target (which
+  // is shallower) is complete before it is used
+  std::vector<state_type> queue;
+  for (auto [byte, target] : trie[0].children) {
+    states[target].fail = 0;
+    queue.push_back(target);
+  }
+
+  for (usize head = 0; head < queue.size(); head++) {
+    state_type state = queue[head];
+    auto &current = states[state];
+    current.match = trie[state].rule != none ? trie[state].rule
+                                             : states[current.fail].match;
+
+    for (auto [byte, target] : trie[state].children) {
+      states[target].fail = step(current.fail, byte);
+      queue.push_back(target);
+    }
+  }
+}
+
+auto Replacer::step(state_type state, u8 byte) const -> state_type {
+  while (state != 0) {
+    const auto &current = states[state];
+    const u8 *begin = edge_bytes.data() + current.first_edge;
+    const u8 *end = begin + current.edge_count;
+    const u8 *edge = std::lower_bound(begin, end, byte);
+    if (edge != end && *edge == byte)
+      return edge_targets[static_cast<usize>(edge - edge_bytes.data())];
+
+    state = current.fail;
+  }
+
+  return root_edges[byte];
+}
+
+auto Replacer::find_all(std::string_view text, std::vector<Match> &out) const
+    -> void {
+  if (states.empty())
+    return;
+
+  // The automaton reports the longest rule ending at each position. A pending
+  // match is kept until no rule starting at or before it can still match, it
+  // is then committed and the scan restarts right after it (the restart only
+  // rescans bytes within one rule length).
+  Match pending{0, none};
+  state_type state = 0;
+  usize i = 0;
+  while (i < text.size()) {
+    state = step(state, static_cast<u8>(text[i]));
+    const auto &current = states[state];
+    i++;
+
+    if (current.match != none) {
+      usize start = i - lengths[current.match];
+      if (pending.rule == none || start <= pending.start)
+        pending = {start, current.match};
+    }
+
+    if (pending.rule == none)
+      continue;
+
+    if (pending.start < i - current.depth || i == text.size()) {
+      out.push_back(pending);
+      i = pending.start + lengths[pending.rule];
+      state = 0;
+      pending.rule = none;
+    }
+  }
+}
+
+auto Replacer::replace(std::string_view text) const -> std::string {
+  std::string result;
+  replace(text, result);
+  return result;
+}
+
+auto Replacer::replace(std::string_view text, std::string &out) const
+    -> void {
+  std::vector<Match> matches;
+  find_all(text, matches);
+
+  usize size = text.size();
+  for (const auto &match : matches)
+    size = size - lengths[match.rule] + targets[match.rule].size();
+
+  out.clear();
+  out.reserve(size);
+
+  usize start = 0;
+  for (const auto &match : matches) {
+    out.append(text.substr(start, match.start - start));
+    out.append(targets[match.rule]);
+    start = match.start + lengths[match.rule];
+  }
+
+  out.append(text.substr(start));
+}
+
+} // namespace manifold::str
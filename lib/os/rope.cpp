@@ -0,0 +1,228 @@
+#include <manifold/os/str.hpp>
+
+namespace manifold::str {
+
+auto Rope::next_priority() -> u32 {
+  // splitmix64, only the balance of the tree depends on it
+  u64 x = (seed += 0x9e3779b97f4a7c15UL);
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9UL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebUL;
+  return static_cast<u32>(x ^ (x >> 31));
+}
+
+auto Rope::make_node(std::string_view text, u32 priority) -> node_type {
+  node_type node;
+  if (!free_nodes.empty()) {
+    node = free_nodes.back();
+    free_nodes.pop_back();
+  } else {
+    node = static_cast<node_type>(nodes.size());
+    nodes.emplace_back();
+  }
+
+  auto &created = nodes[node];
+  created.text.assign(text);
+  created.left = none;
+  created.right = none;
+  created.priority = priority;
+  created.length = text.size();
+  return node;
+}
+
+auto Rope::update(node_type node) -> void {
+  auto &current = nodes[node];
+  current.length =
+      length(current.left) + current.text.size() + length(current.right);
+}
+
+auto Rope::merge(node_type left, node_type right) -> node_type {
+  if (left == none)
+    return right;
+
+  if (right == none)
+    return left;
+
+  if (nodes[left].priority > nodes[right].priority) {
+    nodes[left].right = merge(nodes[left].right, right);
+    update(left);
+    return left;
+  }
+
+  nodes[right].left = merge(left, nodes[right].left);
+  update(right);
+  return right;
+}
+
+auto Rope::split(node_type node, usize pos)
+    -> std::pair<node_type, node_type> {
+  if (node == none)
+    return {none, none};
+
+  usize before = length(nodes[node].left);
+  usize after = before + nodes[node].text.size();
+
+  if (pos <= before) {
+    auto [left, right] = split(nodes[node].left, pos);
+    nodes[node].left = right;
+    update(node);
+    return {left, node};
+  }
+
+  if (pos >= after) {
+    auto [left, right] = split(nodes[node].right, pos - after);
+    nodes[node].right = left;
+    update(node);
+    return {node, right};
+  }
+
+  // the cut falls inside this leaf, its tail becomes a node of the same
+  // priority that takes over the right subtree
+  usize cut = pos - before;
+  std::string text = nodes[node].text.substr(cut);
+  nodes[node].text.resize(cut);
+  node_type tail = make_node(text, nodes[node].priority);
+  nodes[tail].right = nodes[node].right;
+  nodes[node].right = none;
+  update(node);
+  update(tail);
+  return {node, tail};
+}
+
+auto Rope::release(node_type node) -> void {
+  if (node == none)
+    return;
+
+  release(nodes[node].left);
+  release(nodes[node].right);
+  std::string().swap(nodes[node].text);
+  free_nodes.push_back(node);
+}
+
+auto Rope::insert(usize pos, std::string_view text) -> void {
+  if (text.empty())
+    return;
+
+  pos = std::min(pos, size());
+
+  // small edits go straight into the leaf they land in, if it has room
+  node_type node = root;
+  usize offset = pos;
+  while (node != none) {
+    usize before = length(nodes[node].left);
+    usize after = before + nodes[node].text.size();
+    if (offset < before) {
+      node = nodes[node].left;
+    } else if (offset > after) {
+      offset -= after;
+      node = nodes[node].right;
+    } else {
+      break;
+    }
+  }
+
+  if (node != none && nodes[node].text.size() + text.size() <= kLeafSize) {
+    // walk the same path again to account for the new bytes
+    node_type at = root;
+    offset = pos;
+    while (at != node) {
+      nodes[at].length += text.size();
+      usize before = length(nodes[at].left);
+      if (offset < before) {
+        at = nodes[at].left;
+      } else {
+        offset -= before + nodes[at].text.size();
+        at = nodes[at].right;
+      }
+    }
+
+    nodes[node].text.insert(offset - length(nodes[node].left), text);
+    nodes[node].length += text.size();
+    return;
+  }
+
+  node_type middle = none;
+  for (usize at = 0; at < text.size(); at += kLeafSize)
+    middle = merge(middle, make_node(text.substr(at, kLeafSize),
+                                     next_priority()));
+
+  auto [left, right] = split(root, pos);
+  root = merge(merge(left, middle), right);
+}
+
+auto Rope::erase(usize pos, usize count) -> void {
+  if (pos >= size() || count == 0)
+    return;
+
+  count = std::min(count, size() - pos);
+  auto [left, rest] = split(root, pos);
+  auto [middle, right] = split(rest, count);
+  release(middle);
+  root = merge(left, right);
+}
+
+auto Rope::at(usize pos) const -> char {
+  node_type node = root;
+  while (true) {
+    usize before = length(nodes[node].left);
+    if (pos < before) {
+      node = nodes[node].left;
+    } else if (pos < before + nodes[node].text.size()) {
+      return nodes[node].text[pos - before];
+    } else {
+      pos -= before + nodes[node].text.size();
+      node = nodes[node].right;
+    }
+  }
+}
+
+auto Rope::visit(node_type node, usize pos, usize count,
+                 const std::function<void(std::string_view)> &fn) const
+    -> void {
+  if (node == none || count == 0)
+    return;
+
+  const auto &current = nodes[node];
+  usize before = length(current.left);
+  usize after = before + current.text.size();
+  usize end = pos + count;
+
+  if (pos < before)
+    visit(current.left, pos, std::min(end, before) - pos, fn);
+
+  if (pos < after && end > before) {
+    usize from = std::max(pos, before) - before;
+    usize to = std::min(end, after) - before;
+    fn(std::string_view(current.text).substr(from, to - from));
+  }
+
+  if (end > after)
+    visit(current.right, std::max(pos, after) - after,
+          end - std::max(pos, after), fn);
+}
+
+auto Rope::substr(usize pos, usize count) const -> std::string {
+  if (pos >= size())
+    return {};
+
+  count = std::min(count, size() - pos);
+  std::string result;
+  result.reserve(count);
+  visit(root, pos, count,
+        [&](std::string_view chunk) { result.append(chunk); });
+  return result;
+}
+
+auto Rope::for_each_chunk(
+    const std::function<void(std::string_view)> &fn) const -> void {
+  visit(root, 0, size(), fn);
+}
+
+auto Rope::to_string() const -> std::string { return substr(0); }
+
+auto Rope::clear() -> void {
+  nodes.clear();
+  free_nodes.clear();
+  root = none;
+}
+
+} // namespace manifold::str
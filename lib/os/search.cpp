@@ -0,0 +1,254 @@
+#include "../simd.hpp"
+#include <manifold/os/str.hpp>
+
+namespace manifold::str {
+
+namespace {
+
+/// Offsets of the two needle bytes the SIMD filter compares
+struct Pair {
+  usize first;
+  usize second;
+};
+
+/// Verifies candidates in `haystack` from `pos` on while whole blocks fit,
+/// leaving `pos` where the caller has to carry on
+using pair_kernel = usize (*)(std::string_view haystack,
+                              std::string_view needle, Pair pair, usize &pos);
+
+/// Rough frequency of a byte in typical text, higher is more common
+auto byte_rank(u8 byte) -> u32 {
+  constexpr std::string_view letters = " etaoinshrdlcumwfgypbvkjxqz";
+  if (auto at = letters.find(static_cast<char>(byte));
+      at != std::string_view::npos)
+    return static_cast<u32>(255 - at);
+
+  if (byte >= '0' && byte <= '9')
+    return 200;
+
+  if (byte >= 'A' && byte <= 'Z')
+    return 190;
+
+  constexpr std::string_view punctuation = "\n\t,.-_/:;=\"'()";
+  if (punctuation.find(static_cast<char>(byte)) != std::string_view::npos)
+    return 180;
+
+  return byte >= 0x20 && byte < 0x7f ? 120 : 60;
+}
+
+/// Picks the two rarest bytes of a needle (2+ bytes), in needle order
+auto rare_pair(std::string_view needle) -> Pair {
+  usize rarest = 0;
+  usize runner_up = 1;
+  if (byte_rank(static_cast<u8>(needle[1])) <
+      byte_rank(static_cast<u8>(needle[0])))
+    std::swap(rarest, runner_up);
+
+  for (usize i = 2; i < needle.size(); i++) {
+    u32 rank = byte_rank(static_cast<u8>(needle[i]));
+    if (rank < byte_rank(static_cast<u8>(needle[rarest]))) {
+      runner_up = rarest;
+      rarest = i;
+    } else if (rank < byte_rank(static_cast<u8>(needle[runner_up]))) {
+      runner_up = i;
+    }
+  }
+
+  return Pair{std::min(rarest, runner_up), std::max(rarest, runner_up)};
+}
+
+#ifdef MANIFOLD_SIMD_X86
+auto find_pair_sse2(std::string_view haystack, std::string_view needle,
+                    Pair pair, usize &pos) -> usize {
+  const usize n = haystack.size();
+  const usize k = needle.size();
+  const char *h = haystack.data();
+
+  const __m128i first = _mm_set1_epi8(needle[pair.first]);
+  const __m128i second = _mm_set1_epi8(needle[pair.second]);
+
+  // every candidate of a block has to fit the whole needle
+  for (; pos + k + 15 <= n; pos += 16) {
+    __m128i a = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(h + pos + pair.first));
+    __m128i b = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(h + pos + pair.second));
+    auto mask = static_cast<u32>(_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, second))));
+
+    for (; mask != 0; mask &= mask - 1) {
+      usize at = pos + static_cast<usize>(__builtin_ctz(mask));
+      if (std::memcmp(h + at, needle.data(), k) == 0)
+        return at;
+    }
+  }
+
+  return std::string_view::npos;
+}
+
+MANIFOLD_TARGET("avx2")
+auto find_pair_avx2(std::string_view haystack, std::string_view needle,
+                    Pair pair, usize &pos) -> usize {
+  const usize n = haystack.size();
+  const usize k = needle.size();
+  const char *h = haystack.data();
+
+  const __m256i first = _mm256_set1_epi8(needle[pair.first]);
+  const __m256i second = _mm256_set1_epi8(needle[pair.second]);
+
+  for (; pos + k + 31 <= n; pos += 32) {
+    __m256i a = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(h + pos + pair.first));
+    __m256i b = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(h + pos + pair.second));
+    auto mask = static_cast<u32>(_mm256_movemask_epi8(_mm256_and_si256(
+        _mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, second))));
+
+    for (; mask != 0; mask &= mask - 1) {
+      usize at = pos + static_cast<usize>(__builtin_ctz(mask));
+      if (std::memcmp(h + at, needle.data(), k) == 0)
+        return at;
+    }
+  }
+
+  return std::string_view::npos;
+}
+#endif
+
+#ifdef MANIFOLD_SIMD_NEON
+auto find_pair_neon(std::string_view haystack, std::string_view needle,
+                    Pair pair, usize &pos) -> usize {
+  const usize n = haystack.size();
+  const usize k = needle.size();
+  const auto *h = reinterpret_cast<const u8 *>(haystack.data());
+
+  const uint8x16_t first = vdupq_n_u8(static_cast<u8>(needle[pair.first]));
+  const uint8x16_t second = vdupq_n_u8(static_cast<u8>(needle[pair.second]));
+
+  for (; pos + k + 15 <= n; pos += 16) {
+    uint8x16_t a = vld1q_u8(h + pos + pair.first);
+    uint8x16_t b = vld1q_u8(h + pos + pair.second);
+    uint8x16_t eq = vandq_u8(vceqq_u8(a, first), vceqq_u8(b, second));
+
+    // narrow to 4 bits per byte (NEON has no movemask), keeping one of them
+    u64 mask = vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+    mask &= 0x8888888888888888UL;
+    for (; mask != 0; mask &= mask - 1) {
+      usize at = pos + static_cast<usize>(__builtin_ctzll(mask)) / 4;
+      if (std::memcmp(h + at, needle.data(), k) == 0)
+        return at;
+    }
+  }
+
+  return std::string_view::npos;
+}
+#endif
+
+auto kernel() -> pair_kernel {
+  static const pair_kernel chosen = []() -> pair_kernel {
+#if defined(MANIFOLD_SIMD_X86)
+    return simd::features().avx2 ? find_pair_avx2 : find_pair_sse2;
+#elif defined(MANIFOLD_SIMD_NEON)
+    return find_pair_neon;
+#else
+    return nullptr;
+#endif
+  }();
+
+  return chosen;
+}
+
+auto find_byte(std::string_view haystack, char byte, usize pos) -> usize {
+  // memchr is already vectorized by every libc we target
+  const void *at =
+      std::memchr(haystack.data() + pos, byte, haystack.size() - pos);
+  return at == nullptr ? std::string_view::npos
+                       : static_cast<usize>(static_cast<const char *>(at) -
+                                            haystack.data());
+}
+
+} // namespace
+
+auto find(std::string_view haystack, std::string_view needle, usize pos)
+    -> usize {
+  if (pos > haystack.size() || needle.size() > haystack.size() - pos)
+    return std::string_view::npos;
+
+  if (needle.empty())
+    return pos;
+
+  if (needle.size() == 1)
+    return find_byte(haystack, needle.front(), pos);
+
+  if (auto search = kernel()) {
+    usize found = search(haystack, needle, rare_pair(needle), pos);
+    if (found != std::string_view::npos)
+      return found;
+  }
+
+  return haystack.find(needle, pos);
+}
+
+Searcher::Searcher(std::string_view needle)
+    : pattern(needle), shifts(256, std::max<usize>(needle.size(), 1)) {
+  if (pattern.size() >= 2) {
+    auto pair = rare_pair(pattern);
+    rare_first = pair.first;
+    rare_second = pair.second;
+  }
+
+  for (usize i = 0; i + 1 < pattern.size(); i++)
+    shifts[static_cast<u8>(pattern[i])] = pattern.size() - 1 - i;
+}
+
+auto Searcher::find_scalar(std::string_view haystack, usize pos) const
+    -> usize {
+  // Horspool: shift by how far the last byte of the window is from the end
+  // of the needle
+  const usize k = pattern.size();
+  const char last = pattern.back();
+  while (pos + k <= haystack.size()) {
+    char ch = haystack[pos + k - 1];
+    if (ch == last && std::memcmp(haystack.data() + pos, pattern.data(),
+                                  k - 1) == 0)
+      return pos;
+
+    pos += shifts[static_cast<u8>(ch)];
+  }
+
+  return std::string_view::npos;
+}
+
+auto Searcher::find(std::string_view haystack, usize pos) const -> usize {
+  if (pos > haystack.size() || pattern.size() > haystack.size() - pos)
+    return std::string_view::npos;
+
+  if (pattern.empty())
+    return pos;
+
+  if (pattern.size() == 1)
+    return find_byte(haystack, pattern.front(), pos);
+
+  if (auto search = kernel()) {
+    usize found = search(haystack, pattern, {rare_first, rare_second}, pos);
+    if (found != std::string_view::npos)
+      return found;
+  }
+
+  return find_scalar(haystack, pos);
+}
+
+auto Searcher::count(std::string_view haystack) const -> usize {
+  if (pattern.empty())
+    return 0;
+
+  usize matches = 0;
+  for (usize pos = find(haystack); pos != std::string_view::npos;
+       pos = find(haystack, pos + pattern.size()))
+    matches++;
+
+  return matches;
+}
+
+} // namespace manifold::str
@@ -1,69 +1,243 @@
+#include "../simd.hpp"
+#include <cctype>
 #include <manifold/os/str.hpp>
+#include <random>
 #include <span>
 
 namespace manifold::str {
 
-auto ends_with(const std::string &str, const std::string &suffix) -> bool {
-  if (str.length() >= suffix.length()) {
-    return (0 == str.compare(str.length() - suffix.length(), suffix.length(),
-                             suffix));
+SplitView::iterator::iterator(std::string_view source,
+                              std::string_view delimiter)
+    : str(source), delim(delimiter), done(source.empty()) {
+  if (!done) {
+    next = 0;
+    ++*this;
   }
+}
+
+auto SplitView::iterator::operator++() -> iterator & {
+  if (next == std::string_view::npos) {
+    done = true;
+    piece = {};
+    return *this;
+  }
+
+  usize start = next;
+  if (delim.empty()) {
+    // no delimiter, every char is a piece
+    piece = str.substr(start, 1);
+    next = start + 1 < str.size() ? start + 1 : std::string_view::npos;
+    return *this;
+  }
+
+  usize end = manifold::str::find(str, delim, start);
+  if (end == std::string_view::npos) {
+    piece = str.substr(start);
+    next = std::string_view::npos;
+  } else {
+    piece = str.substr(start, end - start);
+    next = end + delim.size();
+  }
+
+  return *this;
+}
+
+auto split_view(std::string_view str, std::string_view delim) -> SplitView {
+  return SplitView(str, delim);
+}
+
+SeededHash::SeededHash() {
+  // drawn once, every table in the process shares it
+  static const std::array<u64, 2> process_key = [] {
+    std::random_device device;
+    auto draw = [&] {
+      return (static_cast<u64>(device()) << 32) ^ static_cast<u64>(device());
+    };
+
+    return std::array<u64, 2>{draw(), draw()};
+  }();
 
-  return false;
+  key = process_key;
 }
 
-auto starts_with(const std::string &str, const std::string &prefix) -> bool {
-  if (str.length() >= prefix.length()) {
-    return (0 == str.compare(0, prefix.length(), prefix));
+namespace {
+
+auto is_space(char ch) -> bool {
+  return std::isspace(static_cast<unsigned char>(ch)) != 0;
+}
+
+// ASCII case conversion flips bit 0x20 of every byte in [first, first + 26),
+// with first being 'A' to lower and 'a' to upper a string
+using case_kernel = void (*)(const char *, char *, usize, char);
+
+auto flip_case(char ch, char first) -> char {
+  auto offset = static_cast<u8>(ch - first);
+  return offset < 26 ? static_cast<char>(ch ^ 0x20) : ch;
+}
+
+[[maybe_unused]] auto convert_case_scalar(const char *src, char *dst, usize n,
+                                          char first) -> void {
+  for (usize i = 0; i < n; i++)
+    dst[i] = flip_case(src[i], first);
+}
+
+#ifdef MANIFOLD_SIMD_X86
+// Bytes in range are found with one signed compare: biasing by 0x80 - first
+// maps the range onto [-128, -102).
+auto convert_case_sse2(const char *src, char *dst, usize n, char first)
+    -> void {
+  const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80 - first));
+  const __m128i limit = _mm_set1_epi8(-128 + 26);
+  const __m128i flip = _mm_set1_epi8(0x20);
+
+  usize i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i in = _mm_cmplt_epi8(_mm_add_epi8(x, bias), limit);
+    x = _mm_xor_si128(x, _mm_and_si128(in, flip));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), x);
   }
 
-  return false;
+  for (; i < n; i++)
+    dst[i] = flip_case(src[i], first);
 }
 
-auto split(const std::string &str, const std::string &delim)
-    -> std::vector<std::string> {
-  if (str.empty())
-    return {};
+MANIFOLD_TARGET("avx2")
+auto convert_case_avx2(const char *src, char *dst, usize n, char first)
+    -> void {
+  const __m256i bias = _mm256_set1_epi8(static_cast<char>(0x80 - first));
+  const __m256i limit = _mm256_set1_epi8(-128 + 26);
+  const __m256i flip = _mm256_set1_epi8(0x20);
 
-  if (delim.empty()) {
-    // split into chars
-    std::vector<std::string> result;
-    for (size_t i = 0; i < str.length(); i++) {
-      result.push_back(str.substr(i, 1));
-    }
+  usize i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+    __m256i in = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(x, bias));
+    x = _mm256_xor_si256(x, _mm256_and_si256(in, flip));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), x);
+  }
 
-    return result;
+  for (; i < n; i++)
+    dst[i] = flip_case(src[i], first);
+}
+
+MANIFOLD_TARGET("avx512f,avx512bw")
+auto convert_case_avx512(const char *src, char *dst, usize n, char first)
+    -> void {
+  const __m512i base = _mm512_set1_epi8(first);
+  const __m512i width = _mm512_set1_epi8(26);
+  const __m512i flip = _mm512_set1_epi8(0x20);
+
+  for (usize i = 0; i < n; i += 64) {
+    // the tail is handled by the same loop with masked loads and stores
+    __mmask64 live =
+        n - i >= 64 ? ~__mmask64{0} : (__mmask64{1} << (n - i)) - 1;
+    __m512i x = _mm512_maskz_loadu_epi8(live, src + i);
+    __mmask64 in = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(x, base), width);
+    x = _mm512_xor_si512(x, _mm512_maskz_mov_epi8(in, flip));
+    _mm512_mask_storeu_epi8(dst + i, live, x);
   }
+}
+#endif
 
-  std::vector<std::string> result;
-  auto start = 0;
-  auto end = str.find(delim);
-  while (end != std::string::npos) {
-    result.push_back(str.substr(start, end - start));
-    start = end + delim.size();
-    end = str.find(delim, start);
+#ifdef MANIFOLD_SIMD_NEON
+auto convert_case_neon(const char *src, char *dst, usize n, char first)
+    -> void {
+  const uint8x16_t base = vdupq_n_u8(static_cast<u8>(first));
+  const uint8x16_t width = vdupq_n_u8(26);
+  const uint8x16_t flip = vdupq_n_u8(0x20);
+
+  usize i = 0;
+  for (; i + 16 <= n; i += 16) {
+    uint8x16_t x = vld1q_u8(reinterpret_cast<const u8 *>(src + i));
+    uint8x16_t in = vcltq_u8(vsubq_u8(x, base), width);
+    x = veorq_u8(x, vandq_u8(in, flip));
+    vst1q_u8(reinterpret_cast<u8 *>(dst + i), x);
   }
 
-  result.push_back(str.substr(start, end));
+  for (; i < n; i++)
+    dst[i] = flip_case(src[i], first);
+}
+#endif
+
+auto convert_case(const char *src, char *dst, usize n, char first) -> void {
+  static const case_kernel kernel = [] {
+#if defined(MANIFOLD_SIMD_X86)
+    if (simd::features().avx512bw)
+      return convert_case_avx512;
+
+    return simd::features().avx2 ? convert_case_avx2 : convert_case_sse2;
+#elif defined(MANIFOLD_SIMD_NEON)
+    return convert_case_neon;
+#else
+    return convert_case_scalar;
+#endif
+  }();
+
+  kernel(src, dst, n, first);
+}
+
+} // namespace
+
+auto ends_with(std::string_view str, std::string_view suffix) -> bool {
+  return str.ends_with(suffix);
+}
+
+auto starts_with(std::string_view str, std::string_view prefix) -> bool {
+  return str.starts_with(prefix);
+}
+
+auto split(std::string_view str, std::string_view delim)
+    -> std::vector<std::string> {
+  std::vector<std::string> result;
+  for (auto piece : split_view(str, delim))
+    result.emplace_back(piece);
+
   return result;
 }
 
-auto replace_all(const std::string &str, const std::string &from,
-                 const std::string &to) -> std::string {
-  std::string result = str;
-  size_t start_pos = 0;
+auto replace_all(std::string_view str, std::string_view from,
+                 std::string_view to) -> std::string {
+  if (from.empty() || str.size() < from.size())
+    return std::string(str);
+
+  // count first so the result is allocated once, at its exact size
+  usize count = 0;
+  for (usize pos = manifold::str::find(str, from);
+       pos != std::string_view::npos;
+       pos = manifold::str::find(str, from, pos + from.size()))
+    count++;
+
+  if (count == 0)
+    return std::string(str);
 
-  while ((start_pos = result.find(from, start_pos)) != std::string::npos) {
-    result.replace(start_pos, from.length(), to);
-    start_pos += to.length();
+  std::string result(str.size() - count * from.size() + count * to.size(),
+                     '\0');
+  char *out = result.data();
+  usize start = 0;
+  for (usize pos = manifold::str::find(str, from);
+       pos != std::string_view::npos;
+       pos = manifold::str::find(str, from, start)) {
+    out = std::copy_n(str.data() + start, pos - start, out);
+    out = std::copy_n(to.data(), to.size(), out);
+    start = pos + from.size();
   }
 
+  std::copy_n(str.data() + start, str.size() - start, out);
   return result;
 }
 
-auto join(const std::vector<std::string> &strs, const std::string &delim)
+auto join(const std::vector<std::string> &strs, std::string_view delim)
     -> std::string {
+  if (strs.empty())
+    return {};
+
+  usize size = delim.size() * (strs.size() - 1);
+  for (const auto &str : strs)
+    size += str.size();
+
   std::string result;
+  result.reserve(size);
   for (size_t i = 0; i < strs.size(); i++) {
     result += strs[i];
     if (i != strs.size() - 1)
@@ -73,35 +247,72 @@ auto join(const std::vector<std::string> &strs, const std::string &delim)
   return result;
 }
 
-auto to_lower(const std::string &str) -> std::string {
-  std::string result = str;
-  std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+auto to_lower(std::string_view str) -> std::string {
+  std::string result(str.size(), '\0');
+  convert_case(str.data(), result.data(), str.size(), 'A');
   return result;
 }
 
-auto to_upper(const std::string &str) -> std::string {
-  std::string result = str;
-  std::transform(result.begin(), result.end(), result.begin(), ::toupper);
-  return result;
+auto to_lower(std::string &&str) -> std::string {
+  to_lower_in_place(str);
+  return std::move(str);
 }
 
-auto trim(const std::string &str) -> std::string {
-  std::string result = str;
-  result.erase(result.begin(),
-               std::find_if(result.begin(), result.end(),
-                            [](int ch) { return !std::isspace(ch); }));
-  result.erase(std::find_if(result.rbegin(), result.rend(),
-                            [](int ch) { return !std::isspace(ch); })
-                   .base(),
-               result.end());
+auto to_lower_in_place(std::span<char> str) -> void {
+  convert_case(str.data(), str.data(), str.size(), 'A');
+}
+
+auto to_lower(std::string_view str, std::span<char> out) -> usize {
+  usize n = std::min(str.size(), out.size());
+  convert_case(str.data(), out.data(), n, 'A');
+  return n;
+}
+
+auto to_upper(std::string_view str) -> std::string {
+  std::string result(str.size(), '\0');
+  convert_case(str.data(), result.data(), str.size(), 'a');
   return result;
 }
 
-auto as_cstr(const std::string &str) -> const i8 * {
-  auto *cstr = new i8[str.length() + 1];
-  std::strcpy(const_cast<char *>(cstr), str.c_str());
-  cstr[str.length()] = '\0';
+auto to_upper(std::string &&str) -> std::string {
+  to_upper_in_place(str);
+  return std::move(str);
+}
+
+auto to_upper_in_place(std::span<char> str) -> void {
+  convert_case(str.data(), str.data(), str.size(), 'a');
+}
+
+auto to_upper(std::string_view str, std::span<char> out) -> usize {
+  usize n = std::min(str.size(), out.size());
+  convert_case(str.data(), out.data(), n, 'a');
+  return n;
+}
+
+auto trim_view(std::string_view str) -> std::string_view {
+  auto begin = std::find_if_not(str.begin(), str.end(), is_space);
+  auto end = std::find_if_not(str.rbegin(), str.rend(), is_space).base();
+  if (begin >= end)
+    return {};
+
+  return str.substr(static_cast<usize>(begin - str.begin()),
+                    static_cast<usize>(end - begin));
+}
+
+auto trim(std::string_view str) -> std::string {
+  return std::string(trim_view(str));
+}
+
+auto trim(std::string &&str) -> std::string {
+  auto view = trim_view(str);
+  if (view.empty()) {
+    str.clear();
+    return std::move(str);
+  }
 
-  return cstr;
+  auto offset = static_cast<usize>(view.data() - str.data());
+  str.erase(offset + view.size());
+  str.erase(0, offset);
+  return std::move(str);
 }
 } // namespace manifold::str
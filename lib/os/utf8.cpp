@@ -0,0 +1,560 @@
+#include "../case_fold.hpp"
+#include "../simd.hpp"
+#include <manifold/os/str.hpp>
+#include <bit>
+
+namespace manifold::str {
+
+namespace {
+
+constexpr usize npos = std::string_view::npos;
+
+auto is_continuation(u8 byte) -> bool { return (byte & 0xc0) == 0x80; }
+
+/// Length of the valid sequence at `i`, or 0 if it is invalid (Unicode table
+/// 3-7: no overlong forms, surrogates or code points past U+10FFFF)
+auto sequence_length(const u8 *data, usize n, usize i) -> usize {
+  u8 lead = data[i];
+  if (lead < 0x80)
+    return 1;
+
+  u8 low = 0x80;
+  u8 high = 0xbf;
+  usize length;
+  if (lead < 0xc2) {
+    return 0;
+  } else if (lead < 0xe0) {
+    length = 2;
+  } else if (lead < 0xf0) {
+    length = 3;
+    if (lead == 0xe0)
+      low = 0xa0;
+    else if (lead == 0xed)
+      high = 0x9f;
+  } else if (lead < 0xf5) {
+    length = 4;
+    if (lead == 0xf0)
+      low = 0x90;
+    else if (lead == 0xf4)
+      high = 0x8f;
+  } else {
+    return 0;
+  }
+
+  if (n - i < length || data[i + 1] < low || data[i + 1] > high)
+    return 0;
+
+  for (usize k = 2; k < length; k++)
+    if (!is_continuation(data[i + k]))
+      return 0;
+
+  return length;
+}
+
+auto find_invalid_scalar(const u8 *data, usize n, usize i) -> usize {
+  while (i < n) {
+    // skip ASCII eight bytes at a time
+    while (i + 8 <= n) {
+      u64 word;
+      std::memcpy(&word, data + i, sizeof(word));
+      if ((word & 0x8080808080808080UL) != 0)
+        break;
+
+      i += 8;
+    }
+
+    if (i >= n)
+      break;
+
+    usize length = sequence_length(data, n, i);
+    if (length == 0)
+      return i;
+
+    i += length;
+  }
+
+  return npos;
+}
+
+#ifdef MANIFOLD_SIMD_X86
+// Lookup-table validation (Keiser & Lemire, "Validating UTF-8 in less than
+// one instruction per byte"): the high nibble of a byte, and both nibbles of
+// the byte before it, each index a table of error classes; a byte is in error
+// if a class is set in all three. Sequence lengths past two bytes are checked
+// separately against the bytes two and three back.
+constexpr u8 kTooShort = 1 << 0;
+constexpr u8 kTooLong = 1 << 1;
+constexpr u8 kOverlong3 = 1 << 2;
+constexpr u8 kTooLarge = 1 << 3;
+constexpr u8 kSurrogate = 1 << 4;
+constexpr u8 kOverlong2 = 1 << 5;
+constexpr u8 kTooLarge1000 = 1 << 6;
+constexpr u8 kOverlong4 = 1 << 6;
+constexpr u8 kTwoConts = 1 << 7;
+constexpr u8 kCarry = kTooShort | kTooLong | kTwoConts;
+
+alignas(16) constexpr u8 kPrevHigh[16] = {
+    kTooLong,  kTooLong,  kTooLong,  kTooLong,
+    kTooLong,  kTooLong,  kTooLong,  kTooLong,
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+};
+
+alignas(16) constexpr u8 kPrevLow[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+
+alignas(16) constexpr u8 kCurrentHigh[16] = {
+    kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooShort, kTooShort, kTooShort, kTooShort,
+};
+
+/// Bytes above these at the end of a block start a sequence that continues
+/// into the next one
+alignas(16) constexpr u8 kIncomplete[16] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf,
+};
+
+// The kernels return how far the input is known to be valid, up to the last
+// whole block; errors straddling that point are left to the scalar check.
+
+MANIFOLD_TARGET("sse4.2")
+auto validate_sse42(const u8 *data, usize n) -> usize {
+  const __m128i prev_high =
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kPrevHigh));
+  const __m128i prev_low =
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kPrevLow));
+  const __m128i current_high =
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kCurrentHigh));
+  const __m128i incomplete =
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kIncomplete));
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+
+  __m128i prev_input = _mm_setzero_si128();
+  __m128i prev_incomplete = _mm_setzero_si128();
+
+  usize i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i input =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    __m128i error;
+    if (_mm_movemask_epi8(input) == 0) {
+      // plain ASCII, only a sequence cut off by it can be wrong
+      error = prev_incomplete;
+      prev_incomplete = _mm_setzero_si128();
+    } else {
+      __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+      __m128i special = _mm_and_si128(
+          _mm_and_si128(
+              _mm_shuffle_epi8(prev_high,
+                               _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+              _mm_shuffle_epi8(prev_low, _mm_and_si128(prev1, nibble))),
+          _mm_shuffle_epi8(current_high,
+                           _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+      __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+      __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+      __m128i must_continue =
+          _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0xe0 - 0x80)),
+                       _mm_subs_epu8(prev3, _mm_set1_epi8(0xf0 - 0x80)));
+      error = _mm_xor_si128(
+          _mm_and_si128(must_continue,
+                        _mm_set1_epi8(static_cast<char>(0x80))),
+          special);
+      prev_incomplete = _mm_subs_epu8(input, incomplete);
+    }
+
+    if (!_mm_testz_si128(error, error))
+      return i;
+
+    prev_input = input;
+  }
+
+  return i;
+}
+
+MANIFOLD_TARGET("avx2")
+auto validate_avx2(const u8 *data, usize n) -> usize {
+  // the shuffles look up each 128-bit lane separately, so tables are doubled
+  const __m256i prev_high = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kPrevHigh)));
+  const __m256i prev_low = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kPrevLow)));
+  const __m256i current_high = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kCurrentHigh)));
+  const __m256i incomplete = _mm256_inserti128_si256(
+      _mm256_set1_epi8(static_cast<char>(0xff)),
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kIncomplete)), 1);
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+
+  __m256i prev_input = _mm256_setzero_si256();
+  __m256i prev_incomplete = _mm256_setzero_si256();
+
+  usize i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i input =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    __m256i error;
+    if (_mm256_movemask_epi8(input) == 0) {
+      error = prev_incomplete;
+      prev_incomplete = _mm256_setzero_si256();
+    } else {
+      // the previous bytes straddle the two 128-bit lanes
+      __m256i carried = _mm256_permute2x128_si256(prev_input, input, 0x21);
+      __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+      __m256i special = _mm256_and_si256(
+          _mm256_and_si256(
+              _mm256_shuffle_epi8(
+                  prev_high,
+                  _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+              _mm256_shuffle_epi8(prev_low, _mm256_and_si256(prev1, nibble))),
+          _mm256_shuffle_epi8(
+              current_high,
+              _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+      __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+      __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+      __m256i must_continue = _mm256_or_si256(
+          _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xe0 - 0x80)),
+          _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xf0 - 0x80)));
+      error = _mm256_xor_si256(
+          _mm256_and_si256(must_continue,
+                           _mm256_set1_epi8(static_cast<char>(0x80))),
+          special);
+      prev_incomplete = _mm256_subs_epu8(input, incomplete);
+    }
+
+    if (!_mm256_testz_si256(error, error))
+      return i;
+
+    prev_input = input;
+  }
+
+  return i;
+}
+#endif
+
+auto find_invalid_bytes(const u8 *data, usize n) -> usize {
+  using kernel_type = usize (*)(const u8 *, usize);
+  static const kernel_type kernel = []() -> kernel_type {
+#ifdef MANIFOLD_SIMD_X86
+    if (simd::features().avx2)
+      return validate_avx2;
+
+    if (simd::features().sse42)
+      return validate_sse42;
+#endif
+    return nullptr;
+  }();
+
+  usize valid = kernel == nullptr ? 0 : kernel(data, n);
+
+  // resume at the start of the sequence running into the unchecked part
+  usize resume = valid;
+  for (usize back = 1; back <= 3 && back <= valid; back++) {
+    if (!is_continuation(data[valid - back])) {
+      resume = valid - back;
+      break;
+    }
+  }
+
+  return find_invalid_scalar(data, n, resume);
+}
+
+/// Number of code points and of those that need four bytes (so a surrogate
+/// pair in UTF-16), for valid UTF-8
+struct Counts {
+  usize codepoints = 0;
+  usize supplementary = 0;
+};
+
+auto count(const u8 *data, usize n) -> Counts {
+  Counts counts;
+  usize i = 0;
+
+#if defined(MANIFOLD_SIMD_X86)
+  const __m128i continuation = _mm_set1_epi8(-64);
+  const __m128i four_byte = _mm_set1_epi8(-17);
+  for (; i + 16 <= n; i += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    // as signed bytes, continuations are below -64 and 4-byte leads are in
+    // [-16, -1]
+    auto tails =
+        static_cast<u32>(_mm_movemask_epi8(_mm_cmplt_epi8(x, continuation)));
+    auto leads = static_cast<u32>(
+        _mm_movemask_epi8(_mm_cmpgt_epi8(x, four_byte)) & _mm_movemask_epi8(x));
+    counts.codepoints += 16 - static_cast<usize>(std::popcount(tails));
+    counts.supplementary += static_cast<usize>(std::popcount(leads));
+  }
+#elif defined(MANIFOLD_SIMD_NEON)
+  for (; i + 16 <= n; i += 16) {
+    int8x16_t x = vreinterpretq_s8_u8(vld1q_u8(data + i));
+    uint8x16_t tails = vcltq_s8(x, vdupq_n_s8(-64));
+    uint8x16_t leads =
+        vandq_u8(vcgtq_s8(x, vdupq_n_s8(-17)), vcltq_s8(x, vdupq_n_s8(0)));
+    counts.codepoints += 16 - vaddvq_u8(vshrq_n_u8(tails, 7));
+    counts.supplementary += vaddvq_u8(vshrq_n_u8(leads, 7));
+  }
+#endif
+
+  for (; i < n; i++) {
+    counts.codepoints += is_continuation(data[i]) ? 0 : 1;
+    counts.supplementary += data[i] >= 0xf0 ? 1 : 0;
+  }
+
+  return counts;
+}
+
+/// Decodes the sequence at `i` (which has to be valid) into a code point
+auto decode(const u8 *data, usize &i) -> u32 {
+  u8 lead = data[i];
+  if (lead < 0x80) {
+    i += 1;
+    return lead;
+  }
+
+  if (lead < 0xe0) {
+    u32 cp = (u32{lead & 0x1fu} << 6) | (data[i + 1] & 0x3fu);
+    i += 2;
+    return cp;
+  }
+
+  if (lead < 0xf0) {
+    u32 cp = (u32{lead & 0x0fu} << 12) | (u32{data[i + 1] & 0x3fu} << 6) |
+             (data[i + 2] & 0x3fu);
+    i += 3;
+    return cp;
+  }
+
+  u32 cp = (u32{lead & 0x07u} << 18) | (u32{data[i + 1] & 0x3fu} << 12) |
+           (u32{data[i + 2] & 0x3fu} << 6) | (data[i + 3] & 0x3fu);
+  i += 4;
+  return cp;
+}
+
+/// Widens 16 bytes if they are all ASCII, returns false otherwise
+template <typename Char> auto widen_ascii(const u8 *in, Char *out) -> bool {
+#if defined(MANIFOLD_SIMD_X86)
+  __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  if (_mm_movemask_epi8(x) != 0)
+    return false;
+
+  const __m128i zero = _mm_setzero_si128();
+  __m128i low = _mm_unpacklo_epi8(x, zero);
+  __m128i high = _mm_unpackhi_epi8(x, zero);
+  auto *dst = reinterpret_cast<__m128i *>(out);
+  if constexpr (sizeof(Char) == 2) {
+    _mm_storeu_si128(dst, low);
+    _mm_storeu_si128(dst + 1, high);
+  } else {
+    _mm_storeu_si128(dst, _mm_unpacklo_epi16(low, zero));
+    _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(low, zero));
+    _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(high, zero));
+    _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(high, zero));
+  }
+
+  return true;
+#elif defined(MANIFOLD_SIMD_NEON)
+  uint8x16_t x = vld1q_u8(in);
+  if (vmaxvq_u8(x) >= 0x80)
+    return false;
+
+  uint16x8_t low = vmovl_u8(vget_low_u8(x));
+  uint16x8_t high = vmovl_u8(vget_high_u8(x));
+  if constexpr (sizeof(Char) == 2) {
+    vst1q_u16(reinterpret_cast<u16 *>(out), low);
+    vst1q_u16(reinterpret_cast<u16 *>(out) + 8, high);
+  } else {
+    auto *dst = reinterpret_cast<u32 *>(out);
+    vst1q_u32(dst, vmovl_u16(vget_low_u16(low)));
+    vst1q_u32(dst + 4, vmovl_u16(vget_high_u16(low)));
+    vst1q_u32(dst + 8, vmovl_u16(vget_low_u16(high)));
+    vst1q_u32(dst + 12, vmovl_u16(vget_high_u16(high)));
+  }
+
+  return true;
+#else
+  for (usize k = 0; k < 16; k++)
+    if (in[k] >= 0x80)
+      return false;
+
+  std::copy_n(in, 16, out);
+  return true;
+#endif
+}
+
+/// Transcodes valid UTF-8 into a buffer sized from `count`
+template <typename Char>
+auto transcode(const u8 *data, usize n, Char *out) -> void {
+  usize i = 0;
+  while (i < n) {
+    if (data[i] < 0x80) {
+      while (i + 16 <= n && widen_ascii(data + i, out)) {
+        i += 16;
+        out += 16;
+      }
+
+      if (i < n && data[i] < 0x80) {
+        *out++ = static_cast<Char>(data[i++]);
+        continue;
+      }
+
+      if (i >= n)
+        break;
+    }
+
+    u32 cp = decode(data, i);
+    if (sizeof(Char) == 2 && cp > 0xffff) {
+      cp -= 0x10000;
+      *out++ = static_cast<Char>(0xd800 + (cp >> 10));
+      *out++ = static_cast<Char>(0xdc00 + (cp & 0x3ff));
+    } else {
+      *out++ = static_cast<Char>(cp);
+    }
+  }
+}
+
+auto bytes(std::string_view str) -> const u8 * {
+  return reinterpret_cast<const u8 *>(str.data());
+}
+
+auto encode(u32 cp, std::string &out) -> void {
+  if (cp < 0x80) {
+    out.push_back(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    out.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+  } else if (cp < 0x10000) {
+    out.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+  } else {
+    out.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+  }
+}
+
+/// Appends the case folding of `cp` to `out`
+auto fold(u32 cp, std::string &out) -> void {
+  using internal::kFoldExpansions;
+  using internal::kFoldRanges;
+
+  auto expansion = std::lower_bound(
+      std::begin(kFoldExpansions), std::end(kFoldExpansions), cp,
+      [](const auto &entry, u32 key) { return entry.cp < key; });
+  if (expansion != std::end(kFoldExpansions) && expansion->cp == cp) {
+    for (u32 folded : expansion->folded)
+      if (folded != 0)
+        encode(folded, out);
+
+    return;
+  }
+
+  // the range starting last at or before `cp` is the only one that can hold it
+  auto range = std::upper_bound(
+      std::begin(kFoldRanges), std::end(kFoldRanges), cp,
+      [](u32 key, const auto &entry) { return key < entry.first; });
+  if (range != std::begin(kFoldRanges)) {
+    --range;
+    u32 offset = cp - range->first;
+    if (offset < u32{range->count} * range->stride &&
+        offset % range->stride == 0)
+      cp = static_cast<u32>(static_cast<i64>(cp) + range->delta);
+  }
+
+  encode(cp, out);
+}
+
+} // namespace
+
+auto fold_case(std::string_view str) -> std::string {
+  const u8 *data = bytes(str);
+  const usize n = str.size();
+
+  std::string result;
+  result.reserve(n);
+  for (usize i = 0; i < n;) {
+    u8 byte = data[i];
+    if (byte < 0x80) {
+      result.push_back(static_cast<char>(
+          static_cast<u8>(byte - 'A') < 26 ? byte | 0x20 : byte));
+      i++;
+      continue;
+    }
+
+    if (sequence_length(data, n, i) == 0) {
+      result.push_back(static_cast<char>(byte));
+      i++;
+      continue;
+    }
+
+    fold(decode(data, i), result);
+  }
+
+  return result;
+}
+
+namespace utf8 {
+
+auto validate(std::string_view str) -> bool {
+  return find_invalid(str) == npos;
+}
+
+auto find_invalid(std::string_view str) -> usize {
+  return find_invalid_bytes(bytes(str), str.size());
+}
+
+auto count_codepoints(std::string_view str) -> usize {
+  return count(bytes(str), str.size()).codepoints;
+}
+
+auto to_utf16(std::string_view str)
+    -> manifold::result<std::u16string, Error> {
+  if (usize offset = find_invalid(str); offset != npos)
+    return manifold::fail(Error{offset});
+
+  auto counts = count(bytes(str), str.size());
+  std::u16string result(counts.codepoints + counts.supplementary, u'\0');
+  transcode(bytes(str), str.size(), result.data());
+  return result;
+}
+
+auto to_utf32(std::string_view str)
+    -> manifold::result<std::u32string, Error> {
+  if (usize offset = find_invalid(str); offset != npos)
+    return manifold::fail(Error{offset});
+
+  std::u32string result(count(bytes(str), str.size()).codepoints, U'\0');
+  transcode(bytes(str), str.size(), result.data());
+  return result;
+}
+
+} // namespace utf8
+
+} // namespace manifold::str
@@ -0,0 +1,41 @@
+#ifndef Manifold_Parallel_hpp
+#define Manifold_Parallel_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <manifold/os/env.hpp>
+#include <thread>
+#include <vector>
+
+namespace manifold::internal {
+
+/// Calls `fn(i)` for every `i < count` on up to `threads` threads (0 means
+/// `env::processor_count()`), indices are handed out in increasing order
+template <typename F>
+auto parallel_for(usize count, usize threads, F &&fn) -> void {
+  if (count == 0)
+    return;
+
+  if (threads == 0)
+    threads = manifold::env::processor_count();
+  threads = std::clamp<usize>(threads, 1, count);
+
+  std::atomic<usize> next = 0;
+  auto worker = [&]() {
+    for (usize i = next++; i < count; i = next++)
+      fn(i);
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (usize i = 1; i < threads; i++)
+    pool.emplace_back(worker);
+
+  worker();
+  for (auto &thread : pool)
+    thread.join();
+}
+
+} // namespace manifold::internal
+
+#endif
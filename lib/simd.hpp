@@ -0,0 +1,51 @@
+#ifndef Manifold_Simd_hpp
+#define Manifold_Simd_hpp
+
+#include <manifold/_defines.hpp>
+
+// Kernels are compiled per instruction set with target attributes and picked
+// once at runtime, so the library itself still builds for the baseline ISA.
+#if (defined(__x86_64__) || defined(_M_X64)) &&                                \
+    (defined(MANIFOLD_COMPILER_GCC) || defined(MANIFOLD_COMPILER_CLANG))
+#define MANIFOLD_SIMD_X86
+#include <immintrin.h>
+#define MANIFOLD_TARGET(features) __attribute__((target(features)))
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define MANIFOLD_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace manifold::simd {
+
+/// Instruction set extensions available at runtime
+struct Features {
+  bool ssse3 = false;
+  bool sse42 = false;
+  bool pclmul = false;
+  bool avx2 = false;
+  bool avx512bw = false;
+};
+
+inline auto features() -> const Features & {
+  static const Features detected = [] {
+    Features f;
+#ifdef MANIFOLD_SIMD_X86
+    __builtin_cpu_init();
+    f.ssse3 = __builtin_cpu_supports("ssse3");
+    f.sse42 = __builtin_cpu_supports("sse4.2");
+    f.pclmul = __builtin_cpu_supports("pclmul");
+    f.avx2 = __builtin_cpu_supports("avx2");
+    f.avx512bw = __builtin_cpu_supports("avx512f") &&
+                 __builtin_cpu_supports("avx512bw");
+#endif
+    return f;
+  }();
+
+  return detected;
+}
+
+} // namespace manifold::simd
+
+#endif
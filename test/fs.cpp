@@ -1,7 +1,10 @@
+#include <cstring>
 #include <ctime>
 #include <gtest/gtest.h>
 #include <manifold/os/env.hpp>
 #include <manifold/os/fs.hpp>
+#include <manifold/os/pattern.hpp>
+#include <memory>
 #include <random>
 #include <string>
 
@@ -115,3 +118,214 @@ TEST_F(FilesystemTest, SearchFiles) {
   EXPECT_FALSE(nonTestFileRes.has_error());
   EXPECT_EQ(nonTestFileRes.value().filename().string(), "not_a.tes");
 }
+
+/// PathTable
+TEST_F(FilesystemTest, PathTable) {
+  manifold::fs::PathTable table;
+  EXPECT_TRUE(table.empty());
+
+  auto a = table.insert("/usr/lib/libfoo.so");
+  auto b = table.insert("/usr/include/foo.h");
+  auto c = table.insert("/usr/lib/libbar.so");
+  auto d = table.insert("relative/dir/");
+
+  // re-inserting returns the existing entry
+  EXPECT_EQ(table.insert("/usr/lib/libfoo.so"), a);
+  EXPECT_EQ(table.size(), 4);
+
+  EXPECT_TRUE(table.contains("/usr/include/foo.h"));
+  EXPECT_FALSE(table.contains("/usr/lib")); // only implicitly stored
+  EXPECT_FALSE(table.contains("/usr/lib/libbaz.so"));
+  EXPECT_TRUE(table.find("/usr/lib/libbaz.so").has_error());
+  EXPECT_EQ(table.find("/usr/lib/libbar.so").value(), c);
+
+  EXPECT_EQ(table.path(b), manifold::fs::path_type("/usr/include/foo.h"));
+  EXPECT_EQ(table.path(d), manifold::fs::path_type("relative/dir/"));
+  EXPECT_EQ(table.name(a), "libfoo.so");
+  EXPECT_EQ(table.name(table.parent(a)), "lib");
+
+  // iteration is in insertion order; paths come back by value, so the
+  // iterator is only a forward iterator in the C++20 sense
+  using iterator = manifold::fs::PathTable::iterator;
+  static_assert(std::forward_iterator<iterator>);
+  static_assert(
+      std::is_same_v<std::iterator_traits<iterator>::iterator_category,
+                     std::input_iterator_tag>);
+  std::vector<manifold::fs::path_type> paths(table.begin(), table.end());
+  EXPECT_EQ(paths, std::vector<manifold::fs::path_type>(
+                       {"/usr/lib/libfoo.so", "/usr/include/foo.h",
+                        "/usr/lib/libbar.so", "relative/dir/"}));
+
+  EXPECT_EQ(table.sorted(), std::vector<manifold::fs::PathTable::id_type>(
+                                {b, c, a, d}));
+
+  // many similar names share prefixes (and blocks of front-coded names)
+  manifold::fs::PathTable big;
+  usize naive = 0;
+  for (u32 i = 0; i < 5000; i++) {
+    manifold::fs::path_type p = "/data/shard" + std::to_string(i % 8) +
+                                "/record_" + std::to_string(i) + ".bin";
+    naive += sizeof(manifold::fs::path_type) + p.native().capacity() + 1;
+    big.insert(p);
+  }
+
+  EXPECT_EQ(big.size(), 5000);
+  EXPECT_EQ(big.path(big.find("/data/shard3/record_1235.bin").value()),
+            manifold::fs::path_type("/data/shard3/record_1235.bin"));
+  big.shrink_to_fit();
+  EXPECT_LT(big.memory_usage(), naive);
+
+  table.clear();
+  EXPECT_TRUE(table.empty());
+  EXPECT_FALSE(table.contains("/usr/include/foo.h"));
+}
+
+/// search_all()
+TEST_F(FilesystemTest, SearchAllFiles) {
+  auto file = ScopedFile(testDir / "first.test");
+  auto file2 = ScopedFile(testDir / "second.test");
+  auto file3 = ScopedFile(testDir / "not_a.tes");
+
+  auto res = manifold::fs::search_all(
+      testDir, [](const manifold::fs::path_type &path) -> bool {
+        return path.extension() == ".test";
+      });
+  EXPECT_FALSE(res.has_error());
+  EXPECT_EQ(res.value().size(), 2);
+  EXPECT_TRUE(res.value().contains(file.path));
+  EXPECT_TRUE(res.value().contains(file2.path));
+  EXPECT_FALSE(res.value().contains(file3.path));
+
+  auto pattern = manifold::str::Pattern::compile(R"(/(first|not_a)\.tes)");
+  ASSERT_FALSE(pattern.has_error());
+  auto matched = manifold::fs::search_all(testDir, pattern.value());
+  EXPECT_FALSE(matched.has_error());
+  EXPECT_EQ(matched.value().size(), 2);
+  EXPECT_TRUE(matched.value().contains(file.path));
+  EXPECT_TRUE(matched.value().contains(file3.path));
+}
+
+/// MappedWriter
+TEST_F(FilesystemTest, MappedWriter) {
+  auto path = testDir / "mapped.bin";
+
+  std::vector<u8> expected;
+  {
+    auto res = manifold::fs::MappedWriter::create(path, 4096);
+    ASSERT_FALSE(res.has_error());
+    auto writer = std::move(res.value());
+
+    // enough to force the file to grow a few times
+    for (u32 i = 0; i < 3000; i++) {
+      auto line = "line " + std::to_string(i) + "\n";
+      EXPECT_FALSE(writer.write(line).has_error());
+      expected.insert(expected.end(), line.begin(), line.end());
+    }
+
+    auto region = writer.reserve(4);
+    ASSERT_FALSE(region.has_error());
+    std::memcpy(region.value().data(), "\xAA\xBB\xCC\xDD", 4);
+    writer.commit(4);
+    expected.insert(expected.end(), {0xAA, 0xBB, 0xCC, 0xDD});
+
+    EXPECT_EQ(writer.size(), expected.size());
+    EXPECT_GE(writer.capacity(), writer.size());
+    EXPECT_FALSE(writer.flush().has_error());
+    EXPECT_FALSE(writer.close().has_error());
+  }
+
+  // truncated to exactly what was written
+  EXPECT_EQ(std::filesystem::file_size(path), expected.size());
+  EXPECT_EQ(manifold::fs::read_file_bytes(path).value(), expected);
+
+  // closing on destruction works as well
+  {
+    auto writer = manifold::fs::MappedWriter::create(path).value();
+    EXPECT_FALSE(writer.write("short").has_error());
+  }
+  EXPECT_EQ(manifold::fs::read_file(path).value(), "short");
+
+  EXPECT_TRUE(
+      manifold::fs::MappedWriter::create(testDir / "missing" / "file.bin")
+          .has_error());
+}
+
+/// read_files()
+TEST_F(FilesystemTest, ReadManyFiles) {
+  std::vector<manifold::fs::path_type> paths;
+  std::vector<std::unique_ptr<ScopedFile>> files;
+  for (u32 i = 0; i < 16; i++) {
+    auto path = testDir / ("many" + std::to_string(i));
+    files.push_back(
+        std::make_unique<ScopedFile>(path, std::string(i * 100, 'a' + i)));
+    paths.push_back(path);
+  }
+  paths.push_back(testDir / "missing");
+
+  auto results = manifold::fs::read_files(paths, 4);
+  ASSERT_EQ(results.size(), paths.size());
+
+  // results stay in request order, whatever order they were read in
+  for (u32 i = 0; i < 16; i++) {
+    ASSERT_FALSE(results[i].has_error());
+    EXPECT_EQ(results[i].value(), std::vector<u8>(i * 100, 'a' + i));
+    // read into a buffer of the file's size, never grown past it
+    EXPECT_EQ(results[i].value().capacity(), i * 100);
+  }
+
+  EXPECT_TRUE(results[16].has_error());
+  EXPECT_EQ(results[16].error(), manifold::fs::Error::NoFileExists);
+
+#ifdef MANIFOLD_PLATFORM_LINUX
+  // procfs reports a size of 0 but has contents
+  std::vector<manifold::fs::path_type> proc = {"/proc/self/status"};
+  auto status = manifold::fs::read_files(proc);
+  ASSERT_FALSE(status[0].has_error());
+  EXPECT_FALSE(status[0].value().empty());
+#endif
+
+  EXPECT_TRUE(manifold::fs::read_files({}).empty());
+}
+
+/// MappedFile, hash_file()
+TEST_F(FilesystemTest, MappedFileHash) {
+  // a few chunks, so both flat and tree modes go parallel
+  std::string contents(3 * manifold::fs::kHashChunk + 12345, '\0');
+  for (usize i = 0; i < contents.size(); i++)
+    contents[i] = static_cast<char>(i * 31 % 251);
+  auto file = ScopedFile(testDir / "large.bin", contents);
+
+  auto mapped = manifold::fs::MappedFile::open(file.path);
+  ASSERT_FALSE(mapped.has_error());
+  EXPECT_EQ(mapped.value().size(), contents.size());
+  EXPECT_EQ(mapped.value().view(), contents);
+
+  using manifold::hash::Algorithm;
+  using manifold::fs::HashMode;
+
+  auto crc = manifold::fs::hash_file(file.path, Algorithm::Crc32c);
+  EXPECT_EQ(crc.value(), manifold::hash::crc32c(contents));
+
+  auto flat = manifold::fs::hash_file(file.path, Algorithm::XXH3);
+  EXPECT_EQ(flat.value(), manifold::hash::xxh3(contents));
+
+  // tree digests hash the chunk digests
+  std::string leaves;
+  for (usize i = 0; i < contents.size(); i += manifold::fs::kHashChunk) {
+    u64 digest = manifold::hash::xxh64(
+        std::string_view(contents).substr(i, manifold::fs::kHashChunk));
+    for (usize b = 0; b < sizeof(u64); b++)
+      leaves += static_cast<char>(digest >> (8 * b));
+  }
+
+  auto tree = manifold::fs::hash_file(file.path, Algorithm::XXH64,
+                                      HashMode::Tree);
+  EXPECT_EQ(tree.value(), manifold::hash::xxh64(leaves));
+
+  auto empty = ScopedFile(testDir / "empty.bin");
+  EXPECT_EQ(manifold::fs::hash_file(empty.path, Algorithm::XXH3).value(),
+            manifold::hash::xxh3(""));
+
+  EXPECT_TRUE(
+      manifold::fs::hash_file(testDir / "missing", Algorithm::XXH3).has_error());
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <manifold/hash.hpp>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace manifold::hash;
+
+class HashTest : public testing::Test {
+protected:
+  HashTest() : bytes(1024) {
+    // 0..255 repeated, long enough for the striped (long input) paths
+    std::iota(bytes.begin(), bytes.begin() + 256, 0);
+    for (usize i = 256; i < bytes.size(); i++)
+      bytes[i] = bytes[i - 256];
+  }
+
+  std::vector<u8> bytes;
+};
+
+TEST_F(HashTest, Crc32c) {
+  EXPECT_EQ(crc32c(""), 0U);
+  EXPECT_EQ(crc32c("123456789"), 0xE3069283U);
+
+  // checksums continue from a previous one and combine
+  std::string text(100000, 'x');
+  for (usize i = 0; i < text.size(); i++)
+    text[i] = static_cast<char>('a' + i * 7 % 26);
+
+  u32 whole = crc32c(text);
+  u32 first = crc32c(std::string_view(text).substr(0, 12345));
+  u32 second = crc32c(std::string_view(text).substr(12345));
+  EXPECT_EQ(crc32c(std::string_view(text).substr(12345), first), whole);
+  EXPECT_EQ(crc32c_combine(first, second, text.size() - 12345), whole);
+
+  Crc32c stream;
+  stream.update(std::string_view(text).substr(0, 3));
+  stream.update(std::string_view(text).substr(3));
+  EXPECT_EQ(stream.digest(), whole);
+}
+
+TEST_F(HashTest, XXH64) {
+  EXPECT_EQ(xxh64(""), 0xef46db3751d8e999UL);
+  EXPECT_EQ(xxh64("abc"), 0x44bc2cf5ad770999UL);
+  EXPECT_EQ(xxh64("hello manifold", 42), 0x7b52ff1f81d61d14UL);
+  EXPECT_EQ(xxh64(bytes), 0x6f3914f18fe4df57UL);
+
+  Xxh64 stream(42);
+  for (usize i = 0; i < bytes.size(); i += 100)
+    stream.update(std::span(bytes).subspan(i, std::min<usize>(100, 1024 - i)));
+  EXPECT_EQ(stream.digest(), 0x4cb9b11211d5b1a0UL);
+
+  stream.reset();
+  stream.update("abc");
+  EXPECT_EQ(stream.digest(), 0x44bc2cf5ad770999UL);
+}
+
+TEST_F(HashTest, XXH3) {
+  EXPECT_EQ(xxh3(""), 0x2d06800538d394c2UL);
+  EXPECT_EQ(xxh3("abc"), 0x78af5f94892f3950UL);
+  EXPECT_EQ(xxh3("hello manifold", 42), 0x279f5e56bc1444e2UL);
+  EXPECT_EQ(xxh3(bytes), 0xa870f92984398d22UL);
+  EXPECT_EQ(xxh3(bytes, 42), 0x2976c34b83200df6UL);
+
+  Xxh3 stream(42);
+  for (usize i = 0; i < bytes.size(); i += 100)
+    stream.update(std::span(bytes).subspan(i, std::min<usize>(100, 1024 - i)));
+  EXPECT_EQ(stream.digest(), 0x2976c34b83200df6UL);
+
+  stream.reset();
+  stream.update("abc");
+  EXPECT_EQ(stream.digest(), 0x78af5f94892f3950UL);
+}
+
+TEST_F(HashTest, WyHash) {
+  EXPECT_EQ(wyhash("manifold"), wyhash("manifold"));
+  EXPECT_NE(wyhash("manifold"), wyhash("manifolds"));
+  EXPECT_NE(wyhash("manifold"), wyhash("manifold", 1));
+
+  // every length bucket (0, 1-3, 4-16, 17-47, 48+) reads the whole input
+  for (usize n : {1, 3, 4, 16, 17, 47, 48, 200}) {
+    auto changed = bytes;
+    changed[n - 1] ^= 1;
+    EXPECT_NE(wyhash(std::span(bytes).first(n)),
+              wyhash(std::span(changed).first(n)));
+  }
+}
+
+TEST_F(HashTest, SipHash) {
+  // CPython hashes bytes with SipHash-1-3 and a zero key (PYTHONHASHSEED=0)
+  EXPECT_EQ(siphash13("abc", 0, 0), 0xc03bc3a0042630f2UL);
+  EXPECT_EQ(siphash13("manifold", 0, 0), 0x124d713bc58a56fbUL);
+  EXPECT_EQ(siphash13("0123456789abcdef", 0, 0), 0x1d42b30f7e060c24UL);
+  EXPECT_NE(siphash13("abc", 0, 0), siphash13("abc", 0, 1));
+  EXPECT_NE(siphash13("abc", 0, 0), siphash13("abc", 1, 0));
+
+  for (usize n : {1, 7, 8, 9, 200}) {
+    auto changed = bytes;
+    changed[n - 1] ^= 1;
+    EXPECT_NE(siphash13(std::span(bytes).first(n), 1, 2),
+              siphash13(std::span(changed).first(n), 1, 2));
+  }
+}
+
+TEST_F(HashTest, Dispatch) {
+  EXPECT_EQ(hash(Algorithm::Crc32c, bytes), crc32c(bytes));
+  EXPECT_EQ(hash(Algorithm::XXH64, bytes, 7), xxh64(bytes, 7));
+  EXPECT_EQ(hash(Algorithm::XXH3, bytes, 7), xxh3(bytes, 7));
+}
@@ -1,6 +1,19 @@
 #include <gtest/gtest.h>
+#include <manifold/os/csv.hpp>
+#include <manifold/os/encoding.hpp>
+#include <manifold/os/format.hpp>
+#include <manifold/os/parallel_text.hpp>
+#include <manifold/os/pattern.hpp>
 #include <manifold/os/str.hpp>
+#include <atomic>
+#include <filesystem>
+#include <limits>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
 
 TEST(StringTest, SuffixPrefixCheck) {
   std::string s = "hello manifold";
@@ -36,6 +49,653 @@ TEST(StringTest, SplitReplaceJoin) {
   EXPECT_EQ(join2, "");
 }
 
+TEST(StringTest, Find) {
+  using manifold::str::find;
+  constexpr auto npos = std::string_view::npos;
+
+  EXPECT_EQ(find("hello", ""), 0);
+  EXPECT_EQ(find("hello", "", 5), 5);
+  EXPECT_EQ(find("hello", "", 6), npos);
+  EXPECT_EQ(find("hello", "lo"), 3);
+  EXPECT_EQ(find("hello", "hello!"), npos);
+  EXPECT_EQ(find("", "x"), npos);
+
+  // matches at every offset of a long haystack, against std::string_view
+  std::string haystack;
+  for (int i = 0; i < 2000; i++)
+    haystack += static_cast<char>("abcxyz"[(i * 7 + i / 13) % 6]);
+
+  for (auto needle : {"a", "zz", "xyz", "cxyzab", "abcabcabc", "zaxbyc"}) {
+    auto view = std::string_view(haystack);
+    for (size_t pos = 0; pos <= haystack.size(); pos += 37)
+      EXPECT_EQ(find(view, needle, pos), view.find(needle, pos)) << needle;
+
+    manifold::str::Searcher searcher(needle);
+    for (size_t pos = 0; pos <= haystack.size(); pos += 37)
+      EXPECT_EQ(searcher.find(view, pos), view.find(needle, pos)) << needle;
+  }
+
+  std::string log;
+  for (int i = 0; i < 1000; i++)
+    log += i % 10 == 0 ? "ERROR: disk full\n" : "INFO: all good\n";
+
+  manifold::str::Searcher errors("ERROR: disk");
+  EXPECT_EQ(errors.needle(), "ERROR: disk");
+  EXPECT_EQ(errors.count(log), 100);
+  EXPECT_EQ(errors.find(log, 1), 17 + 9 * 15);
+  EXPECT_EQ(manifold::str::Searcher("").count(log), 0);
+}
+
+TEST(StringTest, SplitView) {
+  auto pieces = [](std::string_view str, std::string_view delim) {
+    std::vector<std::string> result;
+    for (auto piece : manifold::str::split_view(str, delim))
+      result.emplace_back(piece);
+
+    return result;
+  };
+
+  using list = std::vector<std::string>;
+  EXPECT_EQ(pieces("", ";"), list{});
+  EXPECT_EQ(pieces("abc", ""), (list{"a", "b", "c"}));
+  EXPECT_EQ(pieces(";a;;b;", ";"), (list{"", "a", "", "b", ""}));
+  EXPECT_EQ(pieces("a::b::::c", "::"), (list{"a", "b", "", "c"}));
+  EXPECT_EQ(pieces("no delimiter", "--"), list{"no delimiter"});
+
+  // long enough to go through the vectorized search, with near misses
+  std::string line;
+  list expected;
+  for (int i = 0; i < 200; i++) {
+    auto field = std::string(static_cast<size_t>(i % 37), 'x') + "<" +
+                 std::to_string(i) + ">";
+    expected.push_back(field);
+    line += field;
+    if (i != 199)
+      line += "<=>";
+  }
+
+  EXPECT_EQ(pieces(line, "<=>"), expected);
+  EXPECT_EQ(manifold::str::split(line, "<=>"), expected);
+}
+
+TEST(StringTest, Tokenizer) {
+  using manifold::str::CharSet;
+  using manifold::str::Tokenizer;
+  using manifold::str::TokenizerOptions;
+  namespace chars = manifold::str::chars;
+  using list = std::vector<std::string_view>;
+
+  static_assert(chars::digits.contains('7') && !chars::digits.contains('a'));
+  static_assert(CharSet("\xff").contains('\xff'));
+  static_assert((~chars::alnum).contains('-'));
+  static_assert(Tokenizer<chars::whitespace, ",;|">::is_delimiter('|'));
+  static_assert(!Tokenizer<chars::whitespace, ",;|">::is_delimiter('a'));
+
+  // empty tokens are kept by default, like split_view
+  Tokenizer<chars::whitespace, ",;|"> fields;
+  EXPECT_EQ(fields.split(""), list{});
+  EXPECT_EQ(fields.split("a,b c;|d,"), (list{"a", "b", "c", "", "d", ""}));
+  EXPECT_EQ(fields.split(",a"), (list{"", "a"}));
+
+  Tokenizer<chars::whitespace> words(TokenizerOptions{.merge_runs = true});
+  EXPECT_EQ(words.split("  hello \t\n world  "), (list{"hello", "world"}));
+  EXPECT_EQ(words.split(" \t "), list{});
+
+  Tokenizer<chars::punct, chars::whitespace> lexer(
+      TokenizerOptions{.keep_delimiters = true, .merge_runs = true});
+  EXPECT_EQ(lexer.split("x = f(a, b);"),
+            (list{"x", " = ", "f", "(", "a", ", ", "b", ");"}));
+
+  Tokenizer<chars::punct> symbols(TokenizerOptions{.keep_delimiters = true});
+  EXPECT_EQ(symbols.split("a+=b"), (list{"a", "+", "=", "b"}));
+
+  // delimiters inside quotes are text, an unterminated quote runs to the end,
+  // and only a token that is one whole quoted section loses its quotes
+  Tokenizer<","> csv(TokenizerOptions{.quotes = "\"'", .strip_quotes = true});
+  EXPECT_EQ(csv.split(R"(a,"b,c",'d,"e',"f""g",x"y,z)"),
+            (list{"a", "b,c", "d,\"e", "\"f\"\"g\"", "x\"y,z"}));
+  EXPECT_EQ(csv.split(R"("open,ended)"), list{"\"open,ended"});
+
+  std::vector<std::string> tokens;
+  for (auto token : Tokenizer<"|">().tokenize("one|two"))
+    tokens.emplace_back(token);
+
+  EXPECT_EQ(tokens, (std::vector<std::string>{"one", "two"}));
+}
+
+TEST(StringTest, CsvReader) {
+  namespace csv = manifold::str::csv;
+  using list = std::vector<std::string>;
+
+  auto records = [](csv::Reader &reader) {
+    std::vector<list> result;
+    while (reader.next())
+      result.emplace_back(reader.fields().begin(), reader.fields().end());
+
+    return result;
+  };
+
+  std::string_view data = "id,name,note\r\n"
+                          "1,plain,\r\n"
+                          "2,\"quoted, with comma\",\"say \"\"hi\"\"\"\r\n"
+                          "3,\"multi\nline\",\"\"\n"
+                          "\n"
+                          "4,last,no newline";
+  std::vector<list> expected = {{"id", "name", "note"},
+                                {"1", "plain", ""},
+                                {"2", "quoted, with comma", "say \"hi\""},
+                                {"3", "multi\nline", ""},
+                                {""},
+                                {"4", "last", "no newline"}};
+
+  csv::Reader reader(data);
+  EXPECT_EQ(records(reader), expected);
+  EXPECT_EQ(reader.records(), expected.size());
+  EXPECT_FALSE(reader.next());
+
+  // unescaped fields view the input itself
+  csv::Reader views(data);
+  views.next();
+  EXPECT_EQ(views[1].data(), data.data() + 3);
+
+  // every chunk boundary, including ones inside quotes and "\r\n"
+  for (size_t chunk = 1; chunk <= data.size(); chunk++) {
+    size_t at = 0;
+    csv::Reader chunked(
+        [&](std::span<char> out) {
+          size_t size = std::min({out.size(), data.size() - at, chunk});
+          std::memcpy(out.data(), data.data() + at, size);
+          at += size;
+          return size;
+        },
+        csv::Options{.chunk_size = chunk});
+    EXPECT_EQ(records(chunked), expected);
+  }
+
+  // long enough that fields and quoted regions span 64-byte blocks
+  std::string wide;
+  list row;
+  for (int i = 0; i < 100; i++) {
+    std::string field(static_cast<size_t>(i % 7) * 5, 'x');
+    field += i % 3 == 0 ? ",\n" : ";";
+    row.push_back(field);
+    wide += "\"" + field + "\"";
+    wide += i + 1 < 100 ? "," : "\n";
+  }
+
+  csv::Reader blocks(wide);
+  EXPECT_EQ(records(blocks), std::vector<list>{row});
+
+  csv::Reader tabs("a\t\"b\tc\r\n", csv::tsv);
+  EXPECT_EQ(records(tabs), (std::vector<list>{{"a", "\"b", "c"}}));
+
+  csv::Reader empty("");
+  EXPECT_FALSE(empty.next());
+}
+
+TEST(StringTest, ReplaceAll) {
+  EXPECT_EQ(manifold::str::replace_all("aaa", "a", "bb"), "bbbbbb");
+  EXPECT_EQ(manifold::str::replace_all("aaaa", "aa", "b"), "bb");
+  EXPECT_EQ(manifold::str::replace_all("abcabc", "abc", ""), "");
+  EXPECT_EQ(manifold::str::replace_all("text", "", "x"), "text");
+  EXPECT_EQ(manifold::str::replace_all("text", "longer", "x"), "text");
+
+  std::string text, expected;
+  for (int i = 0; i < 500; i++) {
+    text += "{{name}} is " + std::to_string(i) + "; ";
+    expected += "manifold is " + std::to_string(i) + "; ";
+  }
+
+  EXPECT_EQ(manifold::str::replace_all(text, "{{name}}", "manifold"),
+            expected);
+}
+
+TEST(StringTest, Replacer) {
+  manifold::str::Replacer empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.replace("unchanged"), "unchanged");
+
+  manifold::str::Replacer replacer({
+      {"he", "HE"},
+      {"she", "SHE"},
+      {"his", "HIS"},
+      {"hers", "HERS"},
+      {"", "ignored"},
+      {"he", "duplicate"},
+  });
+  EXPECT_EQ(replacer.size(), 4);
+
+  // leftmost wins over longest, longest wins at the same start
+  EXPECT_EQ(replacer.replace("ushers"), "uSHErs");
+  EXPECT_EQ(replacer.replace("hershe"), "HERSHE");
+  EXPECT_EQ(replacer.replace("this is his"), "tHIS is HIS");
+  EXPECT_EQ(replacer.replace("no match"), "no match");
+  EXPECT_EQ(replacer.replace(""), "");
+
+  // a later, shorter rule must not be lost behind a longer candidate
+  manifold::str::Replacer overlap({{"abcd", "1"}, {"bc", "2"}, {"e", "3"}});
+  EXPECT_EQ(overlap.replace("abcde abce"), "13 a23");
+
+  manifold::str::Replacer prefix({{"c", "1"}, {"ccbc", "2"}});
+  EXPECT_EQ(prefix.replace("acc"), "a11");
+
+  // same result as applying rules one at a time when they can't interact
+  auto wrap = [](char open, int i, std::string_view close) {
+    std::string result(1, open);
+    result += std::to_string(i);
+    result += close;
+    return result;
+  };
+
+  std::vector<std::pair<std::string, std::string>> pairs;
+  for (int i = 0; i < 1000; i++)
+    pairs.emplace_back(wrap('<', i, ">"), wrap('#', i, ""));
+
+  std::vector<manifold::str::Replacer::Rule> rules;
+  for (const auto &[from, to] : pairs)
+    rules.push_back({from, to});
+
+  manifold::str::Replacer many{std::span(rules)};
+  std::string text, expected;
+  for (int i = 0; i < 3000; i += 7) {
+    text += 'x';
+    text += wrap('<', i, ">");
+    expected += 'x';
+    expected += i < 1000 ? wrap('#', i, "") : wrap('<', i, ">");
+  }
+
+  std::string out = "stale contents";
+  many.replace(text, out);
+  EXPECT_EQ(out, expected);
+}
+
+TEST(StringTest, PrefixSet) {
+  manifold::str::PrefixSet empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_FALSE(empty.longest("anything"));
+
+  manifold::str::PrefixSet routes{"/api",     "/api/v1/users", "/api/v1",
+                                  "/static/", "/api/v2",       "/api"};
+  EXPECT_EQ(routes.size(), 6);
+
+  auto match = routes.longest("/api/v1/users/42");
+  ASSERT_TRUE(match);
+  EXPECT_EQ(match->id, 1);
+  EXPECT_EQ(match->length, 13);
+
+  // the longest pattern that matches in full, not the deepest node reached
+  EXPECT_EQ(routes.longest("/api/v1/use")->id, 2);
+  EXPECT_EQ(routes.longest("/api/v3")->id, 0);
+  EXPECT_EQ(routes.longest("/api")->length, 4);
+  EXPECT_EQ(routes.longest("/static/app.js")->id, 3);
+  EXPECT_FALSE(routes.longest("/static"));
+  EXPECT_FALSE(routes.longest("/ap"));
+  EXPECT_FALSE(routes.matches(""));
+  EXPECT_TRUE(routes.matches("/api2"));
+
+  manifold::str::PrefixSet fallback{"", "a", "abc"};
+  EXPECT_EQ(fallback.longest("xyz")->id, 0);
+  EXPECT_EQ(fallback.longest("")->length, 0);
+  EXPECT_EQ(fallback.longest("ab")->id, 1);
+  EXPECT_EQ(fallback.longest("abcd")->id, 2);
+
+  std::vector<std::string> tlds = {".com", ".co.uk", ".uk", ".org"};
+  manifold::str::SuffixSet suffixes{std::span(tlds)};
+  EXPECT_EQ(suffixes.longest("example.co.uk")->id, 1);
+  EXPECT_EQ(suffixes.longest("example.co.uk")->length, 6);
+  EXPECT_EQ(suffixes.longest("gov.uk")->id, 2);
+  EXPECT_EQ(suffixes.longest("example.com")->id, 0);
+  EXPECT_FALSE(suffixes.longest("example.net"));
+  EXPECT_FALSE(suffixes.matches("com"));
+
+  // thousands of patterns agree with checking each with starts_with
+  std::vector<std::string> patterns;
+  for (int i = 0; i < 3000; i++)
+    patterns.push_back("/r" + std::to_string(i * 37 % 1000) + "/" +
+                       std::string(static_cast<usize>(i % 4), 'x'));
+
+  manifold::str::PrefixSet many{std::span(patterns)};
+  for (int i = 0; i < 1200; i += 7) {
+    std::string path = "/r" + std::to_string(i) + "/xxy";
+    std::optional<usize> expected;
+    for (usize id = 0; id < patterns.size(); id++) {
+      if (manifold::str::starts_with(path, patterns[id]) &&
+          (!expected || patterns[id].size() > patterns[*expected].size()))
+        expected = id;
+    }
+
+    auto found = many.longest(path);
+    ASSERT_EQ(found.has_value(), expected.has_value()) << path;
+    if (found) {
+      EXPECT_EQ(found->id, *expected) << path;
+    }
+  }
+}
+
+TEST(StringTest, Builder) {
+  manifold::str::Builder builder;
+  EXPECT_TRUE(builder.empty());
+  EXPECT_EQ(builder.view(), "");
+
+  builder << "hello" << ' ' << "manifold";
+  EXPECT_EQ(builder.view(), "hello manifold");
+  EXPECT_EQ(builder.take(), "hello manifold");
+  EXPECT_TRUE(builder.empty());
+
+  // many appends spill over several chunks
+  std::string expected;
+  for (int i = 0; i < 20000; i++) {
+    auto piece = std::to_string(i);
+    builder.append(piece).append(',');
+    expected += piece;
+    expected += ',';
+  }
+
+  EXPECT_EQ(builder.size(), expected.size());
+  EXPECT_EQ(builder.str(), expected);
+  EXPECT_EQ(builder.view(), expected);
+
+  // reuse keeps the memory around
+  auto capacity = builder.capacity();
+  builder.clear();
+  builder.append("reused");
+  EXPECT_EQ(builder.str(), "reused");
+  EXPECT_EQ(builder.capacity(), capacity);
+
+  builder.clear();
+  std::vector<std::string_view> parts = {"a", "bb", "", "ccc"};
+  builder.join(parts, ", ");
+  EXPECT_EQ(builder.view(), "a, bb, , ccc");
+
+  builder.clear();
+  builder.join(std::vector<std::string>{}, ",");
+  EXPECT_EQ(builder.view(), "");
+
+  // a moved-from builder is empty and usable
+  builder.append(std::string(3000, 'x'));
+  manifold::str::Builder moved = std::move(builder);
+  EXPECT_EQ(moved.size(), 3000);
+  EXPECT_EQ(builder.size(), 0);
+  EXPECT_EQ(builder.view(), "");
+  builder.append("y");
+  EXPECT_EQ(builder.size(), 1);
+  EXPECT_EQ(builder.view(), "y");
+
+  builder = std::move(moved);
+  EXPECT_EQ(builder.size(), 3000);
+  EXPECT_TRUE(moved.empty());
+  moved.append("z");
+  EXPECT_EQ(moved.view(), "z");
+  EXPECT_EQ(builder.view(), std::string(3000, 'x'));
+}
+
+TEST(StringTest, Format) {
+  using manifold::str::format;
+
+  EXPECT_EQ(format("plain"), "plain");
+  EXPECT_EQ(format("{} + {} = {}", 1, 2u, 3L), "1 + 2 = 3");
+  EXPECT_EQ(format("{{}} {}", "braces"), "{} braces");
+  EXPECT_EQ(format("{}|{}|{}", true, 'c', std::string("str")), "true|c|str");
+  EXPECT_EQ(format("{}", std::string_view("view")), "view");
+  EXPECT_EQ(format("{}", -9223372036854775807L - 1), "-9223372036854775808");
+  EXPECT_EQ(format("{}", nullptr), "0x0");
+
+  EXPECT_EQ(format("[{:5}]", 42), "[   42]");
+  EXPECT_EQ(format("[{:<5}]", 42), "[42   ]");
+  EXPECT_EQ(format("[{:*^7}]", "mid"), "[**mid**]");
+  EXPECT_EQ(format("[{:5}]", "ab"), "[ab   ]");
+  EXPECT_EQ(format("[{:.3}]", "truncated"), "[tru]");
+  EXPECT_EQ(format("{:05}|{:+}|{:+05}", -42, 7, 3), "-0042|+7|+0003");
+  EXPECT_EQ(format("{:x} {:X} {:b} {:o} {:08x}", 255, 255u, 5, 8, 0xbeef),
+            "ff FF 101 10 0000beef");
+
+  EXPECT_EQ(format("{}", 0.1), "0.1");
+  EXPECT_EQ(format("{:.2f}", 3.14159), "3.14");
+  EXPECT_EQ(format("{:e}", 1500.0), "1.500000e+03");
+  EXPECT_EQ(format("{:.3}", 2.0 / 3.0), "0.667");
+  EXPECT_EQ(format("{:08.2f}", -1.5), "-0001.50");
+  EXPECT_EQ(format("{:+}", 2.5f), "+2.5");
+
+  // floats print as floats, not as the double they widen to
+  EXPECT_EQ(format("{}", 0.1f), "0.1");
+  EXPECT_EQ(format("{} {}", 16777217.0f, 1e-45f), "16777216 1e-45");
+  EXPECT_EQ(format("{:.3f}", 0.1f), "0.100");
+
+  // f, e and g default to a precision of 6, as with printf and std::format
+  EXPECT_EQ(format("{:f}", 12345.678), "12345.678000");
+  EXPECT_EQ(format("{:e}", 12345.678), "1.234568e+04");
+  EXPECT_EQ(format("{:g}", 12345.678), "12345.7");
+  EXPECT_EQ(format("{:e}", 0.1f), "1.000000e-01");
+
+  // '0' pads numbers only, infinities and NaN get the fill
+  double inf = std::numeric_limits<double>::infinity();
+  EXPECT_EQ(format("[{:08}]", inf), "[     inf]");
+  EXPECT_EQ(format("[{:+08.2f}]", -inf), "[    -inf]");
+  EXPECT_EQ(format("[{:06}]", std::numeric_limits<float>::quiet_NaN()),
+            "[   nan]");
+  EXPECT_EQ(format("[{:08}]", -2.5), "[-00002.5]");
+
+  // longer than the staging buffer
+  std::string big(2000, 'z');
+  EXPECT_EQ(format("<{}>", big), "<" + big + ">");
+
+  manifold::str::Builder builder;
+  manifold::str::format_to(builder, "{}={};", "a", 1);
+  manifold::str::format_to(builder, "{}={};", "b", 2);
+  EXPECT_EQ(builder.view(), "a=1;b=2;");
+
+  char buffer[8];
+  EXPECT_EQ(manifold::str::format_to(buffer, "{}-{}", 12, 34), 5);
+  EXPECT_EQ(std::string_view(buffer, 5), "12-34");
+  EXPECT_EQ(manifold::str::format_to(buffer, "{}", "cut off here"), 8);
+  EXPECT_EQ(std::string_view(buffer, 8), "cut off ");
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  EXPECT_TRUE(manifold::str::print(fds[1], "{} {}\n", "to", "fd"));
+  close(fds[1]);
+  char read_back[16] = {};
+  EXPECT_EQ(read(fds[0], read_back, sizeof(read_back)), 6);
+  close(fds[0]);
+  EXPECT_EQ(std::string_view(read_back), "to fd\n");
+}
+
+TEST(StringTest, Rope) {
+  manifold::str::Rope rope;
+  EXPECT_TRUE(rope.empty());
+  EXPECT_EQ(rope.to_string(), "");
+
+  rope.append("hello world");
+  rope.insert(5, ",");
+  rope.insert(0, ">> ");
+  rope.insert(100, "!");
+  EXPECT_EQ(rope.to_string(), ">> hello, world!");
+  EXPECT_EQ(rope.at(3), 'h');
+  EXPECT_EQ(rope.substr(3, 5), "hello");
+
+  rope.erase(0, 3);
+  rope.erase(5, 100);
+  EXPECT_EQ(rope.to_string(), "hello");
+
+  // random edits against a plain string
+  std::string mirror;
+  manifold::str::Rope text;
+  unsigned state = 1;
+  auto next = [&](size_t bound) {
+    state = state * 1103515245 + 12345;
+    return bound == 0 ? 0 : (state >> 8) % bound;
+  };
+
+  for (int i = 0; i < 2000; i++) {
+    size_t pos = next(mirror.size() + 1);
+    if (next(3) != 0) {
+      std::string piece(next(i % 50 == 0 ? 5000 : 40) + 1,
+                        static_cast<char>('a' + i % 26));
+      text.insert(pos, piece);
+      mirror.insert(pos, piece);
+    } else {
+      size_t count = next(200);
+      text.erase(pos, count);
+      mirror.erase(std::min(pos, mirror.size()), count);
+    }
+
+    ASSERT_EQ(text.size(), mirror.size());
+  }
+
+  EXPECT_EQ(text.to_string(), mirror);
+  EXPECT_EQ(text.substr(100, 1000), mirror.substr(100, 1000));
+
+  std::string chunks;
+  text.for_each_chunk([&](std::string_view chunk) { chunks += chunk; });
+  EXPECT_EQ(chunks, mirror);
+
+  text.clear();
+  EXPECT_TRUE(text.empty());
+}
+
+TEST(StringTest, TransparentHash) {
+  EXPECT_EQ(manifold::str::hash("route"),
+            manifold::str::hash(std::string("route")));
+  EXPECT_NE(manifold::str::hash("route"), manifold::str::hash("route", 1));
+  EXPECT_NE(manifold::str::hash("route"), manifold::str::hash("router"));
+
+  manifold::str::HashMap<int> routes = {{"/index", 1}, {"/api/v1", 2}};
+  std::string_view path = "/api/v1/users";
+  auto found = routes.find(path.substr(0, 7));
+  ASSERT_NE(found, routes.end());
+  EXPECT_EQ(found->second, 2);
+  EXPECT_TRUE(routes.contains("/index"));
+  EXPECT_EQ(routes.count(std::string_view("/missing")), 0);
+
+  // keyed hashing is deterministic for a key and differs between keys
+  manifold::str::SeededHash keyed(1, 2);
+  manifold::str::SeededHash other(3, 4);
+  EXPECT_EQ(keyed("route"), manifold::str::SeededHash(1, 2)("route"));
+  EXPECT_NE(keyed("route"), other("route"));
+  EXPECT_EQ(manifold::str::SeededHash()("route"),
+            manifold::str::SeededHash()("route"));
+
+  manifold::str::HashSet<manifold::str::SeededHash> seen;
+  seen.insert("a");
+  seen.emplace(std::string(100, 'b'));
+  EXPECT_TRUE(seen.contains(std::string_view(std::string(100, 'b'))));
+  EXPECT_FALSE(seen.contains("c"));
+}
+
+TEST(StringTest, Interner) {
+  manifold::str::Interner interner;
+  EXPECT_TRUE(interner.empty());
+  EXPECT_FALSE(interner.find("missing").has_value());
+
+  auto hello = interner.intern("hello");
+  auto world = interner.intern("world");
+  auto empty = interner.intern("");
+  EXPECT_NE(hello, world);
+  EXPECT_EQ(interner.intern(std::string("hello")), hello);
+  EXPECT_EQ(interner.find("world"), world);
+  EXPECT_EQ(interner.view(hello), "hello");
+  EXPECT_EQ(interner[empty], "");
+  EXPECT_EQ(interner.size(), 3);
+
+  auto large = std::string(100000, 'x');
+  EXPECT_EQ(interner[interner.intern(large)], large);
+
+  // views stay valid while the interner keeps growing
+  auto view = interner.view(hello);
+  for (int i = 0; i < 10000; i++)
+    interner.intern("key-" + std::to_string(i));
+
+  EXPECT_EQ(view, "hello");
+  EXPECT_EQ(view.data(), interner.view(hello).data());
+  EXPECT_EQ(interner.size(), 10004);
+}
+
+TEST(StringTest, InternerConcurrent) {
+  manifold::str::Interner interner;
+  constexpr int kThreads = 8;
+  constexpr int kKeys = 20000;
+
+  // every thread interns the same keys in a different order
+  std::vector<std::vector<manifold::str::Interner::id_type>> ids(kThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t] {
+      ids[t].resize(kKeys);
+      for (int i = 0; i < kKeys; i++) {
+        int key = (i * 7919 + t * 104729) % kKeys;
+        ids[t][key] = interner.intern("shared/" + std::to_string(key));
+      }
+    });
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_EQ(interner.size(), kKeys);
+  for (int t = 1; t < kThreads; t++)
+    EXPECT_EQ(ids[t], ids[0]);
+
+  for (int key = 0; key < kKeys; key++)
+    EXPECT_EQ(interner[ids[0][key]], "shared/" + std::to_string(key));
+}
+
+TEST(StringTest, InlineString) {
+  using key = manifold::str::InlineString<32>;
+  static_assert(std::is_trivially_copyable_v<key>);
+  static_assert(sizeof(key) == 33);
+
+  key id("request-id/0123456789abcdef");
+  EXPECT_EQ(id.size(), 27);
+  EXPECT_EQ(id, "request-id/0123456789abcdef");
+  EXPECT_TRUE(id.starts_with("request-id/"));
+  EXPECT_EQ(id.substr(11, 4), "0123");
+  EXPECT_EQ(id.find('/'), 10);
+  EXPECT_EQ(std::string(id.begin(), id.end()), id.view());
+
+  auto copy = id;
+  EXPECT_EQ(copy, id);
+  EXPECT_LT(key("abc"), key("abd"));
+  EXPECT_EQ(manifold::str::InlineString<4>("abcd"), key("abcd"));
+
+  EXPECT_TRUE(copy.append("-tag1"));
+  EXPECT_FALSE(copy.append("-too-long"));
+  EXPECT_EQ(copy, "request-id/0123456789abcdef-tag1");
+  EXPECT_EQ(copy.size(), key::capacity());
+
+  EXPECT_FALSE(key::from(std::string(33, 'x')).has_value());
+  EXPECT_EQ(key::truncate(std::string(40, 'x')).size(), 32);
+  EXPECT_TRUE(key().empty());
+  EXPECT_FALSE(copy.assign(std::string(33, 'x')));
+  EXPECT_EQ(copy, "request-id/0123456789abcdef-tag1");
+  EXPECT_TRUE(copy.assign("short"));
+  EXPECT_EQ(copy, "short");
+
+  std::unordered_map<key, int> counts;
+  counts[key("alpha")]++;
+  counts[key("alpha")]++;
+  counts[key("beta")]++;
+  EXPECT_EQ(counts.at(key("alpha")), 2);
+  EXPECT_EQ(counts.size(), 2);
+
+  // an over-long key is refused rather than cut down to a shorter one that
+  // another key shares
+  using short_key = manifold::str::InlineString<8>;
+  static_assert(!std::is_convertible_v<const char *, short_key>);
+  static_assert(!std::is_convertible_v<std::string_view, short_key>);
+  std::unordered_map<short_key, int> sessions;
+  sessions[short_key("session")] = 1;
+  for (std::string_view name : {"session_a1", "session_b2"}) {
+    auto session = short_key::from(name);
+    EXPECT_FALSE(session.has_value()) << name;
+    if (session) {
+      EXPECT_EQ(sessions.count(*session), 0) << name;
+    }
+  }
+
+  EXPECT_NE(short_key::truncate("session_a1"), "session_a1");
+  EXPECT_DEATH(short_key{std::string_view("session_a1")}, "");
+}
+
 TEST(StringTest, UpperLower) {
   EXPECT_EQ(manifold::str::to_upper("manifold"), "MANIFOLD");
   EXPECT_EQ(manifold::str::to_upper(""), "");
@@ -44,6 +704,598 @@ TEST(StringTest, UpperLower) {
   EXPECT_EQ(manifold::str::to_lower(""), "");
 }
 
+TEST(StringTest, AsciiCaseConversion) {
+  // every byte value at every length and alignment the kernels care about
+  std::string bytes;
+  for (int round = 0; round < 3; round++)
+    for (int i = 0; i < 256; i++)
+      bytes.push_back(static_cast<char>(i));
+
+  auto reference = [](std::string_view str, char first) {
+    std::string result(str);
+    for (auto &ch : result)
+      if (static_cast<unsigned char>(ch - first) < 26)
+        ch = static_cast<char>(ch ^ 0x20);
+
+    return result;
+  };
+
+  for (size_t offset = 0; offset < 4; offset++) {
+    for (size_t size = 0; size + offset <= bytes.size(); size += 13) {
+      auto view = std::string_view(bytes).substr(offset, size);
+      EXPECT_EQ(manifold::str::to_lower(view), reference(view, 'A'));
+      EXPECT_EQ(manifold::str::to_upper(view), reference(view, 'a'));
+    }
+  }
+
+  std::string text = "Content-Type: TEXT/html; charset=UTF-8";
+  manifold::str::to_lower_in_place(text);
+  EXPECT_EQ(text, "content-type: text/html; charset=utf-8");
+  manifold::str::to_upper_in_place(text);
+  EXPECT_EQ(text, "CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8");
+
+  char buffer[8] = {};
+  EXPECT_EQ(manifold::str::to_lower("HeLLo", buffer), 5);
+  EXPECT_EQ(std::string_view(buffer, 5), "hello");
+  EXPECT_EQ(manifold::str::to_upper("truncated", buffer), sizeof(buffer));
+  EXPECT_EQ(std::string_view(buffer, sizeof(buffer)), "TRUNCATE");
+}
+
+TEST(StringTest, Utf8Validate) {
+  namespace utf8 = manifold::str::utf8;
+
+  EXPECT_TRUE(utf8::validate(""));
+  EXPECT_TRUE(utf8::validate("plain ascii"));
+  EXPECT_TRUE(
+      utf8::validate("gr\xc3\xbc\xc3\x9f \xe4\xb8\xad \xf0\x9f\x98\x80"));
+  EXPECT_TRUE(utf8::validate("\xef\xbf\xbf\xf4\x8f\xbf\xbf"));
+
+  // overlongs, surrogates, past U+10FFFF, stray and missing continuations
+  EXPECT_EQ(utf8::find_invalid("ab\xc0\x80"), 2);
+  EXPECT_EQ(utf8::find_invalid("ab\xe0\x80\x80"), 2);
+  EXPECT_EQ(utf8::find_invalid("ab\xf0\x80\x80\x80"), 2);
+  EXPECT_EQ(utf8::find_invalid("ab\xed\xa0\x80"), 2);
+  EXPECT_EQ(utf8::find_invalid("ab\xf4\x90\x80\x80"), 2);
+  EXPECT_EQ(utf8::find_invalid("ab\x80"), 2);
+  EXPECT_EQ(utf8::find_invalid("ab\xff"), 2);
+  EXPECT_EQ(utf8::find_invalid("ab\xe2\x82"), 2);
+  EXPECT_EQ(utf8::find_invalid("ab\xe2\x82x"), 2);
+  EXPECT_EQ(utf8::find_invalid("ab\xc3\xa9"), std::string_view::npos);
+
+  // errors placed around the 16 and 32 byte blocks the kernels work in
+  for (size_t prefix = 0; prefix < 70; prefix++) {
+    std::string text(prefix, 'a');
+    text += "\xe2\x82\xac";
+    EXPECT_TRUE(utf8::validate(text));
+
+    auto truncated = text.substr(0, text.size() - 1);
+    EXPECT_EQ(utf8::find_invalid(truncated), prefix);
+
+    auto broken = text;
+    broken += "\xf0\x9f\x98";
+    broken += std::string(40, 'b');
+    EXPECT_EQ(utf8::find_invalid(broken), prefix + 3);
+
+    broken = std::string(prefix, '\x80');
+    EXPECT_EQ(utf8::find_invalid(broken),
+              prefix == 0 ? std::string_view::npos : 0);
+  }
+}
+
+TEST(StringTest, Utf8Transcode) {
+  namespace utf8 = manifold::str::utf8;
+
+  std::string text = "caf\xc3\xa9 \xe2\x82\xac\xf0\x9f\x98\x80";
+  EXPECT_EQ(utf8::count_codepoints(text), 7);
+
+  auto wide = utf8::to_utf16(text);
+  ASSERT_FALSE(wide.has_error());
+  EXPECT_EQ(wide.value(), u"café €\U0001F600");
+  EXPECT_EQ(wide.value().size(), 8);
+  EXPECT_EQ(wide.value()[6], 0xd83d);
+  EXPECT_EQ(wide.value()[7], 0xde00);
+
+  auto full = utf8::to_utf32(text);
+  ASSERT_FALSE(full.has_error());
+  EXPECT_EQ(full.value(), U"café €\U0001F600");
+
+  // long ascii runs take the widening path
+  std::string ascii(100, 'x');
+  ascii += "\xc3\xa9";
+  EXPECT_EQ(utf8::to_utf16(ascii).value(), std::u16string(100, u'x') + u"é");
+  EXPECT_EQ(utf8::count_codepoints(ascii), 101);
+
+  auto invalid = utf8::to_utf32("ok\xed\xa0\x80");
+  ASSERT_TRUE(invalid.has_error());
+  EXPECT_EQ(invalid.error().offset, 2);
+  EXPECT_TRUE(utf8::to_utf16("\xc3").has_error());
+}
+
+TEST(StringTest, FoldCase) {
+  EXPECT_EQ(manifold::str::fold_case("Hello World"), "hello world");
+  EXPECT_EQ(manifold::str::fold_case("Stra\xc3\x9f" "e"), "strasse");
+  EXPECT_EQ(manifold::str::fold_case("\xce\x9a\xce\x91\xce\x9b\xce\x97"),
+            "\xce\xba\xce\xb1\xce\xbb\xce\xb7");
+  EXPECT_EQ(manifold::str::fold_case("\xd0\x9c\xd0\x98\xd0\xa0"),
+            "\xd0\xbc\xd0\xb8\xd1\x80");
+  EXPECT_EQ(manifold::str::fold_case("\xef\xbc\xa1"), "\xef\xbd\x81");
+  EXPECT_EQ(manifold::str::fold_case("\xf0\x90\x90\x80"), "\xf0\x90\x90\xa8");
+
+  // case-insensitive equality through the fold
+  EXPECT_EQ(manifold::str::fold_case("MASSE"),
+            manifold::str::fold_case("Ma\xc3\x9f" "e"));
+
+  // invalid bytes are kept as they are
+  EXPECT_EQ(manifold::str::fold_case("A\xff" "B\xc3"), "a\xff" "b\xc3");
+
+  // the ascii case helpers leave multibyte sequences alone
+  EXPECT_EQ(manifold::str::to_upper("\xc3\xa9t\xc3\xa9"), "\xc3\xa9T\xc3\xa9");
+}
+
+TEST(StringTest, CaseInsensitive) {
+  using manifold::str::icompare;
+  using manifold::str::iequals;
+  using manifold::str::ifind;
+  using manifold::str::ihash;
+
+  EXPECT_TRUE(iequals("Content-Type", "content-TYPE"));
+  EXPECT_TRUE(iequals("", ""));
+  EXPECT_FALSE(iequals("Content-Type", "Content-Typo"));
+  EXPECT_FALSE(iequals("abc", "abcd"));
+  // only letters fold: '@' and '`' sit right next to them
+  EXPECT_FALSE(iequals("@[", "`{"));
+  EXPECT_FALSE(iequals("\xc3\x89", "\xc3\xa9"));
+
+  EXPECT_EQ(icompare("apple", "BANANA"), std::strong_ordering::less);
+  EXPECT_EQ(icompare("Zebra", "apple"), std::strong_ordering::greater);
+  EXPECT_EQ(icompare("HeLLo", "hello"), std::strong_ordering::equal);
+  EXPECT_EQ(icompare("abc", "ABCD"), std::strong_ordering::less);
+  EXPECT_EQ(icompare("a_", "AB"), std::strong_ordering::less);
+
+  EXPECT_EQ(ihash("X-Request-ID"), ihash("x-request-id"));
+  EXPECT_EQ(ihash("X-Request-ID"), manifold::str::hash("x-request-id"));
+  EXPECT_NE(ihash("X-Request-ID"), ihash("X-Request-IE"));
+  EXPECT_NE(ihash("abc", 1), ihash("abc", 2));
+
+  // long enough for the vector kernels and more than one hash stage
+  std::string text;
+  for (int i = 0; i < 700; i++)
+    text.push_back(static_cast<char>(" aZ-bY_cX.9\xe9"[i % 13]));
+
+  std::string upper = manifold::str::to_upper(text);
+  EXPECT_TRUE(iequals(text, upper));
+  EXPECT_EQ(icompare(text, upper), std::strong_ordering::equal);
+  EXPECT_EQ(ihash(text), ihash(upper));
+  for (usize at : {usize{0}, usize{17}, usize{40}, usize{333}, usize{699}}) {
+    std::string changed = upper;
+    changed[at] = '!';
+    EXPECT_FALSE(iequals(text, changed)) << at;
+    EXPECT_NE(icompare(text, changed), std::strong_ordering::equal) << at;
+    EXPECT_NE(ihash(text), ihash(changed)) << at;
+  }
+
+  EXPECT_EQ(ifind("Hello World", "WORLD"), 6);
+  EXPECT_EQ(ifind("Hello World", "o", 5), 7);
+  EXPECT_EQ(ifind("Hello World", ""), 0);
+  EXPECT_EQ(ifind("Hello", "hello!"), std::string_view::npos);
+  EXPECT_EQ(ifind("Hello", "l", 9), std::string_view::npos);
+
+  std::string haystack(1000, 'a');
+  haystack.replace(900, 14, "Accept-ENCODING");
+  EXPECT_EQ(ifind(haystack, "accept-encoding"), 900);
+  EXPECT_EQ(ifind(haystack, "aacc"), 899);
+  EXPECT_EQ(ifind(haystack, "accept-encodinh"), std::string_view::npos);
+  for (usize pos = 0; pos < 64; pos++)
+    EXPECT_EQ(ifind(haystack, "A", pos), pos);
+
+  manifold::str::IHashMap<int> headers;
+  headers["Content-Length"] = 42;
+  headers["content-length"]++;
+  EXPECT_EQ(headers.size(), 1);
+  EXPECT_EQ(headers.find(std::string_view("CONTENT-LENGTH"))->second, 43);
+}
+
+TEST(StringTest, ParseNumbers) {
+  using manifold::str::ParseError;
+
+  EXPECT_EQ(manifold::str::parse<int>("42").value(), 42);
+  EXPECT_EQ(manifold::str::parse<int>("-42").value(), -42);
+  EXPECT_EQ(manifold::str::parse<int>("+7").value(), 7);
+  EXPECT_EQ(manifold::str::parse<long>("1234567890123456789").value(),
+            1234567890123456789L);
+  EXPECT_EQ(manifold::str::parse<long>("-9223372036854775808").value(),
+            std::numeric_limits<long>::min());
+  EXPECT_EQ(manifold::str::parse<unsigned long>("18446744073709551615").value(),
+            std::numeric_limits<unsigned long>::max());
+  EXPECT_EQ(manifold::str::parse<unsigned char>("0000000000000000255").value(),
+            255);
+
+  EXPECT_EQ(manifold::str::parse<int>("").error(), ParseError::Empty);
+  EXPECT_EQ(manifold::str::parse<int>("-").error(), ParseError::Invalid);
+  EXPECT_EQ(manifold::str::parse<int>(" 1").error(), ParseError::Invalid);
+  EXPECT_EQ(manifold::str::parse<int>("12345678x").error(),
+            ParseError::Invalid);
+  EXPECT_EQ(manifold::str::parse<unsigned>("-1").error(), ParseError::Invalid);
+  EXPECT_EQ(manifold::str::parse<int>("2147483648").error(),
+            ParseError::OutOfRange);
+  EXPECT_EQ(manifold::str::parse<unsigned char>("1234567812345678").error(),
+            ParseError::OutOfRange);
+  EXPECT_EQ(manifold::str::parse<unsigned long>("18446744073709551616").error(),
+            ParseError::OutOfRange);
+
+  EXPECT_EQ(manifold::str::parse<double>("3.25").value(), 3.25);
+  EXPECT_EQ(manifold::str::parse<double>("-1e3").value(), -1000.0);
+  EXPECT_EQ(manifold::str::parse<float>("+0.5").value(), 0.5f);
+  EXPECT_EQ(manifold::str::parse<double>("1e999").error(),
+            ParseError::OutOfRange);
+  EXPECT_EQ(manifold::str::parse<double>("1.5ms").error(),
+            ParseError::Invalid);
+
+  // metrics lines are split and parsed without allocating
+  long total = 0;
+  for (auto field : manifold::str::split_view("12,-3,40000000000,7", ","))
+    total += manifold::str::parse<long>(field).value();
+
+  EXPECT_EQ(total, 40000000016);
+}
+
+TEST(StringTest, FormatNumbers) {
+  char buffer[manifold::str::kMaxNumberChars];
+  auto format = [&](auto value) {
+    usize size;
+    if constexpr (std::is_floating_point_v<decltype(value)>)
+      size = manifold::str::format_float(value, buffer);
+    else
+      size = manifold::str::format_int(value, buffer);
+
+    return std::string(buffer, size);
+  };
+
+  EXPECT_EQ(format(0), "0");
+  EXPECT_EQ(format(7), "7");
+  EXPECT_EQ(format(-42), "-42");
+  EXPECT_EQ(format(1000000), "1000000");
+  EXPECT_EQ(format(std::numeric_limits<long>::min()), "-9223372036854775808");
+  EXPECT_EQ(format(std::numeric_limits<unsigned long>::max()),
+            "18446744073709551615");
+
+  EXPECT_EQ(format(0.1), "0.1");
+  EXPECT_EQ(format(-2.5f), "-2.5");
+  EXPECT_EQ(format(1e300), "1e+300");
+  EXPECT_EQ(format(-std::numeric_limits<double>::denorm_min()), "-5e-324");
+  EXPECT_EQ(format(-std::numeric_limits<double>::max()),
+            "-1.7976931348623157e+308");
+
+  // shortest output still round-trips
+  for (double value : {1.0 / 3.0, 2.0 / 3.0, 123456.789, 1e-7})
+    EXPECT_EQ(manifold::str::parse<double>(format(value)).value(), value);
+
+  // too small a buffer writes nothing
+  char small[3] = {'x', 'x', 'x'};
+  EXPECT_EQ(manifold::str::format_int(1234, small), 0);
+  EXPECT_EQ(manifold::str::format_float(0.125, small), 0);
+  EXPECT_EQ(manifold::str::format_int(-12, small), 3);
+  EXPECT_EQ(std::string_view(small, 3), "-12");
+}
+
+TEST(StringTest, EditDistance) {
+  EXPECT_EQ(manifold::str::levenshtein("kitten", "sitting"), 3);
+  EXPECT_EQ(manifold::str::levenshtein("", "abc"), 3);
+  EXPECT_EQ(manifold::str::levenshtein("abc", ""), 3);
+  EXPECT_EQ(manifold::str::levenshtein("flaw", "lawn"), 2);
+  EXPECT_EQ(manifold::str::levenshtein("same", "same"), 0);
+
+  // transpositions are one edit only for damerau
+  EXPECT_EQ(manifold::str::levenshtein("ca", "ac"), 2);
+  EXPECT_EQ(manifold::str::damerau("ca", "ac"), 1);
+  EXPECT_EQ(manifold::str::damerau("recieve", "receive"), 1);
+  EXPECT_EQ(manifold::str::damerau("ca", "abc"), 3);
+
+  // patterns longer than a machine word
+  std::string long_a(150, 'x');
+  std::string long_b = long_a;
+  long_b[3] = 'y';
+  long_b[100] = 'y';
+  std::swap(long_b[70], long_b[71]);
+  long_b[71] = 'z';
+  long_b.insert(long_b.begin() + 130, 'w');
+  EXPECT_EQ(manifold::str::levenshtein(long_a, long_b), 4);
+  std::string cycle;
+  for (usize i = 0; i < 150; i++)
+    cycle += static_cast<char>('a' + i % 10);
+  std::string swapped = cycle;
+  swapped.front() = '#';
+  swapped.back() = '#';
+  std::swap(swapped[63], swapped[64]);
+  EXPECT_EQ(manifold::str::levenshtein(cycle, swapped), 4);
+  EXPECT_EQ(manifold::str::damerau(cycle, swapped), 3);
+
+  EXPECT_TRUE(manifold::str::within_distance("kitten", "sitting", 3));
+  EXPECT_FALSE(manifold::str::within_distance("kitten", "sitting", 2));
+  EXPECT_FALSE(manifold::str::within_distance("a", "abcdef", 4));
+
+  std::vector<std::string_view> names = {"commit", "checkout", "cherry-pick",
+                                         "clone",  "config",   "comit"};
+  std::vector<usize> distances(names.size());
+  manifold::str::levenshtein("comit", names, distances);
+  for (usize i = 0; i < names.size(); i++)
+    EXPECT_EQ(distances[i], manifold::str::levenshtein("comit", names[i]));
+
+  EXPECT_EQ(manifold::str::closest("comit", names, 2), 5);
+  EXPECT_EQ(manifold::str::closest("chekout", names, 2), 1);
+  EXPECT_EQ(manifold::str::closest("status", names, 2),
+            std::string_view::npos);
+}
+
+TEST(StringTest, FuzzyMatch) {
+  // a word start scores twice for the first byte, the '_' boundary once,
+  // and the three skipped bytes cost one gap
+  EXPECT_EQ(manifold::str::fuzzy_score("fb", "foo_bar"), 55);
+  EXPECT_EQ(manifold::str::fuzzy_score("", "anything"), 0);
+  EXPECT_FALSE(manifold::str::fuzzy_score("xyz", "foo_bar"));
+  EXPECT_FALSE(manifold::str::fuzzy_score("ba", "ab"));
+
+  // smart case
+  EXPECT_TRUE(manifold::str::fuzzy_score("fb", "FooBar"));
+  EXPECT_TRUE(manifold::str::fuzzy_score("FB", "FooBar"));
+  EXPECT_FALSE(manifold::str::fuzzy_score("FB", "foobar"));
+
+  // word boundaries and camel case beat matches mid-word
+  EXPECT_GT(*manifold::str::fuzzy_score("gc", "getConfig"),
+            *manifold::str::fuzzy_score("gc", "magic"));
+  EXPECT_GT(*manifold::str::fuzzy_score("main", "src/main.cpp"),
+            *manifold::str::fuzzy_score("main", "src/domain.cpp"));
+
+  std::vector<std::string_view> files = {"lib/os/str.cpp", "src/main.cpp",
+                                         "include/manifold/os/str.hpp",
+                                         "test/str.cpp", "README.md"};
+  auto matches = manifold::str::fuzzy_search("str", files);
+  ASSERT_EQ(matches.size(), 3);
+  EXPECT_EQ(matches[0].index, 3);
+  for (usize i = 1; i < matches.size(); i++)
+    EXPECT_GE(matches[i - 1].score, matches[i].score);
+
+  auto best = manifold::str::fuzzy_search("str", files, 2);
+  ASSERT_EQ(best.size(), 2);
+  EXPECT_EQ(best[0].index, matches[0].index);
+  EXPECT_EQ(best[1].index, matches[1].index);
+}
+
+TEST(StringTest, Pattern) {
+  auto compile = [](std::string_view source,
+                    manifold::str::PatternOptions options = {}) {
+    auto pattern = manifold::str::Pattern::compile(source, options);
+    EXPECT_FALSE(pattern.has_error()) << source;
+    return std::move(pattern.value());
+  };
+
+  auto cpp = compile(R"(^(src|lib)/.*\.(cpp|hpp)$)");
+  EXPECT_TRUE(cpp.search("src/os/str.cpp"));
+  EXPECT_TRUE(cpp.search("lib/fuzzy.hpp"));
+  EXPECT_FALSE(cpp.search("test/str.cpp"));
+  EXPECT_FALSE(cpp.search("src/str.cpp.o"));
+  EXPECT_TRUE(cpp.matches("lib/a.cpp"));
+
+  // search finds a match anywhere, matches needs the whole text
+  auto digits = compile(R"(\d{2,3})");
+  EXPECT_TRUE(digits.search("build 42 done"));
+  EXPECT_FALSE(digits.search("build 4 done"));
+  EXPECT_TRUE(digits.matches("123"));
+  EXPECT_FALSE(digits.matches("1234"));
+
+  auto classes = compile(R"([^/]+\s[\w-]*[]x]?)");
+  EXPECT_TRUE(classes.matches("a b-c_d]"));
+  EXPECT_FALSE(classes.matches("a/ b"));
+
+  auto alternation = compile("(?:ab|cd)+e?|^$");
+  EXPECT_TRUE(alternation.matches("abcdab"));
+  EXPECT_TRUE(alternation.matches("cde"));
+  EXPECT_TRUE(alternation.matches(""));
+  EXPECT_FALSE(alternation.matches("abc"));
+
+  auto insensitive = compile("readme\\.[a-z]+", {.ignore_case = true});
+  EXPECT_TRUE(insensitive.search("docs/README.MD"));
+  EXPECT_FALSE(compile("readme").search("README"));
+
+  // `.` and negated classes take a whole UTF-8 sequence
+  EXPECT_TRUE(compile("^caf.$").matches("caf\xc3\xa9"));
+  EXPECT_TRUE(compile("^[^a]x$").matches("\xe2\x82\xacx"));
+  EXPECT_FALSE(compile("^caf..$").matches("caf\xc3\xa9"));
+
+  // nested repeats that make backtracking engines exponential
+  auto nested = compile("^(a+)+$");
+  EXPECT_FALSE(nested.matches(std::string(5000, 'a') + "b"));
+  EXPECT_TRUE(nested.matches(std::string(5000, 'a')));
+
+  // the 13th byte from the end being 'a' takes 2^13 DFA states, more than
+  // the cache holds
+  auto wide = compile("a[ab]{12}$");
+  std::string text;
+  for (usize i = 0; i < 20000; i++)
+    text += "ab"[(i * 7919) % 13 % 2];
+  for (usize size : {usize{100}, usize{5000}, text.size()}) {
+    std::string_view prefix(text.data(), size);
+    EXPECT_EQ(wide.search(prefix), prefix[size - 13] == 'a');
+  }
+
+  // copies match like the original, and a pattern works as a path matcher
+  auto copy = cpp;
+  EXPECT_TRUE(copy("src/x.hpp"));
+  std::function<bool(const std::filesystem::path &)> matcher = cpp;
+  EXPECT_TRUE(matcher(std::filesystem::path("src/a/b.cpp")));
+  EXPECT_FALSE(matcher(std::filesystem::path("docs/b.cpp")));
+
+  using Kind = manifold::str::PatternError::Kind;
+  auto error = [](std::string_view source) {
+    auto pattern = manifold::str::Pattern::compile(source);
+    EXPECT_TRUE(pattern.has_error()) << source;
+    return pattern.has_error() ? pattern.error()
+                               : manifold::str::PatternError{};
+  };
+
+  EXPECT_EQ(error("a(b").kind, Kind::UnbalancedGroup);
+  EXPECT_EQ(error("a(b").offset, 1);
+  EXPECT_EQ(error("ab)").kind, Kind::UnbalancedGroup);
+  EXPECT_EQ(error("[ab").kind, Kind::UnterminatedClass);
+  EXPECT_EQ(error("[z-a]").kind, Kind::BadRange);
+  EXPECT_EQ(error("a\\q").kind, Kind::BadEscape);
+  EXPECT_EQ(error("a{3,1}").kind, Kind::BadRepeat);
+  EXPECT_EQ(error("a**").kind, Kind::BadRepeat);
+  EXPECT_EQ(error("*a").kind, Kind::NothingToRepeat);
+  EXPECT_EQ(error("[\xc3\xa9]").kind, Kind::NonAsciiClass);
+  EXPECT_EQ(error("(a{1000}){1000}").kind, Kind::TooLarge);
+}
+
+TEST(StringTest, PatternConcurrent) {
+  auto compiled = manifold::str::Pattern::compile("a[ab]{12}$");
+  ASSERT_FALSE(compiled.has_error());
+  const manifold::str::Pattern &wide = compiled.value();
+  constexpr int kThreads = 8;
+
+  // the pattern needs more states than a cache holds, so every thread keeps
+  // building and clearing states while the others match
+  std::string text;
+  for (usize i = 0; i < 20000; i++)
+    text += "ab"[(i * 7919) % 13 % 2];
+
+  std::vector<int> wrong(kThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t] {
+      for (usize size = 13 + t; size <= text.size(); size += 997) {
+        std::string_view prefix(text.data(), size);
+        if (wide.search(prefix) != (prefix[size - 13] == 'a'))
+          wrong[t]++;
+      }
+    });
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  for (int t = 0; t < kThreads; t++)
+    EXPECT_EQ(wrong[t], 0) << t;
+
+  // a copy shares the idle caches and still matches on its own
+  manifold::str::Pattern copy = wide;
+  EXPECT_TRUE(copy.search("xxab" + std::string(11, 'b')));
+}
+
+TEST(StringTest, Base64) {
+  namespace base64 = manifold::str::base64;
+  using Alphabet = base64::Alphabet;
+
+  // RFC 4648 section 10
+  std::vector<std::pair<std::string, std::string>> vectors = {
+      {"", ""},         {"f", "Zg=="},         {"fo", "Zm8="},
+      {"foo", "Zm9v"},  {"foob", "Zm9vYg=="},  {"fooba", "Zm9vYmE="},
+      {"foobar", "Zm9vYmFy"}};
+  for (auto &[plain, encoded] : vectors) {
+    EXPECT_EQ(base64::encode(plain), encoded);
+    auto decoded = base64::decode(encoded);
+    ASSERT_FALSE(decoded.has_error()) << encoded;
+    EXPECT_EQ(std::string(decoded->begin(), decoded->end()), plain);
+  }
+
+  // the url alphabet does not pad, and padding is optional when decoding
+  std::string bytes = "\xfb\xff\xfe";
+  EXPECT_EQ(base64::encode(bytes), "+//+");
+  EXPECT_EQ(base64::encode(bytes, Alphabet::Url), "-__-");
+  EXPECT_EQ(base64::encode("fo", Alphabet::Url), "Zm8");
+  EXPECT_EQ(base64::encoded_size(2, Alphabet::Url), 3);
+  EXPECT_EQ(base64::decoded_size("Zm8="), 2);
+  EXPECT_EQ(base64::decode("Zm8", Alphabet::Url)->size(), 2);
+  EXPECT_EQ(base64::decode("Zm8")->size(), 2);
+
+  // long enough for the vector kernels, with every byte value
+  std::string data;
+  for (int i = 0; i < 1000; i++)
+    data.push_back(static_cast<char>(i * 7 + i / 256));
+
+  for (usize size : {0, 1, 15, 16, 28, 31, 47, 48, 95, 96, 97, 1000}) {
+    std::string_view part = std::string_view(data).substr(0, size);
+    for (auto alphabet : {Alphabet::Standard, Alphabet::Url}) {
+      std::string encoded = base64::encode(part, alphabet);
+      EXPECT_EQ(encoded.size(), base64::encoded_size(size, alphabet));
+      auto decoded = base64::decode(encoded, alphabet);
+      ASSERT_FALSE(decoded.has_error()) << size;
+      EXPECT_EQ(std::string(decoded->begin(), decoded->end()), part);
+    }
+  }
+
+  // an invalid character is reported where it is, in a vector block or not
+  using Kind = manifold::str::DecodeError::Kind;
+  std::string encoded = base64::encode(data);
+  for (usize at : {usize{0}, usize{5}, usize{31}, usize{100}, usize{700},
+                   encoded.size() - 3}) {
+    std::string bad = encoded;
+    bad[at] = '*';
+    auto decoded = base64::decode(bad);
+    ASSERT_TRUE(decoded.has_error());
+    EXPECT_EQ(decoded.error().kind, Kind::InvalidChar);
+    EXPECT_EQ(decoded.error().offset, at);
+  }
+
+  EXPECT_EQ(base64::decode("Zm9v\n").error().kind, Kind::BadLength);
+  EXPECT_EQ(base64::decode("Zm8=Zm8=").error().kind, Kind::InvalidChar);
+  EXPECT_EQ(base64::decode("Zm9=v").error().kind, Kind::BadLength);
+  EXPECT_EQ(base64::decode("-__-").error().kind, Kind::InvalidChar);
+  EXPECT_EQ(base64::decode("+//+", Alphabet::Url).error().offset, 0);
+
+  std::array<u8, 5> small;
+  EXPECT_EQ(base64::decode("Zm9vYmFy", small).error().kind,
+            Kind::BufferTooSmall);
+  EXPECT_EQ(*base64::decode("Zm9vYg", small), 4);
+  std::array<char, 7> out;
+  EXPECT_EQ(base64::encode(std::span<const u8>(small.data(), 4), out), 0);
+  EXPECT_EQ(base64::encode(std::span<const u8>(small.data(), 3), out), 4);
+  EXPECT_EQ(std::string_view(out.data(), 4), "Zm9v");
+}
+
+TEST(StringTest, Hex) {
+  namespace hex = manifold::str::hex;
+  using Kind = manifold::str::DecodeError::Kind;
+
+  EXPECT_EQ(hex::encode(""), "");
+  EXPECT_EQ(hex::encode("\x01\xab\xff"), "01abff");
+  EXPECT_EQ(hex::encode("\x01\xab\xff", true), "01ABFF");
+  auto decoded = hex::decode("01aBfF");
+  ASSERT_FALSE(decoded.has_error());
+  EXPECT_EQ(*decoded, (std::vector<u8>{0x01, 0xab, 0xff}));
+
+  std::string data;
+  for (int i = 0; i < 300; i++)
+    data.push_back(static_cast<char>(i * 13));
+
+  for (usize size : {1, 15, 16, 17, 31, 32, 33, 64, 300}) {
+    std::string_view part = std::string_view(data).substr(0, size);
+    for (bool uppercase : {false, true}) {
+      std::string encoded = hex::encode(part, uppercase);
+      ASSERT_EQ(encoded.size(), size * 2);
+      EXPECT_EQ(encoded.find(uppercase ? 'a' : 'A'), std::string::npos);
+      auto round = hex::decode(encoded);
+      ASSERT_FALSE(round.has_error()) << size;
+      EXPECT_EQ(std::string(round->begin(), round->end()), part);
+    }
+  }
+
+  std::string encoded = hex::encode(data);
+  for (usize at : {usize{0}, usize{1}, usize{33}, usize{64}, usize{500},
+                   encoded.size() - 1}) {
+    std::string bad = encoded;
+    bad[at] = 'g';
+    auto result = hex::decode(bad);
+    ASSERT_TRUE(result.has_error());
+    EXPECT_EQ(result.error().kind, Kind::InvalidChar);
+    EXPECT_EQ(result.error().offset, at);
+  }
+
+  EXPECT_EQ(hex::decode("abc").error().kind, Kind::BadLength);
+  EXPECT_EQ(hex::decode("abc").error().offset, 3);
+  std::array<u8, 1> small;
+  EXPECT_EQ(hex::decode("abcd", small).error().kind, Kind::BufferTooSmall);
+}
+
 TEST(StringTest, TrimString) {
   auto s0 = "   hello";
   auto s1 = "manifold   ";
@@ -55,7 +1307,171 @@ TEST(StringTest, TrimString) {
   EXPECT_EQ(manifold::str::trim(""), "");
 }
 
-TEST(StringTest, AsCString) {
-  auto cstr = manifold::str::as_cstr("manifold");
+TEST(StringTest, StringViewOverloads) {
+  std::string_view line =
+      "GET /index.html HTTP/1.1 with enough text to defeat SSO  ";
+
+  EXPECT_TRUE(manifold::str::starts_with(line, "GET "));
+  EXPECT_TRUE(manifold::str::ends_with(line, "SSO  "));
+  EXPECT_FALSE(manifold::str::starts_with("GET", "GET /"));
+  EXPECT_EQ(manifold::str::trim_view(line).data(), line.data());
+  EXPECT_EQ(manifold::str::trim_view(line).size(), line.size() - 2);
+  EXPECT_EQ(manifold::str::trim_view(" \t\n"), "");
+
+  size_t pieces = 0;
+  for (auto piece : manifold::str::split_view(line, " "))
+    pieces += piece.empty() ? 0 : 1;
+
+  EXPECT_EQ(pieces, 9);
+  EXPECT_EQ(manifold::str::split(line.substr(0, 15), " "),
+            (std::vector<std::string>{"GET", "/index.html"}));
+
+  // owned strings are transformed in place
+  std::string owned(line);
+  auto *buffer = owned.data();
+  auto upper = manifold::str::to_upper(std::move(owned));
+  EXPECT_EQ(upper.data(), buffer);
+  auto trimmed = manifold::str::trim(std::move(upper));
+  EXPECT_EQ(trimmed.data(), buffer);
+  EXPECT_EQ(trimmed, "GET /INDEX.HTML HTTP/1.1 WITH ENOUGH TEXT TO DEFEAT SSO");
+}
+
+TEST(StringTest, CStringArena) {
+  manifold::str::CStringArena arena;
+  auto cstr = arena.add("manifold");
   EXPECT_EQ(strcmp(cstr, "manifold"), 0);
+  EXPECT_EQ(strcmp(arena.add(std::string_view("manifold").substr(0, 4)),
+                   "mani"),
+            0);
+
+  std::vector<std::string> args = {"/bin/echo", "-n", "", "hello world"};
+  auto argv = arena.argv(args);
+  for (size_t i = 0; i < args.size(); i++)
+    EXPECT_EQ(argv[i], args[i]);
+
+  EXPECT_EQ(argv[args.size()], nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(argv) % alignof(char *), 0);
+
+  // the pointer array and its strings share one allocation
+  EXPECT_EQ(argv[0], reinterpret_cast<const char *>(argv + args.size() + 1));
+
+  std::unordered_map<std::string, std::string> vars = {{"PATH", "/usr/bin"},
+                                                       {"EMPTY", ""}};
+  auto envp = arena.envp(vars);
+  std::vector<std::string> entries(envp, envp + vars.size());
+  std::sort(entries.begin(), entries.end());
+  EXPECT_EQ(entries, (std::vector<std::string>{"EMPTY=", "PATH=/usr/bin"}));
+  EXPECT_EQ(envp[vars.size()], nullptr);
+  EXPECT_EQ(arena.argv(std::vector<std::string_view>{})[0], nullptr);
+
+  // batches larger than a block get one of their own, and clearing keeps the
+  // largest block so the next round of the same size does not allocate
+  std::vector<std::string> many(2000, "--some-long-flag=value");
+  arena.argv(many);
+  arena.clear();
+  auto capacity = arena.capacity();
+  for (int round = 0; round < 3; round++) {
+    arena.argv(many);
+    arena.clear();
+  }
+
+  EXPECT_EQ(arena.capacity(), capacity);
+
+  // a moved-from arena starts over in blocks of its own, so it cannot
+  // overwrite strings the arena it moved into has handed out
+  manifold::str::CStringArena source;
+  const char *kept = source.add("x");
+  manifold::str::CStringArena target = std::move(source);
+  EXPECT_EQ(source.capacity(), 0);
+  EXPECT_STREQ(source.add("y"), "y");
+  EXPECT_STREQ(kept, "x");
+  EXPECT_STREQ(target.add("z"), "z");
+
+  source = std::move(target);
+  EXPECT_STREQ(kept, "x");
+  EXPECT_EQ(target.capacity(), 0);
+  EXPECT_STREQ(target.add("w"), "w");
+  EXPECT_STREQ(kept, "x");
+}
+
+TEST(StringTest, ParallelLines) {
+  EXPECT_TRUE(manifold::str::line_chunks("").empty());
+  EXPECT_EQ(manifold::str::line_chunks("ab\ncd\nef", 4),
+            (std::vector<std::string_view>{"ab\ncd\n", "ef"}));
+  EXPECT_EQ(manifold::str::line_chunks("ab\ncd\n", 3),
+            (std::vector<std::string_view>{"ab\n", "cd\n"}));
+  EXPECT_EQ(manifold::str::line_chunks("abcdef\ng", 2),
+            (std::vector<std::string_view>{"abcdef\n", "g"}));
+
+  std::vector<std::string_view> lines;
+  manifold::str::for_each_line("a\n\nb\n",
+                               [&](std::string_view line) {
+                                 lines.push_back(line);
+                               });
+  EXPECT_EQ(lines, (std::vector<std::string_view>{"a", "", "b"}));
+
+  // a few chunks' worth of numbered lines, the last without a newline
+  std::string text;
+  usize expected_sum = 0;
+  usize errors = 0;
+  for (usize i = 0; i < 300000; i++) {
+    bool error = i % 7 == 3;
+    text += error ? "ERROR " : "info ";
+    text += std::to_string(i);
+    if (i + 1 < 300000)
+      text += '\n';
+
+    expected_sum += i;
+    errors += error;
+  }
+
+  ASSERT_GT(manifold::str::line_chunks(text).size(), 2);
+  for (usize threads : {usize{1}, usize{4}, usize{0}}) {
+    std::atomic<usize> count = 0;
+    manifold::str::parallel_lines(
+        text, [&](std::string_view) { count++; }, threads);
+    EXPECT_EQ(count, 300000);
+
+    EXPECT_EQ(manifold::str::parallel_count(text, "ERROR", threads), errors);
+    EXPECT_EQ(manifold::str::parallel_count(text, "\nERROR", threads),
+              errors);
+
+    // the numbers come back in text order whatever the thread count
+    auto numbers = manifold::str::parallel_reduce_lines(
+        text, std::vector<usize>{},
+        [](std::vector<usize> &out, std::string_view line) {
+          out.push_back(*manifold::str::parse<usize>(
+              line.substr(line.find(' ') + 1)));
+        },
+        [](std::vector<usize> &total, std::vector<usize> &&part) {
+          total.insert(total.end(), part.begin(), part.end());
+        },
+        threads);
+    ASSERT_EQ(numbers.size(), 300000);
+    EXPECT_TRUE(std::is_sorted(numbers.begin(), numbers.end()));
+
+    auto sum = manifold::str::parallel_reduce_lines(
+        text, usize{0},
+        [](usize &acc, std::string_view line) {
+          acc += *manifold::str::parse<usize>(line.substr(line.find(' ') + 1));
+        },
+        [](usize &total, usize part) { total += part; }, threads);
+    EXPECT_EQ(sum, expected_sum);
+
+    // `init` is folded in once, not once per chunk
+    auto offset = manifold::str::parallel_reduce_lines(
+        text, usize{1000},
+        [](usize &acc, std::string_view) { acc++; },
+        [](usize &total, usize part) { total += part; }, threads);
+    EXPECT_EQ(offset, 1000 + 300000);
+
+    // results of type bool are not packed into a `std::vector<bool>`
+    auto found = manifold::str::parallel_reduce_lines(
+        text, false,
+        [](bool &any, std::string_view line) {
+          any = any || line.ends_with(" 299999");
+        },
+        [](bool &total, bool part) { total = total || part; }, threads);
+    EXPECT_TRUE(found);
+  }
 }